@@ -26,6 +26,8 @@
 
 // external libs includes
 #include <boost/smart_ptr/shared_ptr.hpp>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
 
 // project includes
 #include <dynamic_robot_localization/cloud_analyzers/cloud_analyzer.h>
@@ -61,9 +63,44 @@ class AngularDistributionAnalyzer : public CloudAnalyzer<PointT> {
 		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace);
 		virtual bool computeAnalysisHistogram(const tf2::Transform& estimated_pose, const pcl::PointCloud<PointT>& pointcloud, std::vector<size_t>& analysis_histogram_out);
 		virtual double computeAnalysis(std::vector<size_t>& analysis_histogram);
+
+		/** \brief Sets the pose used by computeAngularBin and computeReferenceRotationAxis. */
+		void setupAngularBinning(const tf2::Transform& estimated_pose);
+
+		/**
+		 * \brief Computes the bin of a point assuming that it is on the same side of the reference rotation axis (which is given by the first point of the cloud).
+		 * Returns false if the point is at the estimated pose position (it does not have a direction).
+		 * The final bin is given by applyReferenceRotationAxis, which allows to compute the histogram in parallel before knowing the first point.
+		 */
+		inline bool computeAngularBin(const PointT& point, size_t number_of_bins, size_t& bin_out, Eigen::Vector3f& rotation_axis_out) const {
+			Eigen::Vector3f point_centered_on_estimated_pose(point.x - estimated_pose_position_.x(), point.y - estimated_pose_position_.y(), point.z - estimated_pose_position_.z());
+			float point_norm = point_centered_on_estimated_pose.norm();
+			if (point_norm == 0.0f) { return false; }
+			point_centered_on_estimated_pose /= point_norm;
+			double dot_product = estimated_pose_orientation_.dot(point_centered_on_estimated_pose); // cos(angle) = (a.b) / (|a|*|b|)
+			rotation_axis_out = estimated_pose_orientation_.cross(point_centered_on_estimated_pose);
+
+			// cos range -> [-1..1]
+			// change range of cos to [-2..0] and then remap values to have range [0..1] (even though they can only have values in [0..0.5], the remaining [0.5..1] are given when the normal vector is in the opposite side of the reference normal vector
+			bin_out = (size_t)(((dot_product - 1.0) * (double)number_of_bins) / -4.0); // size_t conversion truncates value (same as std::trunc)
+			return true;
+		}
+
+		inline Eigen::Vector3f computeReferenceRotationAxis(const PointT& first_point) const {
+			return estimated_pose_orientation_.cross(Eigen::Vector3f(first_point.x - estimated_pose_position_.x(), first_point.y - estimated_pose_position_.y(), first_point.z - estimated_pose_position_.z())).normalized();
+		}
+
+		/** \brief The first and last bin have the points directly in front of the robot and the reference rotation axis gives the direction of the bins (right hand coordinate system). */
+		static inline size_t applyReferenceRotationAxis(size_t bin, const Eigen::Vector3f& rotation_axis, const Eigen::Vector3f& reference_rotation_axis, size_t number_of_bins) {
+			if (reference_rotation_axis.dot(rotation_axis) < 0.0f) {
+				return number_of_bins - bin - 1;
+			}
+			return bin;
+		}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </AngularDistributionAnalyzer-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline int getNumberOfAngularBins() const { return number_of_angular_bins_; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -73,6 +110,8 @@ class AngularDistributionAnalyzer : public CloudAnalyzer<PointT> {
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
 		int number_of_angular_bins_;
+		Eigen::Vector3f estimated_pose_position_;
+		Eigen::Vector3f estimated_pose_orientation_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
@@ -12,7 +12,9 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <algorithm>
 #include <string>
+#include <vector>
 
 // ROS includes
 #include <ros/ros.h>
@@ -22,6 +24,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 #include <pcl/filters/filter.h>
+#include <pcl/filters/filter_indices.h>
 #include <pcl_conversions/pcl_conversions.h>
 
 // external libs includes
@@ -30,6 +33,7 @@
 // project includes
 #include <dynamic_robot_localization/common/configurable_object.h>
 #include <dynamic_robot_localization/common/cloud_publisher.h>
+#include <dynamic_robot_localization/common/tracer.h>
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 namespace dynamic_robot_localization {
@@ -53,17 +57,32 @@ class CloudFilter : public ConfigurableObject {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constants>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		CloudFilter(std::string filter_name = "Filter") : filter_name_(filter_name) {}
+		CloudFilter(std::string filter_name = "Filter") : filter_name_(filter_name), trace_span_id_(Tracer::getInstance().getSpanId(filter_name)) {}
 		virtual ~CloudFilter() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <CloudFilter-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace = "");
 		virtual void filter(const typename pcl::PointCloud<PointT>::Ptr& input_cloud, typename pcl::PointCloud<PointT>::Ptr& output_cloud);
+
+		/**
+		 * \brief Filters the cloud by compacting its points (only possible for filters that compute the indices of the inliers without keeping the cloud organized).
+		 * Must only be called when the cloud is not shared with other objects.
+		 * \return False if the filter cannot be applied in place (the cloud is not changed).
+		 */
+		virtual bool filterInPlace(typename pcl::PointCloud<PointT>::Ptr& cloud);
+
+		/**
+		 * \brief Returns the output cloud of this filter stage, which is kept across calls (its capacity grows to the largest filtered cloud, avoiding a new allocation for each cloud).
+		 * The buffer must not be given to code outside the filter chain (a copy of its points must be used instead).
+		 */
+		typename pcl::PointCloud<PointT>::Ptr getOutputCloudBuffer();
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </CloudFilter-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		typename pcl::Filter<PointT>::Ptr getFilter() { return filter_; }
+		const std::string& getFilterName() const { return filter_name_; }
+		boost::uint32_t getTraceSpanId() const { return trace_span_id_; }
 		typename CloudPublisher<PointT>::Ptr getCloudPublisher() { return cloud_publisher_; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -76,8 +95,11 @@ class CloudFilter : public ConfigurableObject {
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
 		std::string filter_name_;
+		boost::uint32_t trace_span_id_; // interned when the filter is created, to avoid the span name lookup while filtering
 		typename pcl::Filter<PointT>::Ptr filter_;
 		typename CloudPublisher<PointT>::Ptr cloud_publisher_;
+		typename pcl::PointCloud<PointT>::Ptr output_cloud_buffer_;
+		std::vector<int> inliers_indices_buffer_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
@@ -0,0 +1,194 @@
+#pragma once
+
+/**\file fused_crop_voxel_grid.h
+ * \brief Pass through, crop box and voxel grid filters applied in a single pass over the cloud.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ROS includes
+#include <ros/ros.h>
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/common/centroid.h>
+#include <pcl/common/eigen.h>
+#include <pcl/common/io.h>
+
+// external libs includes
+#include <boost/cstdint.hpp>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <Eigen/Core>
+#include <omp.h>
+
+// project includes
+#include <dynamic_robot_localization/cloud_filters/cloud_filter.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+namespace dynamic_robot_localization {
+// ########################################################################   fused_crop_voxel_grid   ##########################################################################
+/**
+ * \brief Applies several pass through and crop box predicates and an optional voxel grid with a single read of each point.
+ * The selected points are grouped by voxel in parallel (each thread reduces the voxels of one hash partition),
+ * which avoids the intermediate clouds and repeated memory traversals of a chain of PassThrough, CropBox and VoxelGrid filters.
+ */
+template <typename PointT>
+class FusedCropVoxelGrid : public CloudFilter<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <typedefs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		typedef boost::shared_ptr< FusedCropVoxelGrid<PointT> > Ptr;
+		typedef boost::shared_ptr< const FusedCropVoxelGrid<PointT> > ConstPtr;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </typedefs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <enums>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </enums>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constants>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		static const int VOXEL_INDEX_NUMBER_OF_BITS = 21;
+		static const size_t MINIMUM_NUMBER_OF_POINTS_PER_THREAD = 10000;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constants>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		FusedCropVoxelGrid() : CloudFilter<PointT>("FusedCropVoxelGrid"),
+			voxel_grid_enabled_(false),
+			leaf_size_inverse_(Eigen::Vector3f::Zero()),
+			downsample_all_data_(false),
+			minimum_number_of_points_per_voxel_(1),
+			number_of_threads_(0) {}
+		virtual ~FusedCropVoxelGrid() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <FusedCropVoxelGrid-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace = "");
+		virtual void filter(const typename pcl::PointCloud<PointT>::Ptr& input_cloud, typename pcl::PointCloud<PointT>::Ptr& output_cloud);
+
+		bool addPassThroughPredicate(const std::string& field_name, float min_value, float max_value);
+		void addCropBoxPredicate(const Eigen::Vector3f& box_min, const Eigen::Vector3f& box_max, const Eigen::Vector3f& box_translation, const Eigen::Vector3f& box_rotation, bool invert_selection);
+		void setVoxelGrid(const Eigen::Vector3f& leaf_size, bool downsample_all_data, size_t minimum_number_of_points_per_voxel);
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </FusedCropVoxelGrid-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline size_t getNumberOfPassThroughPredicates() const { return pass_through_predicates_.size(); }
+		inline size_t getNumberOfCropBoxPredicates() const { return crop_box_predicates_.size(); }
+		inline bool isVoxelGridEnabled() const { return voxel_grid_enabled_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		struct PassThroughPredicate {
+			size_t field_offset;
+			float min_value;
+			float max_value;
+		};
+
+		struct CropBoxPredicate {
+			Eigen::Vector3f box_min;
+			Eigen::Vector3f box_max;
+			Eigen::Matrix3f box_rotation_transposed;
+			Eigen::Vector3f box_translation;
+			bool box_transform_is_identity;
+			bool invert_selection;
+		};
+
+		struct SelectedPoint {
+			boost::uint64_t voxel_key;
+			int point_index;
+		};
+
+		struct VoxelAccumulator {
+			double x, y, z;
+			size_t number_of_points;
+			int first_point_index;
+		};
+
+		/** \brief Buffers used to reduce the voxels of one partition (each partition is reduced by one thread). */
+		struct VoxelPartitionBuffers {
+			boost::unordered_map<boost::uint64_t, size_t> voxels_indices;
+			std::vector<VoxelAccumulator> voxels_accumulators;
+			std::vector<size_t> points_voxels_indices;
+			std::vector<size_t> voxels_offsets;
+			std::vector<size_t> voxels_insertion_offsets;
+			std::vector<int> voxels_points_indices;
+		};
+
+		inline bool isPointSelected(const PointT& point) const {
+			if (!pcl_isfinite(point.x) || !pcl_isfinite(point.y) || !pcl_isfinite(point.z)) { return false; }
+
+			for (size_t i = 0; i < pass_through_predicates_.size(); ++i) {
+				const PassThroughPredicate& predicate = pass_through_predicates_[i];
+				float field_value;
+				std::memcpy(&field_value, reinterpret_cast<const char*>(&point) + predicate.field_offset, sizeof(float));
+				if (!pcl_isfinite(field_value) || field_value < predicate.min_value || field_value > predicate.max_value) { return false; }
+			}
+
+			for (size_t i = 0; i < crop_box_predicates_.size(); ++i) {
+				const CropBoxPredicate& predicate = crop_box_predicates_[i];
+				Eigen::Vector3f point_in_box(point.x, point.y, point.z);
+				if (!predicate.box_transform_is_identity) { point_in_box = predicate.box_rotation_transposed * (point_in_box - predicate.box_translation); }
+				bool inside_box = (point_in_box.array() >= predicate.box_min.array()).all() && (point_in_box.array() <= predicate.box_max.array()).all();
+				if (inside_box == predicate.invert_selection) { return false; }
+			}
+
+			return true;
+		}
+
+		inline bool computeVoxelKey(const PointT& point, boost::uint64_t& voxel_key) const {
+			const long long voxel_index_offset = 1LL << (VOXEL_INDEX_NUMBER_OF_BITS - 1);
+			const long long voxel_index_maximum = (1LL << VOXEL_INDEX_NUMBER_OF_BITS) - 1;
+			long long voxel_x = (long long)std::floor(point.x * leaf_size_inverse_(0)) + voxel_index_offset;
+			long long voxel_y = (long long)std::floor(point.y * leaf_size_inverse_(1)) + voxel_index_offset;
+			long long voxel_z = (long long)std::floor(point.z * leaf_size_inverse_(2)) + voxel_index_offset;
+			if (voxel_x < 0 || voxel_y < 0 || voxel_z < 0 || voxel_x > voxel_index_maximum || voxel_y > voxel_index_maximum || voxel_z > voxel_index_maximum) { return false; }
+			voxel_key = ((boost::uint64_t)voxel_x << (2 * VOXEL_INDEX_NUMBER_OF_BITS)) | ((boost::uint64_t)voxel_y << VOXEL_INDEX_NUMBER_OF_BITS) | (boost::uint64_t)voxel_z;
+			return true;
+		}
+
+		static inline size_t computeVoxelPartition(boost::uint64_t voxel_key, size_t number_of_partitions) {
+			return (size_t)(((voxel_key * 0x9E3779B97F4A7C15ULL) >> 32) % number_of_partitions);
+		}
+
+		void selectPoints(const pcl::PointCloud<PointT>& input_cloud, int number_of_threads);
+		void reduceVoxelPartition(const pcl::PointCloud<PointT>& input_cloud, size_t partition_begin, size_t partition_end, VoxelPartitionBuffers& partition_buffers, pcl::PointCloud<PointT>& voxels_out);
+
+		std::vector<PassThroughPredicate> pass_through_predicates_;
+		std::vector<CropBoxPredicate> crop_box_predicates_;
+		bool voxel_grid_enabled_;
+		Eigen::Vector3f leaf_size_inverse_;
+		bool downsample_all_data_;
+		size_t minimum_number_of_points_per_voxel_;
+		int number_of_threads_;
+
+		// buffers reused between clouds
+		std::vector< std::vector<SelectedPoint> > selected_points_per_thread_;
+		std::vector<SelectedPoint> partitioned_selected_points_;
+		std::vector<size_t> threads_partitions_offsets_;
+		std::vector<size_t> partitions_offsets_;
+		std::vector<VoxelPartitionBuffers> partitions_buffers_;
+		std::vector< typename pcl::PointCloud<PointT>::Ptr > partitions_voxels_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_filters/impl/fused_crop_voxel_grid.hpp>
+#endif
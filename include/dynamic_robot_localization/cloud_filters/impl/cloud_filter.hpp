@@ -36,7 +36,48 @@ void CloudFilter<PointT>::filter(const typename pcl::PointCloud<PointT>::Ptr& in
 	if (cloud_publisher_ && output_cloud) { cloud_publisher_->publishPointCloud(*output_cloud); }
 	ROS_DEBUG_STREAM(filter_name_ << " filter reduced point cloud from " << number_of_points_in_input_cloud << " points to " << output_cloud->size() << " points");
 }
-// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </CloudFilter-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+template<typename PointT>
+bool CloudFilter<PointT>::filterInPlace(typename pcl::PointCloud<PointT>::Ptr& cloud) {
+	typename pcl::FilterIndices<PointT>::Ptr filter_indices = boost::dynamic_pointer_cast< pcl::FilterIndices<PointT> >(filter_);
+	if (!filter_indices || filter_indices->getKeepOrganized() || !cloud) { return false; }
+
+	size_t number_of_points_in_input_cloud = cloud->size();
+	filter_indices->setInputCloud(cloud);
+	filter_indices->filter(inliers_indices_buffer_);
+
+	// compaction from the front is only safe with increasing indices (the point order of unorganized clouds is not relevant)
+	for (size_t i = 1; i < inliers_indices_buffer_.size(); ++i) {
+		if (inliers_indices_buffer_[i] <= inliers_indices_buffer_[i - 1]) {
+			std::sort(inliers_indices_buffer_.begin(), inliers_indices_buffer_.end());
+			inliers_indices_buffer_.erase(std::unique(inliers_indices_buffer_.begin(), inliers_indices_buffer_.end()), inliers_indices_buffer_.end());
+			break;
+		}
+	}
+
+	for (size_t i = 0; i < inliers_indices_buffer_.size(); ++i) {
+		if ((size_t)inliers_indices_buffer_[i] != i) {
+			cloud->points[i] = cloud->points[inliers_indices_buffer_[i]];
+		}
+	}
+	cloud->points.resize(inliers_indices_buffer_.size());
+	cloud->width = (uint32_t)inliers_indices_buffer_.size();
+	cloud->height = 1;
+
+	if (cloud_publisher_) { cloud_publisher_->publishPointCloud(*cloud); }
+	ROS_DEBUG_STREAM(filter_name_ << " filter reduced point cloud (in place) from " << number_of_points_in_input_cloud << " points to " << cloud->size() << " points");
+	return true;
+}
+
+
+template<typename PointT>
+typename pcl::PointCloud<PointT>::Ptr CloudFilter<PointT>::getOutputCloudBuffer() {
+	if (!output_cloud_buffer_) {
+		output_cloud_buffer_ = typename pcl::PointCloud<PointT>::Ptr(new pcl::PointCloud<PointT>());
+	}
+	return output_cloud_buffer_;
+}
 // =============================================================================  </public-section>  ===========================================================================
 
 // =============================================================================   <protected-section>   =======================================================================
@@ -38,6 +38,12 @@ void CovarianceSampling<PointT>::filter(const typename pcl::PointCloud<PointT>::
 	boost::static_pointer_cast< typename pcl::CovarianceSampling<PointT, PointT> >(CloudFilter<PointT>::getFilter())->setNormals(input_cloud);
 	CloudFilter<PointT>::filter(input_cloud, output_cloud);
 }
+
+template<typename PointT>
+bool CovarianceSampling<PointT>::filterInPlace(typename pcl::PointCloud<PointT>::Ptr& cloud) {
+	boost::static_pointer_cast< typename pcl::CovarianceSampling<PointT, PointT> >(CloudFilter<PointT>::getFilter())->setNormals(cloud);
+	return CloudFilter<PointT>::filterInPlace(cloud);
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </CovarianceSampling-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
@@ -0,0 +1,337 @@
+/**\file fused_crop_voxel_grid.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_filters/fused_crop_voxel_grid.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <FusedCropVoxelGrid-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void FusedCropVoxelGrid<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace) {
+	pass_through_predicates_.clear();
+	crop_box_predicates_.clear();
+	voxel_grid_enabled_ = false;
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads_, 0);
+
+	XmlRpc::XmlRpcValue stages;
+	if (private_node_handle->getParam(configuration_namespace, stages) && stages.getType() == XmlRpc::XmlRpcValue::TypeStruct) {
+		for (XmlRpc::XmlRpcValue::iterator it = stages.begin(); it != stages.end(); ++it) {
+			if (it->second.getType() != XmlRpc::XmlRpcValue::TypeStruct) { continue; }
+			std::string stage_name = it->first;
+			std::string stage_namespace = configuration_namespace + stage_name + "/";
+
+			if (stage_name.find("pass_through") != std::string::npos) {
+				std::string field_name;
+				double min_value, max_value;
+				private_node_handle->param(stage_namespace + "field_name", field_name, std::string("z"));
+				private_node_handle->param(stage_namespace + "min_value", min_value, -5.0);
+				private_node_handle->param(stage_namespace + "max_value", max_value, 5.0);
+				if (!addPassThroughPredicate(field_name, (float)min_value, (float)max_value)) {
+					ROS_WARN_STREAM("Ignoring " << stage_name << " in " << CloudFilter<PointT>::filter_name_ << " because the field " << field_name << " is not a float field of the point type");
+				}
+			} else if (stage_name.find("crop_box") != std::string::npos) {
+				double box_min_x, box_min_y, box_min_z, box_max_x, box_max_y, box_max_z;
+				double box_translation_x, box_translation_y, box_translation_z, box_rotation_roll, box_rotation_pitch, box_rotation_yaw;
+				bool invert_selection;
+				private_node_handle->param(stage_namespace + "box_min_x", box_min_x, -10.0);
+				private_node_handle->param(stage_namespace + "box_min_y", box_min_y, -10.0);
+				private_node_handle->param(stage_namespace + "box_min_z", box_min_z, -10.0);
+				private_node_handle->param(stage_namespace + "box_max_x", box_max_x, 10.0);
+				private_node_handle->param(stage_namespace + "box_max_y", box_max_y, 10.0);
+				private_node_handle->param(stage_namespace + "box_max_z", box_max_z, 10.0);
+				private_node_handle->param(stage_namespace + "box_translation_x", box_translation_x, 0.0);
+				private_node_handle->param(stage_namespace + "box_translation_y", box_translation_y, 0.0);
+				private_node_handle->param(stage_namespace + "box_translation_z", box_translation_z, 0.0);
+				private_node_handle->param(stage_namespace + "box_rotation_roll", box_rotation_roll, 0.0);
+				private_node_handle->param(stage_namespace + "box_rotation_pitch", box_rotation_pitch, 0.0);
+				private_node_handle->param(stage_namespace + "box_rotation_yaw", box_rotation_yaw, 0.0);
+				private_node_handle->param(stage_namespace + "invert_selection", invert_selection, false);
+				addCropBoxPredicate(Eigen::Vector3f(box_min_x, box_min_y, box_min_z), Eigen::Vector3f(box_max_x, box_max_y, box_max_z),
+						Eigen::Vector3f(box_translation_x, box_translation_y, box_translation_z), Eigen::Vector3f(box_rotation_roll, box_rotation_pitch, box_rotation_yaw), invert_selection);
+			} else if (stage_name.find("voxel_grid") != std::string::npos) {
+				double leaf_size_x, leaf_size_y, leaf_size_z;
+				bool downsample_all_data;
+				int minimum_number_of_points_per_voxel;
+				private_node_handle->param(stage_namespace + "leaf_size_x", leaf_size_x, 0.01);
+				private_node_handle->param(stage_namespace + "leaf_size_y", leaf_size_y, 0.01);
+				private_node_handle->param(stage_namespace + "leaf_size_z", leaf_size_z, 0.01);
+				private_node_handle->param(stage_namespace + "downsample_all_data", downsample_all_data, false);
+				private_node_handle->param(stage_namespace + "minimum_number_of_points_per_voxel", minimum_number_of_points_per_voxel, 1);
+				setVoxelGrid(Eigen::Vector3f(leaf_size_x, leaf_size_y, leaf_size_z), downsample_all_data, (size_t)std::max(1, minimum_number_of_points_per_voxel));
+			}
+		}
+	}
+
+	ROS_DEBUG_STREAM(CloudFilter<PointT>::filter_name_ << " configured with " << pass_through_predicates_.size() << " pass through predicates, "
+			<< crop_box_predicates_.size() << " crop box predicates and " << (voxel_grid_enabled_ ? "a" : "no") << " voxel grid");
+	CloudFilter<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+}
+
+
+template<typename PointT>
+void FusedCropVoxelGrid<PointT>::filter(const typename pcl::PointCloud<PointT>::Ptr& input_cloud, typename pcl::PointCloud<PointT>::Ptr& output_cloud) {
+	size_t number_of_points_in_input_cloud = input_cloud->size();
+	int number_of_threads = (number_of_threads_ > 0) ? number_of_threads_ : omp_get_max_threads();
+	number_of_threads = std::max(1, std::min(number_of_threads, (int)(number_of_points_in_input_cloud / MINIMUM_NUMBER_OF_POINTS_PER_THREAD)));
+
+	selectPoints(*input_cloud, number_of_threads);
+
+	output_cloud->header = input_cloud->header;
+	output_cloud->sensor_origin_ = input_cloud->sensor_origin_;
+	output_cloud->sensor_orientation_ = input_cloud->sensor_orientation_;
+
+	if (!voxel_grid_enabled_) {
+		std::vector<size_t> threads_offsets(number_of_threads + 1, 0);
+		for (int t = 0; t < number_of_threads; ++t) {
+			threads_offsets[t + 1] = threads_offsets[t] + selected_points_per_thread_[t].size();
+		}
+
+		output_cloud->points.resize(threads_offsets[number_of_threads]);
+		#pragma omp parallel for num_threads(number_of_threads) schedule(static, 1)
+		for (int t = 0; t < number_of_threads; ++t) {
+			const std::vector<SelectedPoint>& selected_points = selected_points_per_thread_[t];
+			for (size_t i = 0; i < selected_points.size(); ++i) {
+				output_cloud->points[threads_offsets[t] + i] = input_cloud->points[selected_points[i].point_index];
+			}
+		}
+	} else {
+		// counting sort of the selected points by voxel partition (keeping the order of the points inside each partition)
+		size_t number_of_partitions = (size_t)number_of_threads;
+		threads_partitions_offsets_.assign(number_of_threads * number_of_partitions, 0);
+		#pragma omp parallel for num_threads(number_of_threads) schedule(static, 1)
+		for (int t = 0; t < number_of_threads; ++t) {
+			const std::vector<SelectedPoint>& selected_points = selected_points_per_thread_[t];
+			for (size_t i = 0; i < selected_points.size(); ++i) {
+				++threads_partitions_offsets_[t * number_of_partitions + computeVoxelPartition(selected_points[i].voxel_key, number_of_partitions)];
+			}
+		}
+
+		partitions_offsets_.resize(number_of_partitions + 1);
+		size_t offset = 0;
+		for (size_t p = 0; p < number_of_partitions; ++p) {
+			partitions_offsets_[p] = offset;
+			for (int t = 0; t < number_of_threads; ++t) {
+				size_t number_of_points_in_thread_partition = threads_partitions_offsets_[t * number_of_partitions + p];
+				threads_partitions_offsets_[t * number_of_partitions + p] = offset;
+				offset += number_of_points_in_thread_partition;
+			}
+		}
+		partitions_offsets_[number_of_partitions] = offset;
+
+		partitioned_selected_points_.resize(offset);
+		#pragma omp parallel for num_threads(number_of_threads) schedule(static, 1)
+		for (int t = 0; t < number_of_threads; ++t) {
+			const std::vector<SelectedPoint>& selected_points = selected_points_per_thread_[t];
+			for (size_t i = 0; i < selected_points.size(); ++i) {
+				size_t& partition_offset = threads_partitions_offsets_[t * number_of_partitions + computeVoxelPartition(selected_points[i].voxel_key, number_of_partitions)];
+				partitioned_selected_points_[partition_offset++] = selected_points[i];
+			}
+		}
+
+		// each partition has its own voxels, so they can be reduced without synchronization
+		partitions_buffers_.resize(number_of_partitions);
+		partitions_voxels_.resize(number_of_partitions);
+		for (size_t p = 0; p < number_of_partitions; ++p) {
+			if (!partitions_voxels_[p]) { partitions_voxels_[p] = typename pcl::PointCloud<PointT>::Ptr(new pcl::PointCloud<PointT>()); }
+		}
+
+		#pragma omp parallel for num_threads(number_of_threads) schedule(dynamic, 1)
+		for (int p = 0; p < (int)number_of_partitions; ++p) {
+			reduceVoxelPartition(*input_cloud, partitions_offsets_[p], partitions_offsets_[p + 1], partitions_buffers_[p], *partitions_voxels_[p]);
+		}
+
+		size_t number_of_voxels = 0;
+		for (size_t p = 0; p < number_of_partitions; ++p) {
+			number_of_voxels += partitions_voxels_[p]->size();
+		}
+
+		output_cloud->points.resize(number_of_voxels);
+		size_t output_index = 0;
+		for (size_t p = 0; p < number_of_partitions; ++p) {
+			std::copy(partitions_voxels_[p]->points.begin(), partitions_voxels_[p]->points.end(), output_cloud->points.begin() + output_index);
+			output_index += partitions_voxels_[p]->size();
+		}
+	}
+
+	output_cloud->width = (uint32_t)output_cloud->points.size();
+	output_cloud->height = 1;
+	output_cloud->is_dense = true;
+
+	if (CloudFilter<PointT>::getCloudPublisher() && output_cloud) { CloudFilter<PointT>::getCloudPublisher()->publishPointCloud(*output_cloud); }
+	ROS_DEBUG_STREAM(CloudFilter<PointT>::filter_name_ << " filter reduced point cloud from " << number_of_points_in_input_cloud << " points to " << output_cloud->size() << " points using " << number_of_threads << " threads");
+}
+
+
+template<typename PointT>
+bool FusedCropVoxelGrid<PointT>::addPassThroughPredicate(const std::string& field_name, float min_value, float max_value) {
+	std::vector<pcl::PCLPointField> fields;
+	pcl::getFields<PointT>(fields);
+	for (size_t i = 0; i < fields.size(); ++i) {
+		if (fields[i].name == field_name && fields[i].datatype == pcl::PCLPointField::FLOAT32) {
+			PassThroughPredicate predicate;
+			predicate.field_offset = fields[i].offset;
+			predicate.min_value = min_value;
+			predicate.max_value = max_value;
+			pass_through_predicates_.push_back(predicate);
+			return true;
+		}
+	}
+	return false;
+}
+
+
+template<typename PointT>
+void FusedCropVoxelGrid<PointT>::addCropBoxPredicate(const Eigen::Vector3f& box_min, const Eigen::Vector3f& box_max, const Eigen::Vector3f& box_translation, const Eigen::Vector3f& box_rotation, bool invert_selection) {
+	// same box transform as pcl::CropBox (the points are transformed into the box frame)
+	Eigen::Affine3f box_transform;
+	pcl::getTransformation(box_translation(0), box_translation(1), box_translation(2), box_rotation(0), box_rotation(1), box_rotation(2), box_transform);
+
+	CropBoxPredicate predicate;
+	predicate.box_min = box_min;
+	predicate.box_max = box_max;
+	predicate.box_rotation_transposed = box_transform.rotation().transpose();
+	predicate.box_translation = box_translation;
+	predicate.box_transform_is_identity = box_translation.isZero() && box_rotation.isZero();
+	predicate.invert_selection = invert_selection;
+	crop_box_predicates_.push_back(predicate);
+}
+
+
+template<typename PointT>
+void FusedCropVoxelGrid<PointT>::setVoxelGrid(const Eigen::Vector3f& leaf_size, bool downsample_all_data, size_t minimum_number_of_points_per_voxel) {
+	voxel_grid_enabled_ = (leaf_size.array() > 0.0f).all();
+	leaf_size_inverse_ = voxel_grid_enabled_ ? Eigen::Vector3f(leaf_size.cwiseInverse()) : Eigen::Vector3f::Zero();
+	downsample_all_data_ = downsample_all_data;
+	minimum_number_of_points_per_voxel_ = minimum_number_of_points_per_voxel;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </FusedCropVoxelGrid-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+void FusedCropVoxelGrid<PointT>::selectPoints(const pcl::PointCloud<PointT>& input_cloud, int number_of_threads) {
+	// static schedule -> each thread selects a contiguous block of points (concatenating the threads selections keeps the original order)
+	selected_points_per_thread_.resize(number_of_threads);
+	for (int t = 0; t < number_of_threads; ++t) {
+		selected_points_per_thread_[t].clear();
+	}
+
+	long number_of_points = (long)input_cloud.size();
+	#pragma omp parallel num_threads(number_of_threads)
+	{
+		std::vector<SelectedPoint>& selected_points = selected_points_per_thread_[omp_get_thread_num()];
+
+		#pragma omp for schedule(static)
+		for (long i = 0; i < number_of_points; ++i) {
+			const PointT& point = input_cloud.points[i];
+			if (!isPointSelected(point)) { continue; }
+
+			SelectedPoint selected_point;
+			selected_point.point_index = (int)i;
+			selected_point.voxel_key = 0;
+			if (voxel_grid_enabled_ && !computeVoxelKey(point, selected_point.voxel_key)) { continue; }
+			selected_points.push_back(selected_point);
+		}
+	}
+}
+
+
+template<typename PointT>
+void FusedCropVoxelGrid<PointT>::reduceVoxelPartition(const pcl::PointCloud<PointT>& input_cloud, size_t partition_begin, size_t partition_end, VoxelPartitionBuffers& partition_buffers, pcl::PointCloud<PointT>& voxels_out) {
+	voxels_out.points.clear();
+	if (partition_end <= partition_begin) { return; }
+
+	// the buffers keep their capacity between clouds
+	size_t number_of_points_in_partition = partition_end - partition_begin;
+	boost::unordered_map<boost::uint64_t, size_t>& voxels_indices = partition_buffers.voxels_indices;
+	std::vector<VoxelAccumulator>& voxels_accumulators = partition_buffers.voxels_accumulators;
+	std::vector<size_t>& points_voxels_indices = partition_buffers.points_voxels_indices;
+	voxels_indices.clear();
+	voxels_indices.reserve(number_of_points_in_partition);
+	voxels_accumulators.clear();
+	voxels_accumulators.reserve(number_of_points_in_partition);
+	points_voxels_indices.resize(number_of_points_in_partition);
+
+	for (size_t i = partition_begin; i < partition_end; ++i) {
+		const SelectedPoint& selected_point = partitioned_selected_points_[i];
+		std::pair<boost::unordered_map<boost::uint64_t, size_t>::iterator, bool> voxel_insertion = voxels_indices.insert(std::make_pair(selected_point.voxel_key, voxels_accumulators.size()));
+		if (voxel_insertion.second) {
+			VoxelAccumulator voxel_accumulator;
+			voxel_accumulator.x = 0.0;
+			voxel_accumulator.y = 0.0;
+			voxel_accumulator.z = 0.0;
+			voxel_accumulator.number_of_points = 0;
+			voxel_accumulator.first_point_index = selected_point.point_index;
+			voxels_accumulators.push_back(voxel_accumulator);
+		}
+
+		size_t voxel_index = voxel_insertion.first->second;
+		const PointT& point = input_cloud.points[selected_point.point_index];
+		VoxelAccumulator& voxel_accumulator = voxels_accumulators[voxel_index];
+		voxel_accumulator.x += point.x;
+		voxel_accumulator.y += point.y;
+		voxel_accumulator.z += point.z;
+		++voxel_accumulator.number_of_points;
+		points_voxels_indices[i - partition_begin] = voxel_index;
+	}
+
+	voxels_out.points.reserve(voxels_accumulators.size());
+
+	if (!downsample_all_data_) {
+		// only the coordinates are averaged (the other fields are copied from the first point of the voxel)
+		for (size_t v = 0; v < voxels_accumulators.size(); ++v) {
+			const VoxelAccumulator& voxel_accumulator = voxels_accumulators[v];
+			if (voxel_accumulator.number_of_points < minimum_number_of_points_per_voxel_) { continue; }
+			PointT voxel_point = input_cloud.points[voxel_accumulator.first_point_index];
+			double number_of_points = (double)voxel_accumulator.number_of_points;
+			voxel_point.x = (float)(voxel_accumulator.x / number_of_points);
+			voxel_point.y = (float)(voxel_accumulator.y / number_of_points);
+			voxel_point.z = (float)(voxel_accumulator.z / number_of_points);
+			voxels_out.points.push_back(voxel_point);
+		}
+	} else {
+		// group the points of each voxel to average all fields
+		std::vector<size_t>& voxels_offsets = partition_buffers.voxels_offsets;
+		voxels_offsets.assign(voxels_accumulators.size() + 1, 0);
+		for (size_t v = 0; v < voxels_accumulators.size(); ++v) {
+			voxels_offsets[v + 1] = voxels_offsets[v] + voxels_accumulators[v].number_of_points;
+		}
+
+		std::vector<int>& voxels_points_indices = partition_buffers.voxels_points_indices;
+		std::vector<size_t>& voxels_insertion_offsets = partition_buffers.voxels_insertion_offsets;
+		voxels_points_indices.resize(number_of_points_in_partition);
+		voxels_insertion_offsets.assign(voxels_offsets.begin(), voxels_offsets.end() - 1);
+		for (size_t i = partition_begin; i < partition_end; ++i) {
+			voxels_points_indices[voxels_insertion_offsets[points_voxels_indices[i - partition_begin]]++] = partitioned_selected_points_[i].point_index;
+		}
+
+		for (size_t v = 0; v < voxels_accumulators.size(); ++v) {
+			if (voxels_accumulators[v].number_of_points < minimum_number_of_points_per_voxel_) { continue; }
+			pcl::CentroidPoint<PointT> voxel_centroid;
+			for (size_t i = voxels_offsets[v]; i < voxels_offsets[v + 1]; ++i) {
+				voxel_centroid.add(input_cloud.points[voxels_points_indices[i]]);
+			}
+
+			PointT voxel_point;
+			voxel_centroid.get(voxel_point);
+
+			// the averaged normals must be normalized again
+			float normal_norm = voxel_point.getNormalVector3fMap().norm();
+			if (normal_norm > 1e-6f) { voxel_point.getNormalVector3fMap() /= normal_norm; }
+			voxels_out.points.push_back(voxel_point);
+		}
+	}
+
+	voxels_out.width = (uint32_t)voxels_out.points.size();
+	voxels_out.height = 1;
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+} /* namespace dynamic_robot_localization */
@@ -57,6 +57,29 @@ void RandomSample<PointT>::filter(const typename pcl::PointCloud<PointT>::Ptr& i
 	if (CloudFilter<PointT>::getCloudPublisher() && output_cloud) { CloudFilter<PointT>::getCloudPublisher()->publishPointCloud(*output_cloud); }
 	ROS_DEBUG_STREAM(CloudFilter<PointT>::filter_name_ << " filter reduced point cloud from " << number_of_points_in_input_cloud << " points to " << output_cloud->size() << " points");
 }
+
+
+template<typename PointT>
+bool RandomSample<PointT>::filterInPlace(typename pcl::PointCloud<PointT>::Ptr& cloud) {
+	if (!cloud) { return false; }
+
+	// same behavior as filter when the cloud does not have more points than the sample size
+	typename pcl::RandomSample<PointT>::Ptr filter = boost::static_pointer_cast< typename pcl::RandomSample<PointT> >(CloudFilter<PointT>::filter_);
+	if (filter->getSample() >= cloud->size()) {
+		size_t number_of_points_in_input_cloud = cloud->size();
+		if (filter->getNegative()) {
+			cloud->points.clear();
+			cloud->width = 0;
+			cloud->height = 1;
+		}
+
+		if (CloudFilter<PointT>::getCloudPublisher()) { CloudFilter<PointT>::getCloudPublisher()->publishPointCloud(*cloud); }
+		ROS_DEBUG_STREAM(CloudFilter<PointT>::filter_name_ << " filter reduced point cloud (in place) from " << number_of_points_in_input_cloud << " points to " << cloud->size() << " points");
+		return true;
+	}
+
+	return CloudFilter<PointT>::filterInPlace(cloud);
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </RandomSample-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
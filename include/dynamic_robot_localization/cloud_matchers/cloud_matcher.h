@@ -35,8 +35,10 @@
 // project includes
 #include <dynamic_robot_localization/common/configurable_object.h>
 #include <dynamic_robot_localization/common/cloud_publisher.h>
+#include <dynamic_robot_localization/common/keypoint_descriptors_cache.h>
 #include <dynamic_robot_localization/common/performance_timer.h>
 #include <dynamic_robot_localization/common/registration_visualizer.h>
+#include <dynamic_robot_localization/common/tracer.h>
 #include <dynamic_robot_localization/cloud_matchers/correspondence_estimation.h>
 #include <dynamic_robot_localization/cloud_matchers/transformation_estimation.h>
 #include <laserscan_to_pointcloud/tf_rosmsg_eigen_conversions.h>
@@ -81,6 +83,7 @@ class CloudMatcher : public ConfigurableObject {
 		virtual void processKeypoints(typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
 				typename pcl::PointCloud<PointT>::Ptr& surface,
 				typename pcl::search::KdTree<PointT>::Ptr& surface_search_method) {}
+		virtual void setKeypointDescriptorsCache(const typename KeypointDescriptorsCache<PointT>::Ptr& keypoint_descriptors_cache) {}
 
 		virtual boost::shared_ptr< std::vector< typename pcl::Registration<PointT, PointT>::Matrix4> > getAcceptedTransformations() { return boost::shared_ptr< std::vector< typename pcl::Registration<PointT, PointT>::Matrix4> >(new std::vector< typename pcl::Registration<PointT, PointT>::Matrix4>()); }
 
@@ -101,6 +104,7 @@ class CloudMatcher : public ConfigurableObject {
 		inline bool getDisplayCloudAligment() const { return display_cloud_aligment_; }
 		inline const boost::shared_ptr<RegistrationVisualizer<PointT, PointT> >& getRegistrationVisualizer() const { return registration_visualizer_; }
 		inline double getCloudAlignTimeMS() { return cloud_align_time_ms_; }
+		inline const Eigen::Matrix4f& getRegistrationInitialGuess() const { return registration_initial_guess_; }
 		virtual int getNumberOfRegistrationIterations() { return -1; }
 		virtual std::string getMatcherConvergenceState() { return ""; }
 		virtual double getRootMeanSquareErrorOfRegistrationCorrespondences() { return -1.0; }
@@ -108,17 +112,22 @@ class CloudMatcher : public ConfigurableObject {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		inline void setCloudMatcher(const typename pcl::Registration<PointT, PointT>::Ptr& cloud_matcher) { cloud_matcher_ = cloud_matcher; }
+		inline void setCloudMatcher(const typename pcl::Registration<PointT, PointT>::Ptr& cloud_matcher) {
+			cloud_matcher_ = cloud_matcher;
+			trace_span_id_ = cloud_matcher ? Tracer::getInstance().getSpanId(cloud_matcher->getClassName()) : 0; // interned at configuration time, to avoid the span name lookup in each registration
+		}
 		inline void setMatchOnlyKeypoints(bool match_only_keypoints) { match_only_keypoints_ = match_only_keypoints; }
 		inline void setCloudPublisher(typename CloudPublisher<PointT>::Ptr& cloud_publisher) { cloud_publisher_ = cloud_publisher; }
 		inline void setDisplayCloudAligment(bool display_cloud_aligment) { display_cloud_aligment_ = display_cloud_aligment; }
 		inline void setRegistrationVisualizer(const boost::shared_ptr<RegistrationVisualizer<PointT, PointT> >& registration_visualizer) { registration_visualizer_ = registration_visualizer; }
+		inline void setRegistrationInitialGuess(const Eigen::Matrix4f& registration_initial_guess) { registration_initial_guess_ = registration_initial_guess; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 	// ========================================================================   </public-section>  ===========================================================================
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
 		typename pcl::Registration<PointT, PointT>::Ptr cloud_matcher_;
+		boost::uint32_t trace_span_id_;
 		CorrepondenceEstimationApproach correpondence_estimation_approach_;
 		typename pcl::registration::CorrespondenceEstimationBase<PointT, PointT, float>::Ptr correspondence_estimation_ptr_;
 		TransformationEstimationApproach transformation_estimation_approach_;
@@ -130,6 +139,10 @@ class CloudMatcher : public ConfigurableObject {
 		boost::shared_ptr< RegistrationVisualizer<PointT, PointT> > registration_visualizer_;
 		bool display_cloud_aligment_;
 		int maximum_number_of_displayed_correspondences_;
+		Eigen::Matrix4f registration_initial_guess_; // pose correction applied to the ambient cloud before the first registration iteration (included in the final transformation)
+
+	public:
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 	// ========================================================================   </private-section>  ==========================================================================
 };
 
@@ -27,6 +27,7 @@
 // project includes
 #include <dynamic_robot_localization/common/common.h>
 #include <dynamic_robot_localization/common/performance_timer.h>
+#include <dynamic_robot_localization/cloud_matchers/correspondence_estimation_persistent_lookup_table.h>
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 namespace dynamic_robot_localization {
@@ -34,6 +35,7 @@ namespace dynamic_robot_localization {
 enum CorrepondenceEstimationApproach {
 	CorrespondenceEstimation,
 	CorrespondenceEstimationLookupTable,
+	CorrespondenceEstimationPersistentLookupTable,
 	CorrespondenceEstimationBackProjection,
 	CorrespondenceEstimationNormalShooting,
 	CorrespondenceEstimationOrganizedProjection
@@ -0,0 +1,146 @@
+#pragma once
+
+/**\file correspondence_estimation_persistent_lookup_table.h
+ * \brief Correspondence estimation using a Euclidean distance transform lookup table that is persisted next to the map.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// ROS includes
+
+// PCL includes
+#include <pcl/correspondence.h>
+#include <pcl/registration/correspondence_estimation.h>
+
+// external libs includes
+#include <boost/smart_ptr/shared_ptr.hpp>
+
+// project includes
+#include <dynamic_robot_localization/common/euclidean_distance_transform_lookup_table.h>
+#include <dynamic_robot_localization/common/performance_timer.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// ###########################################################   CorrespondenceEstimationPersistentLookupTableTimed   ############################################################
+/**
+ * \brief Finds the closest target point of each source point with a single lookup in a EuclideanDistanceTransformLookupTable.
+ * The lookup table must be setup with the same cloud given in setInputTarget (otherwise the search tree of the base class is used).
+ * Source points outside the lookup table are matched with the search tree if use_search_tree_when_query_point_is_outside_lookup_table is true.
+ */
+template <typename PointSource, typename PointTarget, typename Scalar = float>
+class CorrespondenceEstimationPersistentLookupTableTimed : public pcl::registration::CorrespondenceEstimation<PointSource, PointTarget, Scalar> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <typedefs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		typedef boost::shared_ptr< CorrespondenceEstimationPersistentLookupTableTimed<PointSource, PointTarget, Scalar> > Ptr;
+		typedef boost::shared_ptr< const CorrespondenceEstimationPersistentLookupTableTimed<PointSource, PointTarget, Scalar> > ConstPtr;
+		typedef pcl::registration::CorrespondenceEstimation<PointSource, PointTarget, Scalar> BaseClass;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </typedefs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		CorrespondenceEstimationPersistentLookupTableTimed() :
+			lookup_table_(new EuclideanDistanceTransformLookupTable<PointTarget>()),
+			use_search_tree_when_query_point_is_outside_lookup_table_(true),
+			correspondence_estimation_elapsed_time_(0) {
+			BaseClass::corr_name_ = "CorrespondenceEstimationPersistentLookupTable";
+		}
+		virtual ~CorrespondenceEstimationPersistentLookupTableTimed() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <CorrespondenceEstimationPersistentLookupTableTimed-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual void determineCorrespondences(pcl::Correspondences &correspondences, double max_distance = std::numeric_limits<double>::max()) {
+			PerformanceTimer timer_;
+			timer_.start();
+
+			if (!lookup_table_ || lookup_table_->getReferenceCloud() != BaseClass::target_) {
+				BaseClass::determineCorrespondences(correspondences, max_distance);
+				correspondence_estimation_elapsed_time_ += timer_.getElapsedTimeInMilliSec();
+				return;
+			}
+
+			if (!BaseClass::initCompute()) { return; }
+
+			double max_distance_squared = (max_distance < std::sqrt(std::numeric_limits<double>::max())) ? max_distance * max_distance : std::numeric_limits<double>::max();
+			correspondences.resize(BaseClass::indices_->size());
+			std::vector<int> nearest_index(1);
+			std::vector<float> nearest_squared_distance(1);
+			size_t number_of_valid_correspondences = 0;
+
+			for (std::vector<int>::const_iterator idx = BaseClass::indices_->begin(); idx != BaseClass::indices_->end(); ++idx) {
+				const PointSource& source_point = BaseClass::input_->points[*idx];
+				int target_index = lookup_table_->getClosestPointIndex(source_point.x, source_point.y, source_point.z);
+
+				if (target_index < 0) {
+					if (!use_search_tree_when_query_point_is_outside_lookup_table_) { continue; }
+					PointTarget query_point;
+					query_point.x = source_point.x;
+					query_point.y = source_point.y;
+					query_point.z = source_point.z;
+					if (BaseClass::tree_->nearestKSearch(query_point, 1, nearest_index, nearest_squared_distance) < 1) { continue; }
+					target_index = nearest_index[0];
+				}
+
+				if ((size_t)target_index >= BaseClass::target_->size()) { continue; }
+
+				const PointTarget& target_point = BaseClass::target_->points[target_index];
+				float dx = source_point.x - target_point.x;
+				float dy = source_point.y - target_point.y;
+				float dz = source_point.z - target_point.z;
+				float distance_squared = dx * dx + dy * dy + dz * dz;
+				if ((double)distance_squared > max_distance_squared) { continue; }
+
+				pcl::Correspondence& correspondence = correspondences[number_of_valid_correspondences++];
+				correspondence.index_query = *idx;
+				correspondence.index_match = target_index;
+				correspondence.distance = distance_squared;
+			}
+
+			correspondences.resize(number_of_valid_correspondences);
+			BaseClass::deinitCompute();
+			correspondence_estimation_elapsed_time_ += timer_.getElapsedTimeInMilliSec();
+		}
+
+		virtual void determineReciprocalCorrespondences(pcl::Correspondences &correspondences, double max_distance = std::numeric_limits<double>::max()) {
+			PerformanceTimer timer_;
+			timer_.start();
+			BaseClass::determineReciprocalCorrespondences(correspondences, max_distance);
+			correspondence_estimation_elapsed_time_ += timer_.getElapsedTimeInMilliSec();
+		}
+
+		virtual boost::shared_ptr< pcl::registration::CorrespondenceEstimationBase<PointSource, PointTarget, Scalar> > clone() const {
+			Ptr copy(new CorrespondenceEstimationPersistentLookupTableTimed<PointSource, PointTarget, Scalar>(*this));
+			return copy;
+		}
+
+		inline double getCorrespondenceEstimationElapsedTime() { return correspondence_estimation_elapsed_time_; }
+		inline void resetCorrespondenceEstimationElapsedTime() { correspondence_estimation_elapsed_time_ = 0; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </CorrespondenceEstimationPersistentLookupTableTimed-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline typename EuclideanDistanceTransformLookupTable<PointTarget>::Ptr getTargetLookupTable() { return lookup_table_; }
+		inline bool getUseSearchTreeWhenQueryPointIsOutsideLookupTable() const { return use_search_tree_when_query_point_is_outside_lookup_table_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline void setTargetLookupTable(const typename EuclideanDistanceTransformLookupTable<PointTarget>::Ptr& lookup_table) { lookup_table_ = lookup_table; }
+		inline void setUseSearchTreeWhenQueryPointIsOutsideLookupTable(bool use_search_tree_when_query_point_is_outside_lookup_table) { use_search_tree_when_query_point_is_outside_lookup_table_ = use_search_tree_when_query_point_is_outside_lookup_table; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		typename EuclideanDistanceTransformLookupTable<PointTarget>::Ptr lookup_table_;
+		bool use_search_tree_when_query_point_is_outside_lookup_table_;
+		double correspondence_estimation_elapsed_time_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
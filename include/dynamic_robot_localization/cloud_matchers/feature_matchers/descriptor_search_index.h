@@ -0,0 +1,177 @@
+#pragma once
+
+/**\file descriptor_search_index.h
+ * \brief Nearest neighbor search in descriptor space (FLANN kd-tree or randomized kd-tree forest) that can be saved to and memory mapped from a binary file.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <exception>
+
+// ROS includes
+#include <ros/ros.h>
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/point_representation.h>
+#include <pcl/common/io.h>
+
+// external libs includes
+#include <boost/cstdint.hpp>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <flann/flann.hpp>
+
+// project includes
+#include <dynamic_robot_localization/common/hash_utils.h>
+#include <dynamic_robot_localization/common/memory_mapped_file.h>
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// #########################################################################   DescriptorSearchIndex   #########################################################################
+/**
+ * \brief Replacement of pcl::KdTreeFLANN for feature clouds that allows approximate searches and persistence of the index.
+ * The index file has a fixed size header, the mapping from the indexed rows to the feature cloud indices, the vectorized descriptors and the serialized FLANN index.
+ * It is only loaded if it was built from descriptors with the same hash and with the same index configuration.
+ * When loading, the file is memory mapped and the FLANN index uses the descriptors matrix stored in the mapped file (only the tree nodes are deserialized).
+ * Setting the same feature cloud again does not rebuild the index (which allows the matchers to share an index that was loaded from a file).
+ */
+template <typename FeatureT>
+class DescriptorSearchIndex {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <typedefs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		typedef boost::shared_ptr< DescriptorSearchIndex<FeatureT> > Ptr;
+		typedef boost::shared_ptr< const DescriptorSearchIndex<FeatureT> > ConstPtr;
+		typedef typename pcl::PointCloud<FeatureT>::ConstPtr FeatureCloudConstPtr;
+		typedef flann::L2_Simple<float> Distance;
+		typedef flann::Index<Distance> FLANNIndex;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </typedefs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <enums>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		enum IndexType {
+			INDEX_TYPE_KDTREE,
+			INDEX_TYPE_RANDOMIZED_KDTREE_FOREST
+		};
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </enums>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constants>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		static const boost::uint32_t INDEX_FORMAT_VERSION = 1;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constants>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		DescriptorSearchIndex() :
+			index_type_(INDEX_TYPE_KDTREE),
+			number_of_trees_(4),
+			search_checks_(flann::FLANN_CHECKS_UNLIMITED),
+			search_eps_(0.0f),
+			indexed_points_data_(NULL),
+			number_of_indexed_features_(0),
+			number_of_dimensions_(point_representation_.getNumberOfDimensions()),
+			dataset_(NULL) {}
+		virtual ~DescriptorSearchIndex() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <DescriptorSearchIndex-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		/** \brief Builds the index (does nothing if the feature cloud is already indexed and was not changed). */
+		void setInputCloud(const FeatureCloudConstPtr& features);
+
+		/** \brief Loads an index built for the given features (returns false if the file is not available or was built from other descriptors / configuration). */
+		bool loadFromFile(const std::string& filename, const FeatureCloudConstPtr& features);
+
+		/** \brief Writes to a temporary file that is renamed at the end (processes loading the index never see a partially written file). */
+		bool saveToFile(const std::string& filename) const;
+
+		int nearestKSearch(const FeatureT& feature, int k, std::vector<int>& indices_out, std::vector<float>& squared_distances_out) const;
+		inline int nearestKSearch(const pcl::PointCloud<FeatureT>& features, int index, int k, std::vector<int>& indices_out, std::vector<float>& squared_distances_out) const {
+			return nearestKSearch(features.points[index], k, indices_out, squared_distances_out);
+		}
+
+		bool isIndexed(const FeatureCloudConstPtr& features) const;
+		void clear();
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </DescriptorSearchIndex-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline IndexType getIndexType() const { return index_type_; }
+		inline int getNumberOfTrees() const { return number_of_trees_; }
+		inline int getSearchChecks() const { return search_checks_; }
+		inline float getSearchEps() const { return search_eps_; }
+		inline FeatureCloudConstPtr getInputCloud() const { return input_features_; }
+		inline size_t getNumberOfIndexedDescriptors() const { return index_mapping_.size(); }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		/** \brief Changing the index type or the number of trees only takes effect in the next build / load. */
+		inline void setIndexType(IndexType index_type) { index_type_ = index_type; }
+		inline void setNumberOfTrees(int number_of_trees) { number_of_trees_ = std::max(1, number_of_trees); }
+		/** \brief Maximum number of leafs checked in each search (-1 -> unlimited, which gives exact results with INDEX_TYPE_KDTREE). */
+		inline void setSearchChecks(int search_checks) { search_checks_ = search_checks; }
+		/** \brief Approximation factor of the search (0 -> exact within the checked leafs). */
+		inline void setSearchEps(float search_eps) { search_eps_ = search_eps; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		struct IndexFileHeader {
+			char magic[8];
+			boost::uint32_t format_version;
+			boost::uint32_t index_type;
+			boost::uint32_t number_of_trees;
+			boost::uint32_t number_of_dimensions;
+			boost::uint32_t feature_size;
+			boost::uint32_t reserved;
+			boost::uint64_t feature_fields_hash;
+			boost::uint64_t descriptors_hash;
+			boost::uint64_t number_of_features;
+			boost::uint64_t number_of_indexed_descriptors;
+			boost::uint64_t index_mapping_offset;
+			boost::uint64_t dataset_offset;
+			boost::uint64_t index_offset;
+		};
+
+		static const size_t INDEX_DATA_ALIGNMENT = 64;
+		static inline boost::uint64_t alignOffset(boost::uint64_t offset) { return ((offset + INDEX_DATA_ALIGNMENT - 1) / INDEX_DATA_ALIGNMENT) * INDEX_DATA_ALIGNMENT; }
+		static inline const FeatureT* getPointsData(const pcl::PointCloud<FeatureT>& features) { return features.points.empty() ? NULL : &features.points[0]; }
+
+		flann::IndexParams getFLANNIndexParameters() const;
+		boost::uint64_t computeDescriptorsHash(const pcl::PointCloud<FeatureT>& features) const;
+		void fillHeader(IndexFileHeader& header, const pcl::PointCloud<FeatureT>& features, size_t number_of_indexed_descriptors) const;
+		void setIndexedFeatures(const FeatureCloudConstPtr& features);
+
+		IndexType index_type_;
+		int number_of_trees_;
+		int search_checks_;
+		float search_eps_;
+		pcl::DefaultPointRepresentation<FeatureT> point_representation_;
+
+		FeatureCloudConstPtr input_features_;
+		const FeatureT* indexed_points_data_;
+		size_t number_of_indexed_features_;
+		int number_of_dimensions_;
+		std::vector<int> index_mapping_;
+		std::vector<float> dataset_buffer_;
+		float* dataset_;
+		boost::shared_ptr<MemoryMappedFile> index_file_;
+		boost::shared_ptr<FLANNIndex> flann_index_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_matchers/feature_matchers/impl/descriptor_search_index.hpp>
+#endif
@@ -27,6 +27,7 @@
 // project includes
 #include <dynamic_robot_localization/common/pointcloud_conversions.h>
 #include <dynamic_robot_localization/cloud_matchers/cloud_matcher.h>
+#include <dynamic_robot_localization/cloud_matchers/feature_matchers/descriptor_search_index.h>
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/keypoint_descriptors/keypoint_descriptor.h>
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/keypoint_descriptors/fpfh.h>
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/keypoint_descriptors/shot.h>
@@ -53,7 +54,7 @@ class FeatureMatcher : public CloudMatcher<PointT> {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constants>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		FeatureMatcher() : save_descriptors_in_binary_format_(true) {}
+		FeatureMatcher() : save_descriptors_in_binary_format_(true), descriptors_search_index_(new DescriptorSearchIndex<FeatureT>()) {}
 		virtual ~FeatureMatcher() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -72,19 +73,29 @@ class FeatureMatcher : public CloudMatcher<PointT> {
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		const typename KeypointDescriptor<PointT, FeatureT>::Ptr getKeypointDescriptor() { return keypoint_descriptor_; }
+		const typename DescriptorSearchIndex<FeatureT>::Ptr getDescriptorsSearchIndex() { return descriptors_search_index_; }
+		const typename KeypointDescriptorsCache<PointT>::Ptr getKeypointDescriptorsCache() { return keypoint_descriptors_cache_; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		void setKeypointDescriptor(const typename KeypointDescriptor<PointT, FeatureT>::Ptr& keypoint_descriptor) { keypoint_descriptor_ = keypoint_descriptor; }
+		virtual void setKeypointDescriptorsCache(const typename KeypointDescriptorsCache<PointT>::Ptr& keypoint_descriptors_cache) { keypoint_descriptors_cache_ = keypoint_descriptors_cache; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 	// ========================================================================   </public-section>  ===========================================================================
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
+		/** \brief Loads the search index of the reference descriptors from file (if it was built from the same descriptors) or builds it (and saves it if requested). */
+		void setupReferenceDescriptorsSearchIndex(typename pcl::PointCloud<FeatureT>::Ptr& reference_descriptors);
+
 		typename KeypointDescriptor<PointT, FeatureT>::Ptr keypoint_descriptor_;
 		std::string reference_pointcloud_descriptors_filename_;
 		std::string reference_pointcloud_descriptors_save_filename_;
 		bool save_descriptors_in_binary_format_;
+		std::string reference_pointcloud_descriptors_search_index_filename_;
+		std::string reference_pointcloud_descriptors_search_index_save_filename_;
+		typename DescriptorSearchIndex<FeatureT>::Ptr descriptors_search_index_; // shared with the registration algorithm
+		typename KeypointDescriptorsCache<PointT>::Ptr keypoint_descriptors_cache_; // ambient descriptors shared with the other feature matchers of the scan cycle
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
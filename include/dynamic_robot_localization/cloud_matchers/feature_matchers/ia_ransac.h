@@ -40,12 +40,17 @@
 #ifndef IA_RANSAC_H_
 #define IA_RANSAC_H_
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <pcl/registration/registration.h>
 #include <pcl/registration/transformation_estimation_svd.h>
 #include <pcl/common/time.h>
 #include <Eigen/Core>
 
+#include <dynamic_robot_localization/common/random_generator.h>
+#include <dynamic_robot_localization/cloud_matchers/feature_matchers/descriptor_search_index.h>
+
 namespace dynamic_robot_localization
 {
   /** \brief @b SampleConsensusInitialAlignmentRegistration is an implementation of the initial alignment algorithm described in
@@ -132,13 +137,14 @@ namespace dynamic_robot_localization
           float threshold_;
       };
 
-      typedef typename pcl::KdTreeFLANN<FeatureT>::Ptr FeatureKdTreePtr;
+      typedef typename DescriptorSearchIndex<FeatureT>::Ptr FeatureSearchIndexPtr;
       /** \brief Constructor. */
       SampleConsensusInitialAlignmentRegistration () :
         input_features_ (), target_features_ (), 
         nr_samples_(3), min_sample_distance_ (0.0f), k_correspondences_ (10), 
-        feature_tree_ (new pcl::KdTreeFLANN<FeatureT>),
-        error_functor_ (), convergence_time_limit_seconds_(std::numeric_limits<double>::max())
+        feature_tree_ (new DescriptorSearchIndex<FeatureT>),
+        error_functor_ (), convergence_time_limit_seconds_(std::numeric_limits<double>::max()),
+        random_seed_ (-1), preverification_number_of_points_ (100), preverification_rejection_z_score_ (3.0)
       {
         reg_name_ = "SampleConsensusInitialAlignmentRegistration";
         max_iterations_ = 1000;
@@ -170,6 +176,17 @@ namespace dynamic_robot_localization
       inline FeatureCloudConstPtr const 
       getTargetFeatures () { return (target_features_); }
 
+      /** \brief Provide the search index used to find the target features similar to the source features
+        * (allows to use an index loaded from a file or shared with other matchers; it is only rebuilt if it does not index the target features)
+        * \param feature_search_index the descriptors search index
+        */
+      inline void
+      setFeatureSearchIndex (const FeatureSearchIndexPtr &feature_search_index) { feature_tree_ = feature_search_index; }
+
+      /** \brief Get the search index of the target features */
+      inline FeatureSearchIndexPtr
+      getFeatureSearchIndex () { return (feature_tree_); }
+
       /** \brief Set the minimum distances between samples
         * \param min_sample_distance the minimum distances between samples
         */
@@ -216,12 +233,23 @@ namespace dynamic_robot_localization
 
       inline void setConvergenceTimeLimitSeconds(double convergence_time_limit_seconds) { convergence_time_limit_seconds_ = convergence_time_limit_seconds; }
 
+      /** \brief Set the seed of the random generator used to select the samples (a negative value uses a different seed in each alignment). */
+      inline void setRandomSeed(int random_seed) { random_seed_ = random_seed; }
+      inline int getRandomSeed() const { return random_seed_; }
+
+      /** \brief Set the number of random points whose error is computed before the rest of the cloud (0 disables the preverification).
+       * A hypothesis is rejected after the preverification if the lower confidence bound (\a rejection_z_score standard errors below the mean)
+       * of its extrapolated error is already higher than the lowest error found so far.
+       */
+      inline void setPreverificationNumberOfPoints(int number_of_points) { preverification_number_of_points_ = number_of_points; }
+      inline void setPreverificationRejectionZScore(double rejection_z_score) { preverification_rejection_z_score_ = rejection_z_score; }
+
     protected:
       /** \brief Choose a random index between 0 and n-1
         * \param n the number of possible indices to choose from
         */
       inline int 
-      getRandomIndex (int n) { return (static_cast<int> (n * (rand () / (RAND_MAX + 1.0)))); };
+      getRandomIndex (int n) { return (random_generator_.getRandomIndex (n)); };
       
       /** \brief Select \a nr_samples sample points from cloud while making sure that their pairwise distances are 
         * greater than a user-defined minimum distance, \a min_sample_distance.
@@ -245,12 +273,18 @@ namespace dynamic_robot_localization
       findSimilarFeatures (const FeatureCloud &input_features, const std::vector<int> &sample_indices, 
                            std::vector<int> &corresponding_indices);
 
-      /** \brief An error metric for that computes the quality of the alignment between the given cloud and the target.
-        * \param cloud the input cloud
-        * \param threshold distances greater than this value are capped
+      /** \brief Compute a random order for evaluating the input points in \ref computeErrorMetric (the first points are used for the preverification). */
+      void
+      computeEvaluationOrder ();
+
+      /** \brief An error metric for that computes the quality of the alignment between the input cloud transformed with the given transformation and the target.
+        * The evaluation stops as soon as the accumulated error exceeds \a max_error (or after the preverification, if the hypothesis is very unlikely to be below it).
+        * \param transformation the pose hypothesis
+        * \param max_error lowest error found so far
+        * \return the alignment error (std::numeric_limits<float>::max () if the hypothesis was rejected before evaluating all points)
         */
       float 
-      computeErrorMetric (const PointCloudSource &cloud, float threshold);
+      computeErrorMetric (const Eigen::Matrix4f &transformation, float max_error);
 
       /** \brief Rigid transformation computation method.
         * \param output the transformed input point cloud dataset using the rigid transformation found
@@ -275,13 +309,22 @@ namespace dynamic_robot_localization
       int k_correspondences_;
      
       /** \brief The KdTree used to compare feature descriptors. */
-      FeatureKdTreePtr feature_tree_;               
+      FeatureSearchIndexPtr feature_tree_;               
 
       /** */
       boost::shared_ptr<ErrorFunctor> error_functor_;
 
       pcl::StopWatch convergence_timer_;
       double convergence_time_limit_seconds_;
+
+      /** \brief Seed of the random generator (negative for a time based seed) */
+      int random_seed_;
+      RandomGenerator random_generator_;
+
+      /** \brief Random permutation of the input indices, used to evaluate the pose hypotheses */
+      std::vector<int> evaluation_order_;
+      int preverification_number_of_points_;
+      double preverification_rejection_z_score_;
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   };
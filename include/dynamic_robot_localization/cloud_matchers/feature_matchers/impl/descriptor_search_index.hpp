@@ -0,0 +1,258 @@
+/**\file descriptor_search_index.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/feature_matchers/descriptor_search_index.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <DescriptorSearchIndex-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename FeatureT>
+void DescriptorSearchIndex<FeatureT>::setInputCloud(const FeatureCloudConstPtr& features) {
+	if (isIndexed(features)) { return; }
+
+	clear();
+	if (!features || features->empty()) { return; }
+
+	index_mapping_.reserve(features->size());
+	dataset_buffer_.resize(features->size() * number_of_dimensions_);
+	float* dataset_row = &dataset_buffer_[0];
+	for (size_t i = 0; i < features->size(); ++i) {
+		if (!point_representation_.isValid(features->points[i])) { continue; }
+		point_representation_.vectorize(features->points[i], dataset_row);
+		dataset_row += number_of_dimensions_;
+		index_mapping_.push_back((int)i);
+	}
+
+	if (index_mapping_.empty()) {
+		clear();
+		return;
+	}
+
+	dataset_buffer_.resize(index_mapping_.size() * number_of_dimensions_);
+	dataset_ = &dataset_buffer_[0];
+	flann_index_.reset(new FLANNIndex(flann::Matrix<float>(dataset_, index_mapping_.size(), number_of_dimensions_), getFLANNIndexParameters()));
+	flann_index_->buildIndex();
+	setIndexedFeatures(features);
+}
+
+
+template<typename FeatureT>
+bool DescriptorSearchIndex<FeatureT>::loadFromFile(const std::string& filename, const FeatureCloudConstPtr& features) {
+	if (!features || features->empty()) { return false; }
+
+	boost::shared_ptr<MemoryMappedFile> index_file(new MemoryMappedFile());
+	if (!index_file->open(filename) || index_file->getSize() < sizeof(IndexFileHeader)) {
+		ROS_DEBUG_STREAM("Descriptors search index " << filename << " is not available");
+		return false;
+	}
+
+	IndexFileHeader header, expected_header;
+	std::memcpy(&header, index_file->getData(), sizeof(IndexFileHeader));
+	fillHeader(expected_header, *features, (size_t)header.number_of_indexed_descriptors);
+
+	if (std::memcmp(header.magic, expected_header.magic, sizeof(header.magic)) != 0 || header.format_version != expected_header.format_version
+			|| header.feature_size != expected_header.feature_size || header.feature_fields_hash != expected_header.feature_fields_hash
+			|| header.number_of_dimensions != expected_header.number_of_dimensions) {
+		ROS_WARN_STREAM("Discarded descriptors search index " << filename << " because it has a different format or descriptor type");
+		return false;
+	}
+
+	if (header.index_type != expected_header.index_type || header.number_of_trees != expected_header.number_of_trees) {
+		ROS_INFO_STREAM("Discarded descriptors search index " << filename << " because it was built with a different index configuration");
+		return false;
+	}
+
+	if (header.number_of_features != expected_header.number_of_features || header.descriptors_hash != expected_header.descriptors_hash) {
+		ROS_INFO_STREAM("Discarded descriptors search index " << filename << " because it was built from other descriptors");
+		return false;
+	}
+
+	if (header.number_of_indexed_descriptors == 0 || header.number_of_indexed_descriptors > header.number_of_features
+			|| header.index_mapping_offset != expected_header.index_mapping_offset || header.dataset_offset != expected_header.dataset_offset
+			|| header.index_offset != expected_header.index_offset || index_file->getSize() <= header.index_offset) {
+		ROS_WARN_STREAM("Discarded descriptors search index " << filename << " because it is truncated");
+		return false;
+	}
+
+	clear();
+	size_t number_of_indexed_descriptors = (size_t)header.number_of_indexed_descriptors;
+	const int* index_mapping = reinterpret_cast<const int*>(index_file->getData() + header.index_mapping_offset);
+	index_mapping_.assign(index_mapping, index_mapping + number_of_indexed_descriptors);
+	dataset_ = reinterpret_cast<float*>(const_cast<char*>(index_file->getData() + header.dataset_offset)); // FLANN only reads the dataset
+
+	std::FILE* index_stream = fmemopen(const_cast<char*>(index_file->getData() + header.index_offset), index_file->getSize() - (size_t)header.index_offset, "rb");
+	if (index_stream == NULL) {
+		clear();
+		return false;
+	}
+
+	try {
+		flann_index_.reset(new FLANNIndex(flann::Matrix<float>(dataset_, number_of_indexed_descriptors, number_of_dimensions_), getFLANNIndexParameters()));
+		flann_index_->loadIndex(index_stream);
+	} catch (std::exception& e) {
+		ROS_WARN_STREAM("Discarded descriptors search index " << filename << " because it could not be deserialized: " << e.what());
+		std::fclose(index_stream);
+		clear();
+		return false;
+	}
+
+	std::fclose(index_stream);
+	index_file_ = index_file;
+	setIndexedFeatures(features);
+	return true;
+}
+
+
+template<typename FeatureT>
+bool DescriptorSearchIndex<FeatureT>::saveToFile(const std::string& filename) const {
+	if (!flann_index_ || !input_features_ || index_mapping_.empty()) { return false; }
+
+	IndexFileHeader header;
+	fillHeader(header, *input_features_, index_mapping_.size());
+
+	std::string temporary_filename = filename + ".tmp";
+	std::FILE* index_file = std::fopen(temporary_filename.c_str(), "wb");
+	if (index_file == NULL) { return false; }
+
+	char padding[INDEX_DATA_ALIGNMENT];
+	std::memset(padding, 0, INDEX_DATA_ALIGNMENT);
+	size_t index_mapping_size = index_mapping_.size() * sizeof(int);
+	size_t dataset_size = index_mapping_.size() * number_of_dimensions_ * sizeof(float);
+	size_t index_mapping_padding = (size_t)(header.dataset_offset - header.index_mapping_offset) - index_mapping_size;
+	size_t dataset_padding = (size_t)(header.index_offset - header.dataset_offset) - dataset_size;
+
+	bool success = std::fwrite(&header, 1, sizeof(IndexFileHeader), index_file) == sizeof(IndexFileHeader)
+			&& std::fwrite(padding, 1, (size_t)header.index_mapping_offset - sizeof(IndexFileHeader), index_file) == (size_t)header.index_mapping_offset - sizeof(IndexFileHeader)
+			&& std::fwrite(&index_mapping_[0], 1, index_mapping_size, index_file) == index_mapping_size
+			&& std::fwrite(padding, 1, index_mapping_padding, index_file) == index_mapping_padding
+			&& std::fwrite(dataset_, 1, dataset_size, index_file) == dataset_size
+			&& std::fwrite(padding, 1, dataset_padding, index_file) == dataset_padding;
+
+	if (success) {
+		try {
+			flann_index_->saveIndex(index_file);
+		} catch (std::exception&) {
+			success = false;
+		}
+	}
+
+	success = (std::fclose(index_file) == 0) && success;
+	if (!success || std::rename(temporary_filename.c_str(), filename.c_str()) != 0) {
+		std::remove(temporary_filename.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+
+template<typename FeatureT>
+int DescriptorSearchIndex<FeatureT>::nearestKSearch(const FeatureT& feature, int k, std::vector<int>& indices_out, std::vector<float>& squared_distances_out) const {
+	if (!flann_index_ || k <= 0 || !point_representation_.isValid(feature)) {
+		indices_out.clear();
+		squared_distances_out.clear();
+		return 0;
+	}
+
+	k = std::min(k, (int)index_mapping_.size());
+	indices_out.resize(k);
+	squared_distances_out.resize(k);
+
+	std::vector<float> query(number_of_dimensions_);
+	point_representation_.vectorize(feature, query);
+
+	flann::Matrix<int> indices_matrix(&indices_out[0], 1, k);
+	flann::Matrix<float> squared_distances_matrix(&squared_distances_out[0], 1, k);
+	flann_index_->knnSearch(flann::Matrix<float>(&query[0], 1, number_of_dimensions_), indices_matrix, squared_distances_matrix, k, flann::SearchParams(search_checks_, search_eps_));
+
+	for (int i = 0; i < k; ++i) {
+		indices_out[i] = index_mapping_[indices_out[i]];
+	}
+
+	return k;
+}
+
+
+template<typename FeatureT>
+bool DescriptorSearchIndex<FeatureT>::isIndexed(const FeatureCloudConstPtr& features) const {
+	return flann_index_ && features && features == input_features_
+			&& getPointsData(*features) == indexed_points_data_ && features->size() == number_of_indexed_features_;
+}
+
+
+template<typename FeatureT>
+void DescriptorSearchIndex<FeatureT>::clear() {
+	flann_index_.reset();
+	index_file_.reset();
+	input_features_.reset();
+	indexed_points_data_ = NULL;
+	number_of_indexed_features_ = 0;
+	index_mapping_.clear();
+	dataset_buffer_.clear();
+	dataset_ = NULL;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </DescriptorSearchIndex-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename FeatureT>
+flann::IndexParams DescriptorSearchIndex<FeatureT>::getFLANNIndexParameters() const {
+	if (index_type_ == INDEX_TYPE_RANDOMIZED_KDTREE_FOREST) {
+		return flann::KDTreeIndexParams(number_of_trees_);
+	}
+
+	return flann::KDTreeSingleIndexParams(15); // same as pcl::KdTreeFLANN
+}
+
+
+template<typename FeatureT>
+boost::uint64_t DescriptorSearchIndex<FeatureT>::computeDescriptorsHash(const pcl::PointCloud<FeatureT>& features) const {
+	if (features.empty()) { return hash_utils::HASH_INITIAL_VALUE; }
+	return hash_utils::computeHash(&features.points[0], features.size() * sizeof(FeatureT));
+}
+
+
+template<typename FeatureT>
+void DescriptorSearchIndex<FeatureT>::fillHeader(IndexFileHeader& header, const pcl::PointCloud<FeatureT>& features, size_t number_of_indexed_descriptors) const {
+	std::memset(&header, 0, sizeof(IndexFileHeader));
+	std::memcpy(header.magic, "DRLDIDX", 8);
+	header.format_version = INDEX_FORMAT_VERSION;
+	header.index_type = (boost::uint32_t)index_type_;
+	header.number_of_trees = (index_type_ == INDEX_TYPE_RANDOMIZED_KDTREE_FOREST) ? (boost::uint32_t)number_of_trees_ : 1;
+	header.number_of_dimensions = (boost::uint32_t)number_of_dimensions_;
+	header.feature_size = sizeof(FeatureT);
+	header.feature_fields_hash = hash_utils::computeHash(pcl::getFieldsList(pcl::PointCloud<FeatureT>()));
+	header.descriptors_hash = computeDescriptorsHash(features);
+	header.number_of_features = features.size();
+	header.number_of_indexed_descriptors = number_of_indexed_descriptors;
+	header.index_mapping_offset = alignOffset(sizeof(IndexFileHeader));
+	header.dataset_offset = alignOffset(header.index_mapping_offset + number_of_indexed_descriptors * sizeof(int));
+	header.index_offset = alignOffset(header.dataset_offset + number_of_indexed_descriptors * number_of_dimensions_ * sizeof(float));
+}
+
+
+template<typename FeatureT>
+void DescriptorSearchIndex<FeatureT>::setIndexedFeatures(const FeatureCloudConstPtr& features) {
+	input_features_ = features;
+	indexed_points_data_ = getPointsData(*features);
+	number_of_indexed_features_ = features->size();
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
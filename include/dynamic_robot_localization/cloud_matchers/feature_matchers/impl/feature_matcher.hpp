@@ -28,6 +28,26 @@ void FeatureMatcher<PointT, FeatureT>::setupConfigurationFromParameterServer(ros
 	if (ros::param::search(search_namespace, "reference_pointcloud_descriptors_filename", final_param_name)) { private_node_handle->param(final_param_name, reference_pointcloud_descriptors_filename_, std::string("")); }
 	if (ros::param::search(search_namespace, "reference_pointcloud_descriptors_save_filename", final_param_name)) { private_node_handle->param(final_param_name, reference_pointcloud_descriptors_save_filename_, std::string("")); }
 	if (ros::param::search(search_namespace, "save_descriptors_in_binary_format", final_param_name)) { private_node_handle->param(final_param_name, save_descriptors_in_binary_format_, true); }
+	if (ros::param::search(search_namespace, "reference_pointcloud_descriptors_search_index_filename", final_param_name)) { private_node_handle->param(final_param_name, reference_pointcloud_descriptors_search_index_filename_, std::string("")); }
+	if (ros::param::search(search_namespace, "reference_pointcloud_descriptors_search_index_save_filename", final_param_name)) { private_node_handle->param(final_param_name, reference_pointcloud_descriptors_search_index_save_filename_, std::string("")); }
+
+	std::string descriptors_search_index_type("kdtree");
+	int descriptors_search_index_number_of_trees = 4;
+	int descriptors_search_checks = -1;
+	double descriptors_search_eps = 0.0;
+	if (ros::param::search(search_namespace, "descriptors_search_index_type", final_param_name)) { private_node_handle->param(final_param_name, descriptors_search_index_type, std::string("kdtree")); }
+	if (ros::param::search(search_namespace, "descriptors_search_index_number_of_trees", final_param_name)) { private_node_handle->param(final_param_name, descriptors_search_index_number_of_trees, 4); }
+	if (ros::param::search(search_namespace, "descriptors_search_checks", final_param_name)) { private_node_handle->param(final_param_name, descriptors_search_checks, -1); }
+	if (ros::param::search(search_namespace, "descriptors_search_eps", final_param_name)) { private_node_handle->param(final_param_name, descriptors_search_eps, 0.0); }
+
+	if (descriptors_search_index_type == "randomized_kdtree_forest") {
+		descriptors_search_index_->setIndexType(DescriptorSearchIndex<FeatureT>::INDEX_TYPE_RANDOMIZED_KDTREE_FOREST);
+	} else {
+		descriptors_search_index_->setIndexType(DescriptorSearchIndex<FeatureT>::INDEX_TYPE_KDTREE);
+	}
+	descriptors_search_index_->setNumberOfTrees(descriptors_search_index_number_of_trees);
+	descriptors_search_index_->setSearchChecks(descriptors_search_checks);
+	descriptors_search_index_->setSearchEps((float)descriptors_search_eps);
 
 	CloudMatcher<PointT>::setDisplayCloudAligment(display_feature_matching);
 
@@ -67,6 +87,7 @@ void FeatureMatcher<PointT, FeatureT>::setupReferenceCloud(typename pcl::PointCl
 		pcl::io::savePCDFile<FeatureT>(reference_pointcloud_descriptors_save_filename_, *reference_descriptors, save_descriptors_in_binary_format_);
 	}
 
+	setupReferenceDescriptorsSearchIndex(reference_descriptors);
 	setMatcherReferenceDescriptors(reference_descriptors);
 }
 
@@ -82,7 +103,21 @@ void FeatureMatcher<PointT, FeatureT>::processKeypoints(typename pcl::PointCloud
 		typename pcl::PointCloud<PointT>::Ptr& surface,
 		typename pcl::search::KdTree<PointT>::Ptr& surface_search_method) {
 
-	typename pcl::PointCloud<FeatureT>::Ptr ambient_descriptors = keypoint_descriptor_->computeKeypointsDescriptors(pointcloud_keypoints, surface, surface_search_method);
+	typename pcl::PointCloud<FeatureT>::Ptr ambient_descriptors;
+	if (keypoint_descriptors_cache_) {
+		ambient_descriptors = keypoint_descriptors_cache_->template getDescriptors<FeatureT>(pointcloud_keypoints, surface, keypoint_descriptor_->getConfigurationHash());
+		if (ambient_descriptors) {
+			ROS_DEBUG_STREAM("Reusing " << ambient_descriptors->size() << " ambient descriptors computed by a previous feature matcher");
+		}
+	}
+
+	if (!ambient_descriptors) {
+		ambient_descriptors = keypoint_descriptor_->computeKeypointsDescriptors(pointcloud_keypoints, surface, surface_search_method);
+		if (keypoint_descriptors_cache_) {
+			keypoint_descriptors_cache_->template addDescriptors<FeatureT>(pointcloud_keypoints, surface, keypoint_descriptor_->getConfigurationHash(), ambient_descriptors);
+		}
+	}
+
 	setMatcherAmbientDescriptors(ambient_descriptors);
 	CloudMatcher<PointT>::setMatchOnlyKeypoints(true);
 }
@@ -90,6 +125,24 @@ void FeatureMatcher<PointT, FeatureT>::processKeypoints(typename pcl::PointCloud
 // =============================================================================  </public-section>  ===========================================================================
 
 // =============================================================================   <protected-section>   =======================================================================
+template<typename PointT, typename FeatureT>
+void FeatureMatcher<PointT, FeatureT>::setupReferenceDescriptorsSearchIndex(typename pcl::PointCloud<FeatureT>::Ptr& reference_descriptors) {
+	if (reference_descriptors->empty()) { return; }
+
+	if (!reference_pointcloud_descriptors_search_index_filename_.empty() && descriptors_search_index_->loadFromFile(reference_pointcloud_descriptors_search_index_filename_, reference_descriptors)) {
+		ROS_INFO_STREAM("Loaded search index of " << descriptors_search_index_->getNumberOfIndexedDescriptors() << " keypoint descriptors from file " << reference_pointcloud_descriptors_search_index_filename_);
+		return;
+	}
+
+	descriptors_search_index_->setInputCloud(reference_descriptors);
+
+	if (!reference_pointcloud_descriptors_search_index_save_filename_.empty()) {
+		ROS_INFO_STREAM("Saving search index of " << descriptors_search_index_->getNumberOfIndexedDescriptors() << " reference pointcloud keypoint descriptors to file " << reference_pointcloud_descriptors_search_index_save_filename_);
+		if (!descriptors_search_index_->saveToFile(reference_pointcloud_descriptors_search_index_save_filename_)) {
+			ROS_WARN_STREAM("Failed to save the reference pointcloud keypoint descriptors search index to file " << reference_pointcloud_descriptors_search_index_save_filename_);
+		}
+	}
+}
 // =============================================================================   </protected-section>  =======================================================================
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -149,24 +149,67 @@ dynamic_robot_localization::SampleConsensusInitialAlignmentRegistration<PointT,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename FeatureT> void
+dynamic_robot_localization::SampleConsensusInitialAlignmentRegistration<PointT, FeatureT>::computeEvaluationOrder ()
+{
+  evaluation_order_.resize (input_->size ());
+  for (size_t i = 0; i < evaluation_order_.size (); ++i)
+    evaluation_order_[i] = static_cast<int> (i);
+
+  // Partial Fisher-Yates shuffle (only the preverification points need to be random)
+  const size_t number_of_shuffled_points = std::min (evaluation_order_.size (), static_cast<size_t> (std::max (preverification_number_of_points_, 0)));
+  for (size_t i = 0; i < number_of_shuffled_points; ++i)
+    std::swap (evaluation_order_[i], evaluation_order_[i + getRandomIndex (static_cast<int> (evaluation_order_.size () - i))]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename FeatureT> float
 dynamic_robot_localization::SampleConsensusInitialAlignmentRegistration<PointT, FeatureT>::computeErrorMetric (
-    const PointCloudSource &cloud, float)
+    const Eigen::Matrix4f &transformation, float max_error)
 {
   std::vector<int> nn_index (1);
   std::vector<float> nn_distance (1);
 
   const ErrorFunctor & compute_error = *error_functor_;
+  const Eigen::Matrix3f rotation = transformation.block<3, 3> (0, 0);
+  const Eigen::Vector3f translation = transformation.block<3, 1> (0, 3);
+  const size_t number_of_points = evaluation_order_.size ();
+  const size_t number_of_preverification_points = std::min (number_of_points, static_cast<size_t> (std::max (preverification_number_of_points_, 0)));
+
+  PointT point_transformed;
   float error = 0;
+  double sum_of_squared_errors = 0;
 
-  for (int i = 0; i < static_cast<int> (cloud.size ()); ++i)
+  for (size_t i = 0; i < number_of_points; ++i)
   {
-    // Find the distance between cloud.points[i] and its nearest neighbor in the target point cloud
-    tree_->nearestKSearch (cloud, i, 1, nn_index, nn_distance);
+    // Find the distance between the transformed point and its nearest neighbor in the target point cloud
+    const PointT &point = input_->points[evaluation_order_[i]];
+    point_transformed = point;
+    point_transformed.getVector3fMap () = rotation * point.getVector3fMap () + translation;
+    tree_->nearestKSearch (point_transformed, 1, nn_index, nn_distance);
 
     // Compute the error
-    error += compute_error (nn_distance[0]);
+    float point_error = compute_error (nn_distance[0]);
+    error += point_error;
+
+    // The error functors are non negative, so the hypothesis can no longer be better than the current best
+    if (error > max_error)
+      return (std::numeric_limits<float>::max ());
+
+    // Preverification: reject if even the lower confidence bound of the extrapolated error is worse than the current best
+    if (number_of_preverification_points < number_of_points)
+    {
+      sum_of_squared_errors += point_error * point_error;
+      if (i + 1 == number_of_preverification_points)
+      {
+        double mean_error = error / static_cast<double> (number_of_preverification_points);
+        double error_variance = std::max (0.0, sum_of_squared_errors / static_cast<double> (number_of_preverification_points) - mean_error * mean_error);
+        double mean_error_lower_bound = mean_error - preverification_rejection_z_score_ * std::sqrt (error_variance / static_cast<double> (number_of_preverification_points));
+        if (mean_error_lower_bound * static_cast<double> (number_of_points) > max_error)
+          return (std::numeric_limits<float>::max ());
+      }
+    }
   }
   return (error);
 }
@@ -209,11 +252,12 @@ dynamic_robot_localization::SampleConsensusInitialAlignmentRegistration<PointT,
     error_functor_.reset (new TruncatedError (static_cast<float> (corr_dist_threshold_)));
 
   convergence_timer_.reset();
+  random_generator_.setSeed ((random_seed_ < 0) ? RandomGenerator::generateSeed () : static_cast<boost::uint64_t> (random_seed_));
+  computeEvaluationOrder ();
 
   std::vector<int> sample_indices (nr_samples_);
   std::vector<int> corresponding_indices (nr_samples_);
-  PointCloudSource input_transformed;
-  float error, lowest_error (0);
+  float error, lowest_error (std::numeric_limits<float>::max ());
 
   final_transformation_ = guess;
   int i_iter = 0;
@@ -221,8 +265,7 @@ dynamic_robot_localization::SampleConsensusInitialAlignmentRegistration<PointT,
   if (!guess.isApprox (Eigen::Matrix4f::Identity (), 0.01f)) 
   {
     // If guess is not the Identity matrix we check it.
-	pcl::transformPointCloud (*input_, input_transformed, final_transformation_);
-    lowest_error = computeErrorMetric (input_transformed, static_cast<float> (corr_dist_threshold_));
+    lowest_error = computeErrorMetric (final_transformation_, std::numeric_limits<float>::max ());
     i_iter = 1;
   }
 
@@ -237,9 +280,8 @@ dynamic_robot_localization::SampleConsensusInitialAlignmentRegistration<PointT,
     // Estimate the transform from the samples to their corresponding points
     transformation_estimation_->estimateRigidTransformation (*input_, sample_indices, *target_, corresponding_indices, transformation_);
 
-    // Tranform the data and compute the error
-    pcl::transformPointCloud (*input_, input_transformed, transformation_);
-    error = computeErrorMetric (input_transformed, static_cast<float> (corr_dist_threshold_));
+    // Tranform the data and compute the error (stopping early if it can not be lower than the current best)
+    error = computeErrorMetric (transformation_, lowest_error);
 
     // If the new error is lower, update the final transformation
     if (i_iter == 0 || error < lowest_error)
@@ -21,6 +21,7 @@ template<typename PointT, typename FeatureT>
 SampleConsensusInitialAlignmentPrerejective<PointT, FeatureT>::SampleConsensusInitialAlignmentPrerejective() :
 	matcher_scia_(new SampleConsensusPrerejective<PointT, PointT, FeatureT>()),
 	number_of_samples_(3) {
+	matcher_scia_->setFeatureSearchIndex(FeatureMatcher<PointT, FeatureT>::descriptors_search_index_);
 	CloudMatcher<PointT>::setCloudMatcher(matcher_scia_);
 }
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -58,6 +59,18 @@ void SampleConsensusInitialAlignmentPrerejective<PointT, FeatureT>::setupConfigu
 	private_node_handle->param(configuration_namespace + "correspondence_randomness", correspondence_randomness, 10);
 	matcher_scia_->setCorrespondenceRandomness(correspondence_randomness);
 
+	int random_seed;
+	private_node_handle->param(configuration_namespace + "random_seed", random_seed, -1);
+	matcher_scia_->setRandomSeed(random_seed);
+
+	int preverification_number_of_points;
+	private_node_handle->param(configuration_namespace + "preverification_number_of_points", preverification_number_of_points, 100);
+	matcher_scia_->setPreverificationNumberOfPoints(preverification_number_of_points);
+
+	double preverification_rejection_z_score;
+	private_node_handle->param(configuration_namespace + "preverification_rejection_z_score", preverification_rejection_z_score, 3.0);
+	matcher_scia_->setPreverificationRejectionZScore(preverification_rejection_z_score);
+
 	FeatureMatcher<PointT, FeatureT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
 }
 
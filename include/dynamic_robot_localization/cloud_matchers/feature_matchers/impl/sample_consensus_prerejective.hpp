@@ -68,7 +68,7 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointSource, typename PointTarget, typename FeatureT> void SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::selectSamples(
-        const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices) {
+        const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices, RandomGenerator& random_generator) {
 	if (nr_samples > static_cast<int>(cloud.size())) {
 		PCL_ERROR("[pcl::%s::selectSamples] ", getClassName().c_str());
 		PCL_ERROR("The number of samples (%d) must not be greater than the number of points (%lu)!\n", nr_samples, cloud.size());
@@ -81,7 +81,7 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 	// Draw random samples until n samples is reached
 	for (int i = 0; i < nr_samples; i++) {
 		// Select a random number
-		sample_indices[i] = getRandomIndex(static_cast<int>(cloud.size()) - i);
+		sample_indices[i] = getRandomIndex(static_cast<int>(cloud.size()) - i, random_generator);
 
 		// Run trough list of numbers, starting at the lowest, to avoid duplicates
 		for (int j = 0; j < i; j++) {
@@ -101,26 +101,40 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointSource, typename PointTarget, typename FeatureT> void SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::computeSimilarFeatures() {
+	similar_features_.resize(input_features_->size());
+
+	#pragma omp parallel
+	{
+		std::vector<float> nn_distances(k_correspondences_);
+
+		#pragma omp for schedule(dynamic, 64)
+		for (int idx = 0; idx < static_cast<int>(input_features_->size()); ++idx) {
+			// Find the k nearest feature neighbors to the input feature
+			feature_tree_->nearestKSearch(*input_features_, idx, k_correspondences_, similar_features_[idx], nn_distances);
+		}
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointSource, typename PointTarget, typename FeatureT> void SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::findSimilarFeatures(
-        const std::vector<int> &sample_indices, std::vector<std::vector<int> >& similar_features, std::vector<int> &corresponding_indices) {
+        const std::vector<int> &sample_indices, std::vector<int> &corresponding_indices, RandomGenerator& random_generator) {
 	// Allocate results
 	corresponding_indices.resize(sample_indices.size());
-	std::vector<float> nn_distances(k_correspondences_);
 
 	// Loop over the sampled features
 	for (size_t i = 0; i < sample_indices.size(); ++i) {
-		// Current feature index
-		const int idx = sample_indices[i];
-
-		// Find the k nearest feature neighbors to the sampled input feature if they are not in the cache already
-		if (similar_features[idx].empty()) feature_tree_->nearestKSearch(*input_features_, idx, k_correspondences_, similar_features[idx], nn_distances);
+		// k nearest feature neighbors of the sampled input feature (precomputed in computeSimilarFeatures)
+		const std::vector<int>& similar_features = similar_features_[sample_indices[i]];
 
 		// Select one at random and add it to corresponding_indices
-		if (k_correspondences_ == 1)
-			corresponding_indices[i] = similar_features[idx][0];
+		if (similar_features.empty())
+			corresponding_indices[i] = -1;
+		else if (similar_features.size() == 1)
+			corresponding_indices[i] = similar_features[0];
 		else
-			corresponding_indices[i] = similar_features[idx][getRandomIndex(k_correspondences_)];
+			corresponding_indices[i] = similar_features[getRandomIndex(static_cast<int>(similar_features.size()), random_generator)];
 	}
 }
 
@@ -194,6 +208,9 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 	double lowest_error = std::numeric_limits<double>::max();
 	converged_ = false;
 
+	// seed of the evaluation order and of the iterations (each iteration reseeds the generator of its thread with (seed, iteration) to make the samples independent of the threads scheduling)
+	const boost::uint64_t random_seed = (random_seed_ < 0) ? RandomGenerator::generateSeed() : static_cast<boost::uint64_t>(random_seed_);
+	computeEvaluationOrder(random_seed);
 
 	// If guess is not the Identity matrix we check it
 	if (!guess.isApprox(Eigen::Matrix4f::Identity(), 0.01f)) {
@@ -201,11 +218,7 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 		float inlier_fraction = 0.0;
 		double error = std::numeric_limits<double>::max();
 
-		PointCloudSource input_transformed;
-		input_transformed.resize(input_->size());
-		transformPointCloud(*input_, input_transformed, final_transformation_);
-		getFitness(input_transformed, inliers, error);
-		if (!inliers.empty()){
+		if (getFitness(final_transformation_, inliers, error) && !inliers.empty()){
 			error /= static_cast<double>(inliers.size());
 			if (input_->empty()) {
 				inlier_fraction = 0.0;
@@ -333,8 +346,8 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 			input_transformed.resize(input_->size());
 			transformPointCloud(*input_, input_transformed, rototranslations[i]);
 
-			// Transform the input and compute the error (uses input_ and final_transformation_)
-			getFitness(input_transformed, inliers, error);
+			// Transform the input and compute the error
+			getFitness(rototranslations[i], inliers, error);
 
 			// If the new fit is better, update results
 			inlier_fraction = static_cast<float>(inliers.size()) / static_cast<float>(input_->size());
@@ -362,23 +375,42 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 #else //-----------------------------------------------------------------------------------------------------------------------------------
 
 	double highest_inlier_fraction = 0.0;
+	int best_iteration = -1;
 	accepted_transformations_->clear();
 
-	#pragma omp parallel for
-	for (int i = 0; i < max_iterations_; ++i) {
-		if (convergence_timer_.getTimeSeconds() > convergence_time_limit_seconds_) {
-			continue;
-		}
+	// feature correspondences are computed once and shared (read only) by all threads
+	computeSimilarFeatures();
+
+	#pragma omp parallel
+	{
+		// per thread buffers reused across pose hypotheses
+		std::vector<int> sample_indices, corresponding_indices, inliers;
+		sample_indices.reserve(nr_samples_);
+		corresponding_indices.reserve(nr_samples_);
+		inliers.reserve(input_->size());
+		PointCloudSource input_transformed;
+		pcl::CorrespondencesPtr temp_corrs(new pcl::Correspondences());
+		pcl::CorrespondencesPtr filtered_corrs(new pcl::Correspondences());
+		temp_corrs->reserve(nr_samples_);
+		filtered_corrs->reserve(nr_samples_);
+		std::vector< typename pcl::registration::CorrespondenceRejector::Ptr > correspondence_rejectors;
+		setupCorrespondanceRejectors(correspondence_rejectors);
+		pcl::registration::TransformationEstimationSVD<PointSource, PointTarget> transformation_estimation;
+		RandomGenerator random_generator;
+
+		#pragma omp for
+		for (int i = 0; i < max_iterations_; ++i) {
+			if (convergence_timer_.getTimeSeconds() > convergence_time_limit_seconds_) {
+				continue;
+			}
 
-		//		if (highest_inlier_fraction < 0.99) {
-			std::vector<std::vector<int> > similar_features(input_->size());
-			std::vector<int> sample_indices, corresponding_indices;
+			random_generator.setSeed(random_seed, static_cast<boost::uint64_t>(i));
 
 			// Draw nr_samples_ random samples
-			selectSamples(*input_, nr_samples_, sample_indices);
+			selectSamples(*input_, nr_samples_, sample_indices, random_generator);
 
 			// Find corresponding features in the target cloud
-			findSimilarFeatures(sample_indices, similar_features, corresponding_indices);
+			findSimilarFeatures(sample_indices, corresponding_indices, random_generator);
 
 			// Apply prerejection
 			/*if (!correspondence_rejector_poly_->thresholdPolygon (sample_indices, corresponding_indices)) {
@@ -386,62 +418,46 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 			continue;
 			}*/
 
-			pcl::CorrespondencesPtr temp_corrs(new pcl::Correspondences());
-			pcl::CorrespondencesPtr filtered_corrs(new pcl::Correspondences());
-			for (size_t i = 0; i < sample_indices.size(); ++i) {
-				float distance = pcl::euclideanDistance((*input_)[sample_indices[i]], (*target_)[corresponding_indices[i]]);
-				temp_corrs->push_back(pcl::Correspondence(sample_indices[i], corresponding_indices[i], distance));
+			temp_corrs->clear();
+			for (size_t j = 0; j < sample_indices.size(); ++j) {
+				if (corresponding_indices[j] < 0) { continue; }
+				float distance = pcl::euclideanDistance((*input_)[sample_indices[j]], (*target_)[corresponding_indices[j]]);
+				temp_corrs->push_back(pcl::Correspondence(sample_indices[j], corresponding_indices[j], distance));
 			}
 
 			if (temp_corrs->empty()) continue;
 
+			bool correspondences_rejected = false;
+			for (size_t j = 0; j < correspondence_rejectors.size(); ++j) {
+				filtered_corrs->clear();
+				correspondence_rejectors[j]->getRemainingCorrespondences(*temp_corrs, *filtered_corrs);
 
-			// correspondence grouping
-			// TODO: aa
-
-			std::vector< typename pcl::registration::CorrespondenceRejector::Ptr > correspondence_rejectors;
-			setupCorrespondanceRejectors(correspondence_rejectors);
-
-			for (size_t i = 0; i < correspondence_rejectors.size(); ++i) {
-				filtered_corrs = pcl::CorrespondencesPtr(new pcl::Correspondences());
-
-				//			#pragma omp critical
-				correspondence_rejectors[i]->getRemainingCorrespondences(*temp_corrs, *filtered_corrs);
-
-				if (filtered_corrs->size() < 3) break;
-				temp_corrs = filtered_corrs;
+				if (filtered_corrs->size() < 3) { correspondences_rejected = true; break; }
+				temp_corrs.swap(filtered_corrs); // the remaining correspondences are the input of the next rejector
 			}
 
-			if (filtered_corrs->size() > 2) {
+			const pcl::Correspondences& accepted_corrs = *temp_corrs;
+			if (!correspondences_rejected && accepted_corrs.size() > 2) {
 				Matrix4 transformation;
-				pcl::registration::TransformationEstimationSVD<PointSource, PointTarget> transformation_estimation;
 
 				// Estimate the transform from the correspondences, write to transformation_
-				//    transformation_estimation_->estimateRigidTransformation(*input_, sample_indices, *target_, corresponding_indices, transformation_);
-				//			#pragma omp critical
-				transformation_estimation.estimateRigidTransformation(*input_, *target_, *filtered_corrs, transformation);
+				transformation_estimation.estimateRigidTransformation(*input_, *target_, accepted_corrs, transformation);
 
-				// Transform the input dataset using the final transformation
-				PointCloudSource input_transformed;
-				pcl::transformPointCloud(*input_, input_transformed, transformation);
-
-				std::vector<int> inliers;
 				double error;
 
-				// Transform the input and compute the error (uses input_ and final_transformation_)
-				getFitness(input_transformed, inliers, error);
-
-				if (inliers.size() > 2) {
+				// Transform the input and compute the error (rejecting the hypothesis as soon as it can not reach the required inlier fraction)
+				if (getFitness(transformation, inliers, error) && inliers.size() > 2) {
 					double current_inlier_fraction = 0.0;
 					if (!input_->empty()) {
 						current_inlier_fraction = static_cast<double>(inliers.size()) / static_cast<double>(input_->size());
 					}
 
 					if (update_visualizer_ != 0) {
+						pcl::transformPointCloud(*input_, input_transformed, transformation);
 						std::vector<int> sample_indices_filtered, corresponding_indices_filtered;
-						for (size_t i = 0; i < filtered_corrs->size(); ++i) {
-							sample_indices_filtered.push_back((*filtered_corrs)[i].index_query);
-							corresponding_indices_filtered.push_back((*filtered_corrs)[i].index_match);
+						for (size_t j = 0; j < accepted_corrs.size(); ++j) {
+							sample_indices_filtered.push_back(accepted_corrs[j].index_query);
+							corresponding_indices_filtered.push_back(accepted_corrs[j].index_match);
 						}
 						#pragma omp critical
 						update_visualizer_(input_transformed, sample_indices_filtered, *target_, corresponding_indices_filtered);
@@ -451,8 +467,10 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 					#pragma omp critical
 					if (current_inlier_fraction >= inlier_fraction_ && error < inlier_rmse_) {
 						accepted_transformations_->push_back(transformation);
-						if (error < lowest_error) {
+						// ties are broken by the iteration number to have the same result with any number of threads
+						if (error < lowest_error || (error == lowest_error && i < best_iteration)) {
 							highest_inlier_fraction = current_inlier_fraction;
+							best_iteration = i;
 							inliers_ = inliers;
 							lowest_error = error;
 							converged_ = true;
@@ -462,7 +480,7 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 					}
 				}
 			}
-//		}
+		}
 	}
 #endif //--------------------------------------------------------------------------------------------------------------------------------
 
@@ -477,40 +495,84 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template<typename PointSource, typename PointTarget, typename FeatureT> void SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::getFitness(
-		PointCloudSource& input_transformed, std::vector<int>& inliers, double& fitness_score) {
+template<typename PointSource, typename PointTarget, typename FeatureT> void SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::computeEvaluationOrder(
+		boost::uint64_t random_seed) {
+	evaluation_order_.resize(input_->size());
+	for (size_t i = 0; i < evaluation_order_.size(); ++i) {
+		evaluation_order_[i] = static_cast<int>(i);
+	}
+
+	// partial Fisher-Yates shuffle (only the preverification points need to be random)
+	RandomGenerator random_generator(random_seed, std::numeric_limits<boost::uint64_t>::max());
+	const size_t number_of_shuffled_points = std::min(evaluation_order_.size(), static_cast<size_t>(std::max(preverification_number_of_points_, 0)));
+	for (size_t i = 0; i < number_of_shuffled_points; ++i) {
+		size_t random_index = i + random_generator.getRandomIndex(static_cast<int>(evaluation_order_.size() - i));
+		std::swap(evaluation_order_[i], evaluation_order_[random_index]);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointSource, typename PointTarget, typename FeatureT> bool SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::getFitness(
+		const Matrix4& transformation, std::vector<int>& inliers, double& fitness_score) {
 	// Initialize variables
 	inliers.clear();
 	inliers.reserve(input_->size());
-	fitness_score = 0.0f;
+	fitness_score = std::numeric_limits<double>::max();
+	double sum_of_squared_distances = 0.0;
 
 	// Use squared distance for comparison with NN search results
 	const float max_range = corr_dist_threshold_ * corr_dist_threshold_;
 
+	const Eigen::Matrix3f rotation = transformation.template block<3, 3>(0, 0).template cast<float>();
+	const Eigen::Vector3f translation = transformation.template block<3, 1>(0, 3).template cast<float>();
+
+	const size_t number_of_points = evaluation_order_.size();
+	const size_t min_number_of_inliers = static_cast<size_t>(std::ceil(inlier_fraction_ * number_of_points));
+	const size_t number_of_preverification_points = std::min(number_of_points, static_cast<size_t>(std::max(preverification_number_of_points_, 0)));
+	const double expected_preverification_inliers = inlier_fraction_ * number_of_preverification_points;
+	const double min_number_of_preverification_inliers = expected_preverification_inliers - preverification_rejection_z_score_ * std::sqrt(expected_preverification_inliers * (1.0 - inlier_fraction_));
+
+	std::vector<int> nn_indices(1);
+	std::vector<float> nn_dists(1);
+	PointSource point_transformed;
+
 	// For each point in the source dataset
-	for (size_t i = 0; i < input_transformed.size(); ++i) {
+	for (size_t i = 0; i < number_of_points; ++i) {
+		const int point_index = evaluation_order_[i];
+		point_transformed = input_->points[point_index];
+		point_transformed.getVector3fMap() = rotation * input_->points[point_index].getVector3fMap() + translation;
+
 		// Find its nearest neighbor in the target
-		std::vector<int> nn_indices(1);
-		std::vector<float> nn_dists(1);
-		tree_->nearestKSearch(input_transformed.points[i], 1, nn_indices, nn_dists);
+		tree_->nearestKSearch(point_transformed, 1, nn_indices, nn_dists);
 
 		// Check if point is an inlier
 		if (nn_dists[0] < max_range) {
 			// Update inliers
-			inliers.push_back(static_cast<int>(i));
+			inliers.push_back(point_index);
 
 			// Update fitness score
-			fitness_score += nn_dists[0];
+			sum_of_squared_distances += nn_dists[0];
+		}
+
+		// Preverification on the random subset of points
+		if (i + 1 == number_of_preverification_points && number_of_preverification_points < number_of_points && inliers.size() < min_number_of_preverification_inliers) {
+			return false;
+		}
+
+		// The remaining points can no longer reach the required inlier fraction
+		if (inliers.size() + (number_of_points - i - 1) < min_number_of_inliers) {
+			return false;
 		}
 	}
 
+	std::sort(inliers.begin(), inliers.end());
+
 	// Calculate MSE
 	if (inliers.size() > 0) {
-		fitness_score /= static_cast<double>(inliers.size());
-		fitness_score = std::sqrt(fitness_score);
-	} else {
-		fitness_score = std::numeric_limits<double>::max();
+		fitness_score = std::sqrt(sum_of_squared_distances / static_cast<double>(inliers.size()));
 	}
+
+	return true;
 }
 
 template<typename PointSource, typename PointTarget, typename FeatureT>
@@ -36,6 +36,17 @@ void KeypointDescriptor<PointT, FeatureT>::setupConfigurationFromParameterServer
 		} else {
 			feature_descriptor_->setRadiusSearch(0.0);
 		}
+
+		configuration_hash_ = hash_utils::computeHash(std::string(typeid(*feature_descriptor_).name()));
+		configuration_hash_ = hash_utils::computeHash(std::string(typeid(FeatureT).name()), configuration_hash_);
+		int k_search = feature_descriptor_->getKSearch();
+		double radius_search = feature_descriptor_->getRadiusSearch();
+		configuration_hash_ = hash_utils::computeHash(&k_search, sizeof(int), configuration_hash_);
+		configuration_hash_ = hash_utils::computeHash(&radius_search, sizeof(double), configuration_hash_);
+		XmlRpc::XmlRpcValue configuration;
+		if (private_node_handle->getParam(configuration_namespace, configuration)) { // descriptor specific parameters
+			configuration_hash_ = hash_utils::computeHash(configuration.toXml(), configuration_hash_);
+		}
 	}
 }
 
@@ -41,6 +41,8 @@
 #ifndef PCL_REGISTRATION_SAMPLE_CONSENSUS_PREREJECTIVE_H_
 #define PCL_REGISTRATION_SAMPLE_CONSENSUS_PREREJECTIVE_H_
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <pcl/registration/registration.h>
 #include <pcl/registration/transformation_estimation_svd.h>
@@ -65,6 +67,9 @@
 #include <boost/smart_ptr/shared_ptr.hpp>
 #include <Eigen/Core>
 
+#include <dynamic_robot_localization/common/random_generator.h>
+#include <dynamic_robot_localization/cloud_matchers/feature_matchers/descriptor_search_index.h>
+
 
 #ifdef _OPENMP
    #include <omp.h>
@@ -134,7 +139,7 @@ namespace dynamic_robot_localization
       typedef boost::shared_ptr<SampleConsensusPrerejective<PointSource, PointTarget, FeatureT> > Ptr;
       typedef boost::shared_ptr<const SampleConsensusPrerejective<PointSource, PointTarget, FeatureT> > ConstPtr;
 
-      typedef typename pcl::KdTreeFLANN<FeatureT>::Ptr FeatureKdTreePtr;
+      typedef typename DescriptorSearchIndex<FeatureT>::Ptr FeatureSearchIndexPtr;
       
       typedef pcl::registration::CorrespondenceRejectorPoly<PointSource, PointTarget> CorrespondenceRejectorPoly;
       typedef typename CorrespondenceRejectorPoly::Ptr CorrespondenceRejectorPolyPtr;
@@ -146,12 +151,15 @@ namespace dynamic_robot_localization
         , target_features_ ()
         , nr_samples_(3)
         , k_correspondences_ (2)
-        , feature_tree_ (new pcl::KdTreeFLANN<FeatureT>)
+        , feature_tree_ (new DescriptorSearchIndex<FeatureT>)
         , correspondence_rejector_poly_ (new CorrespondenceRejectorPoly)
         , inlier_fraction_ (0.0f)
         , inlier_rmse_(0.0f)
         , accepted_transformations_(new std::vector<Matrix4>())
         , convergence_time_limit_seconds_(std::numeric_limits<double>::max())
+        , random_seed_(-1)
+        , preverification_number_of_points_(100)
+        , preverification_rejection_z_score_(3.0)
       {
         reg_name_ = "SampleConsensusPrerejective";
         correspondence_rejector_poly_->setSimilarityThreshold (0.6f);
@@ -190,6 +198,17 @@ namespace dynamic_robot_localization
         return (target_features_);
       }
 
+      /** \brief Provide the search index used to find the target features similar to the source features
+        * (allows to use an index loaded from a file or shared with other matchers; it is only rebuilt if it does not index the target features)
+        * \param feature_search_index the descriptors search index
+        */
+      inline void
+      setFeatureSearchIndex (const FeatureSearchIndexPtr &feature_search_index) { feature_tree_ = feature_search_index; }
+
+      /** \brief Get the search index of the target features */
+      inline FeatureSearchIndexPtr
+      getFeatureSearchIndex () { return (feature_tree_); }
+
       /** \brief Set the number of samples to use during each iteration
         * \param nr_samples the number of samples to use during each iteration
         */
@@ -281,14 +300,29 @@ namespace dynamic_robot_localization
 
       inline void setConvergenceTimeLimitSeconds(double convergence_time_limit_seconds) { convergence_time_limit_seconds_ = convergence_time_limit_seconds; }
 
+      /** \brief Set the seed used to generate the random samples of each iteration (a negative value uses a different seed in each alignment).
+       * With a fixed seed, the results are reproducible regardless of the number of threads (unless the convergence time limit is reached).
+       */
+      inline void setRandomSeed(int random_seed) { random_seed_ = random_seed; }
+      inline int getRandomSeed() const { return random_seed_; }
+
+      /** \brief Set the number of random points that are evaluated before the rest of the cloud when computing the fitness of a pose hypothesis (0 disables the preverification).
+       * A hypothesis is rejected after the preverification if its inlier count is below the one expected for the required inlier fraction by more than
+       * \a rejection_z_score standard deviations (binomial approximation). During the full evaluation, it is also rejected as soon as the remaining points
+       * can no longer reach the required inlier fraction.
+       */
+      inline void setPreverificationNumberOfPoints(int number_of_points) { preverification_number_of_points_ = number_of_points; }
+      inline void setPreverificationRejectionZScore(double rejection_z_score) { preverification_rejection_z_score_ = rejection_z_score; }
+
     protected:
       /** \brief Choose a random index between 0 and n-1
         * \param n the number of possible indices to choose from
+        * \param random_generator the generator of the calling thread
         */
       inline int 
-      getRandomIndex (int n) const
+      getRandomIndex (int n, RandomGenerator& random_generator) const
       {
-        return (static_cast<int> (n * (rand () / (RAND_MAX + 1.0))));
+        return (random_generator.getRandomIndex (n));
       };
       
       /** \brief Select \a nr_samples sample points from cloud while making sure that their pairwise distances are 
@@ -296,21 +330,26 @@ namespace dynamic_robot_localization
         * \param cloud the input point cloud
         * \param nr_samples the number of samples to select
         * \param sample_indices the resulting sample indices
+        * \param random_generator the generator of the calling thread
         */
       void 
-      selectSamples (const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices);
+      selectSamples (const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices, RandomGenerator& random_generator);
+
+      /** \brief For each input feature, find its k nearest features in the target cloud and store them in \ref similar_features_.
+        * It is called once before the RANSAC iterations, which then share the cache without synchronization.
+        */
+      void
+      computeSimilarFeatures ();
 
-      /** \brief For each of the sample points, find a list of points in the target cloud whose features are similar to 
-        * the sample points' features. From these, select one randomly which will be considered that sample point's 
-        * correspondence.
+      /** \brief For each of the sample points, select randomly one of the target points whose features are similar to
+        * the sample points' features (read from \ref similar_features_), which will be considered that sample point's correspondence.
         * \param sample_indices the indices of each sample point
-        * \param similar_features correspondence cache, which is used to read/write already computed correspondences
-        * \param corresponding_indices the resulting indices of each sample's corresponding point in the target cloud
+        * \param corresponding_indices the resulting indices of each sample's corresponding point in the target cloud (-1 if there is none)
+        * \param random_generator the generator of the calling thread
         */
       void 
       findSimilarFeatures (const std::vector<int> &sample_indices,
-              std::vector<std::vector<int> >& similar_features,
-              std::vector<int> &corresponding_indices);
+              std::vector<int> &corresponding_indices, RandomGenerator& random_generator);
 
       /** \brief Rigid transformation computation method.
         * \param output the transformed input point cloud dataset using the rigid transformation found
@@ -319,16 +358,24 @@ namespace dynamic_robot_localization
       void 
       computeTransformation (PointCloudSource &output, const Eigen::Matrix4f& guess);
 
+      /** \brief Compute a random order for evaluating the source points in \ref getFitness (the first points are used for the preverification). */
+      void
+      computeEvaluationOrder (boost::uint64_t random_seed);
+
       /** \brief Obtain the fitness of a transformation
         * The following metrics are calculated, based on
-        * \b final_transformation_ and \b corr_dist_threshold_:
+        * \b transformation and \b corr_dist_threshold_:
         *   - Inliers: the number of transformed points which are closer than threshold to NN
         *   - Error score: the MSE of the inliers  
+        * The source points are transformed while being evaluated (following \ref evaluation_order_)
+        * and the evaluation stops early if the hypothesis can not reach the required inlier fraction.
+        * \param transformation pose hypothesis
         * \param inliers indices of source point cloud inliers
         * \param fitness_score output fitness score as RMSE 
+        * \return false if the hypothesis was rejected before evaluating all points
         */
-      void 
-      getFitness (PointCloudSource& input_transformed, std::vector<int>& inliers, double& fitness_score);
+      bool 
+      getFitness (const Matrix4& transformation, std::vector<int>& inliers, double& fitness_score);
 
       /** \brief The source point cloud's feature descriptors. */
       FeatureCloudConstPtr input_features_;
@@ -343,7 +390,10 @@ namespace dynamic_robot_localization
       int k_correspondences_;
      
       /** \brief The KdTree used to compare feature descriptors. */
-      FeatureKdTreePtr feature_tree_;
+      FeatureSearchIndexPtr feature_tree_;
+
+      /** \brief Cache with the k nearest target features of each source feature. */
+      std::vector<std::vector<int> > similar_features_;
       
       /** \brief The polygonal correspondence rejector used for prerejection */
       CorrespondenceRejectorPolyPtr correspondence_rejector_poly_;
@@ -360,6 +410,14 @@ namespace dynamic_robot_localization
 
       pcl::StopWatch convergence_timer_;
       double convergence_time_limit_seconds_;
+
+      /** \brief Seed of the random generators (negative for a time based seed) */
+      int random_seed_;
+
+      /** \brief Random permutation of the source indices, used to evaluate the pose hypotheses */
+      std::vector<int> evaluation_order_;
+      int preverification_number_of_points_;
+      double preverification_rejection_z_score_;
   };
 
 } /* namespace dynamic_robot_localization */
@@ -18,9 +18,11 @@ namespace dynamic_robot_localization {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 template<typename PointT>
 CloudMatcher<PointT>::CloudMatcher() :
+		trace_span_id_(0),
 		match_only_keypoints_(false),
 		display_cloud_aligment_(false),
-		maximum_number_of_displayed_correspondences_(0) {}
+		maximum_number_of_displayed_correspondences_(0),
+		registration_initial_guess_(Eigen::Matrix4f::Identity()) {}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <CloudMatcher-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -113,6 +115,25 @@ void CloudMatcher<PointT>::setupConfigurationFromParameterServer(ros::NodeHandle
 			correspondence_estimation_raw_ptr_->getSourceCorrespondencesLookupTable().setComputeDistanceFromQueryPointToClosestPoint(sensor_compute_distance_from_query_point_to_closest_point);
 			correspondence_estimation_raw_ptr_->getSourceCorrespondencesLookupTable().setInitializeLookupTableUsingEuclideanDistanceTransform(sensor_initialize_lookup_table_using_euclidean_distance_transform);
 			correspondence_estimation_ptr_ = typename pcl::registration::CorrespondenceEstimationBase<PointT, PointT, float>::Ptr(correspondence_estimation_raw_ptr_);
+		} else if (correspondence_estimation_method == "CorrespondenceEstimationPersistentLookupTable") {
+			correpondence_estimation_approach_ = CorrespondenceEstimationPersistentLookupTable;
+			CorrespondenceEstimationPersistentLookupTableTimed<PointT, PointT, float>* correspondence_estimation_raw_ptr_ = new CorrespondenceEstimationPersistentLookupTableTimed<PointT, PointT, float>();
+			double cell_resolution = 0.01, margin_x = 1.0, margin_y = 1.0, margin_z = 1.0, incremental_update_radius = 0.1;
+			bool use_search_tree_when_query_point_is_outside_lookup_table = true;
+			std::string filename;
+			if (ros::param::search(search_namespace, "correspondence_estimation_persistent_lookup_table/cell_resolution", final_param_name)) { private_node_handle->param(final_param_name, cell_resolution, 0.01); }
+			if (ros::param::search(search_namespace, "correspondence_estimation_persistent_lookup_table/margin_x", final_param_name)) { private_node_handle->param(final_param_name, margin_x, 1.0); }
+			if (ros::param::search(search_namespace, "correspondence_estimation_persistent_lookup_table/margin_y", final_param_name)) { private_node_handle->param(final_param_name, margin_y, 1.0); }
+			if (ros::param::search(search_namespace, "correspondence_estimation_persistent_lookup_table/margin_z", final_param_name)) { private_node_handle->param(final_param_name, margin_z, 1.0); }
+			if (ros::param::search(search_namespace, "correspondence_estimation_persistent_lookup_table/use_search_tree_when_query_point_is_outside_lookup_table", final_param_name)) { private_node_handle->param(final_param_name, use_search_tree_when_query_point_is_outside_lookup_table, true); }
+			if (ros::param::search(search_namespace, "correspondence_estimation_persistent_lookup_table/filename", final_param_name)) { private_node_handle->param(final_param_name, filename, std::string("")); }
+			if (ros::param::search(search_namespace, "correspondence_estimation_persistent_lookup_table/incremental_update_radius", final_param_name)) { private_node_handle->param(final_param_name, incremental_update_radius, 0.1); }
+			correspondence_estimation_raw_ptr_->getTargetLookupTable()->setCellResolution(cell_resolution);
+			correspondence_estimation_raw_ptr_->getTargetLookupTable()->setLookupTableMargin(Eigen::Vector3f(margin_x, margin_y, margin_z));
+			correspondence_estimation_raw_ptr_->getTargetLookupTable()->setFilename(filename);
+			correspondence_estimation_raw_ptr_->getTargetLookupTable()->setIncrementalUpdateRadius(incremental_update_radius);
+			correspondence_estimation_raw_ptr_->setUseSearchTreeWhenQueryPointIsOutsideLookupTable(use_search_tree_when_query_point_is_outside_lookup_table);
+			correspondence_estimation_ptr_ = typename pcl::registration::CorrespondenceEstimationBase<PointT, PointT, float>::Ptr(correspondence_estimation_raw_ptr_);
 		} else if (correspondence_estimation_method == "CorrespondenceEstimationBackProjection") {
 			correpondence_estimation_approach_ = CorrespondenceEstimationBackProjection;
 			CorrespondenceEstimationBackProjectionTimed<PointT, PointT, PointT, float>* correspondence_estimation_raw_ptr_ = new CorrespondenceEstimationBackProjectionTimed<PointT, PointT, PointT, float>();
@@ -190,7 +211,14 @@ void CloudMatcher<PointT>::setupReferenceCloud(typename pcl::PointCloud<PointT>:
 		cloud_matcher_->setInputTarget(reference_cloud);
 		cloud_matcher_->setSearchMethodTarget(search_method, true);
 		if (cloud_matcher_->getCorrespondenceEstimation())
-			cloud_matcher_->getCorrespondenceEstimation()->setSearchMethodTarget(search_method, false);
+			cloud_matcher_->getCorrespondenceEstimation()->setSearchMethodTarget(search_method, true); // the search method must already index the reference cloud (it may be shared by matchers running in parallel)
+
+		if (correpondence_estimation_approach_ == CorrespondenceEstimationPersistentLookupTable) {
+			typename CorrespondenceEstimationPersistentLookupTableTimed<PointT, PointT, float>::Ptr estimator = boost::dynamic_pointer_cast< CorrespondenceEstimationPersistentLookupTableTimed<PointT, PointT, float> >(correspondence_estimation_ptr_);
+			if (estimator && !estimator->getTargetLookupTable()->setupReferenceCloud(reference_cloud)) {
+				ROS_WARN("Failed to setup the persistent lookup table of the correspondence estimation (the search tree will be used instead)");
+			}
+		}
 	}
 
 	if (registration_visualizer_) {
@@ -209,6 +237,7 @@ bool CloudMatcher<PointT>::registerCloud(typename pcl::PointCloud<PointT>::Ptr&
 	if (!cloud_matcher_) {
 		return false;
 	}
+	TraceSpan trace_span(trace_span_id_);
 	std::vector<int> indexes;
 	pcl::removeNaNFromPointCloud(*ambient_pointcloud, *ambient_pointcloud, indexes);
 	indexes.clear();
@@ -248,7 +277,7 @@ bool CloudMatcher<PointT>::registerCloud(typename pcl::PointCloud<PointT>::Ptr&
 	cloud_align_time_ms_ = 0;
 	PerformanceTimer performance_timer;
 	performance_timer.start();
-	cloud_matcher_->align(*pointcloud_registered_out);
+	cloud_matcher_->align(*pointcloud_registered_out, registration_initial_guess_);
 	cloud_align_time_ms_ = performance_timer.getElapsedTimeInMilliSec();
 
 	Eigen::Matrix4f final_transformation = cloud_matcher_->getFinalTransformation();
@@ -332,6 +361,12 @@ double CloudMatcher<PointT>::getCorrespondenceEstimationElapsedTimeMS() {
 				break;
 			}
 
+			case CorrespondenceEstimationPersistentLookupTable: {
+				typename CorrespondenceEstimationPersistentLookupTableTimed<PointT, PointT, float>::Ptr estimator = boost::dynamic_pointer_cast< CorrespondenceEstimationPersistentLookupTableTimed<PointT, PointT, float> >(correspondence_estimation_ptr_);
+				if (estimator) { return estimator->getCorrespondenceEstimationElapsedTime(); }
+				break;
+			}
+
 			case CorrespondenceEstimationBackProjection: {
 				typename CorrespondenceEstimationBackProjectionTimed<PointT, PointT, PointT, float>::Ptr estimator = boost::dynamic_pointer_cast< CorrespondenceEstimationBackProjectionTimed<PointT, PointT, PointT, float> >(correspondence_estimation_ptr_);
 				if (estimator) { return estimator->getCorrespondenceEstimationElapsedTime(); }
@@ -374,6 +409,12 @@ void CloudMatcher<PointT>::resetCorrespondenceEstimationElapsedTime() {
 				break;
 			}
 
+			case CorrespondenceEstimationPersistentLookupTable: {
+				typename CorrespondenceEstimationPersistentLookupTableTimed<PointT, PointT, float>::Ptr estimator = boost::dynamic_pointer_cast< CorrespondenceEstimationPersistentLookupTableTimed<PointT, PointT, float> >(correspondence_estimation_ptr_);
+				if (estimator) { estimator->resetCorrespondenceEstimationElapsedTime(); }
+				break;
+			}
+
 			case CorrespondenceEstimationBackProjection: {
 				typename CorrespondenceEstimationBackProjectionTimed<PointT, PointT, PointT, float>::Ptr estimator = boost::dynamic_pointer_cast< CorrespondenceEstimationBackProjectionTimed<PointT, PointT, PointT, float> >(correspondence_estimation_ptr_);
 				if (estimator) { estimator->resetCorrespondenceEstimationElapsedTime(); }
@@ -0,0 +1,157 @@
+#pragma once
+
+/**\file branch_and_bound_2d.h
+ * \brief Global 2D registration using branch and bound over a multi resolution likelihood grid of the reference cloud.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+// ROS includes
+
+// PCL includes
+#include <pcl/common/transforms.h>
+#include <pcl/registration/registration.h>
+
+// external libs includes
+#include <boost/cstdint.hpp>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+// project includes
+#include <dynamic_robot_localization/cloud_matchers/cloud_matcher.h>
+#include <dynamic_robot_localization/common/performance_timer.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// ###################################################################   BranchAndBoundRegistration2D   #######################################################################
+/**
+ * \brief Exhaustive search over [x, y, yaw] that finds the pose that maximizes the mean likelihood of the source points in a grid computed from the target cloud.
+ * The likelihood grid is precomputed in several resolutions (grid i has in each cell the maximum likelihood of the 2^i x 2^i cells of the finest grid that start in that cell),
+ * which gives an upper bound of the score of a whole region of translations and allows the depth first search to discard most of the search window without evaluating it.
+ * The search window is centered in the centroid of the source cloud (after applying the guess) and the result is the best pose with score above the minimum score.
+ */
+template <typename PointSource, typename PointTarget>
+class BranchAndBoundRegistration2D : public pcl::Registration<PointSource, PointTarget, float> {
+	public:
+		typedef boost::shared_ptr< BranchAndBoundRegistration2D<PointSource, PointTarget> > Ptr;
+		typedef boost::shared_ptr< const BranchAndBoundRegistration2D<PointSource, PointTarget> > ConstPtr;
+		typedef typename pcl::Registration<PointSource, PointTarget, float>::PointCloudSource PointCloudSource;
+		typedef typename pcl::Registration<PointSource, PointTarget, float>::PointCloudTargetConstPtr PointCloudTargetConstPtr;
+		typedef typename pcl::Registration<PointSource, PointTarget, float>::Matrix4 Matrix4;
+
+		struct LikelihoodGrid {
+			int width;
+			int height;
+			std::vector<boost::uint8_t> cells;
+			inline boost::uint8_t getCell(int x, int y) const { return (x >= 0 && y >= 0 && x < width && y < height) ? cells[y * width + x] : 0; }
+		};
+
+		struct Candidate {
+			size_t angle_index;
+			int x_offset;
+			int y_offset;
+			float score;
+			inline bool operator>(const Candidate& other) const { return score > other.score; }
+		};
+
+		BranchAndBoundRegistration2D();
+		virtual ~BranchAndBoundRegistration2D() {}
+
+		void computeLikelihoodGrids();
+		/** \brief The grids are rebuilt in the next registration when the target cloud was replaced or its points were reallocated / resized (map updates). */
+		bool isLikelihoodGridsUpToDate() const;
+
+		inline int getNumberOfRegistrationIterations() { return pcl::Registration<PointSource, PointTarget, float>::nr_iterations_; }
+		inline float getBestScore() const { return best_score_; }
+		inline const std::vector<LikelihoodGrid>& getLikelihoodGrids() const { return likelihood_grids_; }
+
+		inline void setGridResolution(double grid_resolution) { grid_resolution_ = grid_resolution; likelihood_grids_.clear(); }
+		inline void setLikelihoodSigma(double likelihood_sigma) { likelihood_sigma_ = likelihood_sigma; likelihood_grids_.clear(); }
+		inline void setNumberOfPrecomputedGrids(int number_of_precomputed_grids) { number_of_precomputed_grids_ = std::max(1, number_of_precomputed_grids); likelihood_grids_.clear(); }
+		inline void setLinearSearchWindow(double linear_search_window) { linear_search_window_ = linear_search_window; }
+		inline void setAngularSearchWindow(double angular_search_window) { angular_search_window_ = angular_search_window; }
+		inline void setAngularStep(double angular_step) { angular_step_ = angular_step; }
+		inline void setMinimumScore(double minimum_score) { minimum_score_ = minimum_score; }
+		inline void setConvergenceTimeLimitSeconds(double convergence_time_limit_seconds) { convergence_time_limit_seconds_ = convergence_time_limit_seconds; }
+
+	protected:
+		virtual void computeTransformation(PointCloudSource& output, const Matrix4& guess);
+		void discretizeSourceCloud(const PointCloudSource& source, const Eigen::Vector2f& rotation_center, std::vector<float>& angles_out, std::vector< std::vector<Eigen::Array2i> >& discrete_scans_out);
+		float scoreCandidate(const LikelihoodGrid& grid, const std::vector<Eigen::Array2i>& discrete_scan, int x_offset, int y_offset);
+		void searchCandidates(const std::vector< std::vector<Eigen::Array2i> >& discrete_scans, std::vector<Candidate>& candidates, int depth, Candidate& best_candidate, PerformanceTimer& timer);
+
+		double grid_resolution_;
+		double likelihood_sigma_;
+		int number_of_precomputed_grids_;
+		double linear_search_window_;
+		double angular_search_window_;
+		double angular_step_;
+		double minimum_score_;
+		double convergence_time_limit_seconds_;
+		bool convergence_time_limit_reached_;
+		float best_score_;
+		Eigen::Vector2f grid_origin_;
+		Eigen::Vector2f target_min_;
+		Eigen::Vector2f target_max_;
+		std::vector<LikelihoodGrid> likelihood_grids_; // index 0 is the finest grid
+		const pcl::PointCloud<PointTarget>* likelihood_grids_target_;
+		const PointTarget* likelihood_grids_target_points_data_;
+		size_t likelihood_grids_target_size_;
+};
+
+
+// ##########################################################################   BranchAndBound2D   ############################################################################
+/**
+ * \brief Initial pose estimator / tracking recovery matcher for 2D maps (reference clouds loaded from occupancy grids or with reset height) with bounded latency.
+ */
+template <typename PointT>
+class BranchAndBound2D : public CloudMatcher<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <typedefs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		typedef boost::shared_ptr< BranchAndBound2D<PointT> > Ptr;
+		typedef boost::shared_ptr< const BranchAndBound2D<PointT> > ConstPtr;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </typedefs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		BranchAndBound2D() {}
+		virtual ~BranchAndBound2D() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <BranchAndBound2D-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace = "");
+		virtual int getNumberOfRegistrationIterations();
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </BranchAndBound2D-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/impl/branch_and_bound_2d.hpp>
+#endif
@@ -0,0 +1,335 @@
+/**\file branch_and_bound_2d.hpp
+ * \brief Global 2D registration using branch and bound over a multi resolution likelihood grid of the reference cloud.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/branch_and_bound_2d.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// ###################################################################   BranchAndBoundRegistration2D   #######################################################################
+template <typename PointSource, typename PointTarget>
+BranchAndBoundRegistration2D<PointSource, PointTarget>::BranchAndBoundRegistration2D() :
+		grid_resolution_(0.05),
+		likelihood_sigma_(0.05),
+		number_of_precomputed_grids_(7),
+		linear_search_window_(-1.0),
+		angular_search_window_(M_PI),
+		angular_step_(-1.0),
+		minimum_score_(0.5),
+		convergence_time_limit_seconds_(-1.0),
+		convergence_time_limit_reached_(false),
+		best_score_(0.0f),
+		likelihood_grids_target_(NULL),
+		likelihood_grids_target_points_data_(NULL),
+		likelihood_grids_target_size_(0) {
+	pcl::Registration<PointSource, PointTarget, float>::reg_name_ = "BranchAndBoundRegistration2D";
+}
+
+
+template <typename PointSource, typename PointTarget>
+void BranchAndBoundRegistration2D<PointSource, PointTarget>::computeLikelihoodGrids() {
+	likelihood_grids_.clear();
+	PointCloudTargetConstPtr target = pcl::Registration<PointSource, PointTarget, float>::target_;
+	likelihood_grids_target_ = target.get();
+	likelihood_grids_target_points_data_ = (target && !target->empty()) ? &target->points[0] : NULL;
+	likelihood_grids_target_size_ = target ? target->size() : 0;
+	if (!target || target->empty() || grid_resolution_ <= 0.0 || likelihood_sigma_ <= 0.0) { return; }
+
+	target_min_ = Eigen::Vector2f(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+	target_max_ = Eigen::Vector2f(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+	for (size_t i = 0; i < target->size(); ++i) {
+		const PointTarget& point = target->points[i];
+		if (!pcl_isfinite(point.x) || !pcl_isfinite(point.y)) { continue; }
+		target_min_(0) = std::min(target_min_(0), point.x); target_min_(1) = std::min(target_min_(1), point.y);
+		target_max_(0) = std::max(target_max_(0), point.x); target_max_(1) = std::max(target_max_(1), point.y);
+	}
+	if (target_min_(0) > target_max_(0)) { return; }
+
+	// the padding ensures that the coarser grids have the maximum of all the finest cells that they cover (cells outside the grids have 0 likelihood)
+	float resolution = (float)grid_resolution_;
+	int kernel_radius = (int)std::ceil(3.0 * likelihood_sigma_ / grid_resolution_);
+	int padding = (1 << (number_of_precomputed_grids_ - 1)) + kernel_radius;
+	grid_origin_ = target_min_ - Eigen::Vector2f(padding * resolution, padding * resolution);
+
+	LikelihoodGrid finest_grid;
+	finest_grid.width = (int)std::ceil((target_max_(0) - target_min_(0)) / resolution) + 1 + 2 * padding;
+	finest_grid.height = (int)std::ceil((target_max_(1) - target_min_(1)) / resolution) + 1 + 2 * padding;
+	finest_grid.cells.resize((size_t)finest_grid.width * (size_t)finest_grid.height, 0);
+
+	float likelihood_scale = -1.0f / (float)(2.0 * likelihood_sigma_ * likelihood_sigma_);
+	for (size_t i = 0; i < target->size(); ++i) {
+		const PointTarget& point = target->points[i];
+		if (!pcl_isfinite(point.x) || !pcl_isfinite(point.y)) { continue; }
+		int point_x = (int)std::floor((point.x - grid_origin_(0)) / resolution);
+		int point_y = (int)std::floor((point.y - grid_origin_(1)) / resolution);
+		for (int y = point_y - kernel_radius; y <= point_y + kernel_radius; ++y) {
+			float dy = grid_origin_(1) + (y + 0.5f) * resolution - point.y;
+			for (int x = point_x - kernel_radius; x <= point_x + kernel_radius; ++x) {
+				float dx = grid_origin_(0) + (x + 0.5f) * resolution - point.x;
+				boost::uint8_t likelihood = (boost::uint8_t)(255.0f * std::exp((dx * dx + dy * dy) * likelihood_scale) + 0.5f);
+				boost::uint8_t& cell = finest_grid.cells[y * finest_grid.width + x];
+				if (likelihood > cell) { cell = likelihood; }
+			}
+		}
+	}
+	likelihood_grids_.push_back(finest_grid);
+
+	// grid i cell (x, y) = max of grid i-1 cells (x, y), (x + s, y), (x, y + s), (x + s, y + s), with s = 2^(i-1)
+	for (int grid_index = 1; grid_index < number_of_precomputed_grids_; ++grid_index) {
+		const LikelihoodGrid& finer_grid = likelihood_grids_.back();
+		LikelihoodGrid coarser_grid;
+		coarser_grid.width = finer_grid.width;
+		coarser_grid.height = finer_grid.height;
+		coarser_grid.cells.resize(finer_grid.cells.size());
+		int step = 1 << (grid_index - 1);
+		#pragma omp parallel for schedule(dynamic, 16)
+		for (int y = 0; y < coarser_grid.height; ++y) {
+			for (int x = 0; x < coarser_grid.width; ++x) {
+				coarser_grid.cells[y * coarser_grid.width + x] = std::max(std::max(finer_grid.getCell(x, y), finer_grid.getCell(x + step, y)), std::max(finer_grid.getCell(x, y + step), finer_grid.getCell(x + step, y + step)));
+			}
+		}
+		likelihood_grids_.push_back(coarser_grid);
+	}
+
+	ROS_DEBUG_STREAM("BranchAndBoundRegistration2D computed " << likelihood_grids_.size() << " likelihood grids with " << finest_grid.width << "x" << finest_grid.height << " cells of " << grid_resolution_ << " meters");
+}
+
+
+template <typename PointSource, typename PointTarget>
+bool BranchAndBoundRegistration2D<PointSource, PointTarget>::isLikelihoodGridsUpToDate() const {
+	PointCloudTargetConstPtr target = pcl::Registration<PointSource, PointTarget, float>::target_;
+	return target.get() == likelihood_grids_target_
+			&& (target ? target->size() : 0) == likelihood_grids_target_size_
+			&& ((target && !target->empty()) ? &target->points[0] : NULL) == likelihood_grids_target_points_data_;
+}
+
+
+template <typename PointSource, typename PointTarget>
+void BranchAndBoundRegistration2D<PointSource, PointTarget>::computeTransformation(PointCloudSource& output, const Matrix4& guess) {
+	pcl::Registration<PointSource, PointTarget, float>::converged_ = false;
+	pcl::Registration<PointSource, PointTarget, float>::nr_iterations_ = 0;
+	pcl::Registration<PointSource, PointTarget, float>::final_transformation_ = guess;
+	convergence_time_limit_reached_ = false;
+	best_score_ = 0.0f;
+
+	PerformanceTimer timer;
+	timer.start();
+	if (likelihood_grids_.empty() || !isLikelihoodGridsUpToDate()) { computeLikelihoodGrids(); }
+
+	pcl::transformPointCloud(output, output, guess);
+	if (likelihood_grids_.empty() || output.empty()) { return; }
+
+	Eigen::Vector2f rotation_center(0.0f, 0.0f);
+	for (size_t i = 0; i < output.size(); ++i) {
+		rotation_center(0) += output.points[i].x;
+		rotation_center(1) += output.points[i].y;
+	}
+	rotation_center /= (float)output.size();
+
+	std::vector<float> angles;
+	std::vector< std::vector<Eigen::Array2i> > discrete_scans;
+	discretizeSourceCloud(output, rotation_center, angles, discrete_scans);
+
+	// search window of the translations (in cells) applied to the source cloud after its rotation around the center
+	int x_offset_min, x_offset_max, y_offset_min, y_offset_max;
+	if (linear_search_window_ > 0.0) {
+		int half_window = (int)std::ceil(linear_search_window_ / grid_resolution_);
+		x_offset_min = -half_window; x_offset_max = half_window;
+		y_offset_min = -half_window; y_offset_max = half_window;
+	} else {
+		x_offset_min = (int)std::floor((target_min_(0) - rotation_center(0)) / grid_resolution_);
+		x_offset_max = (int)std::ceil((target_max_(0) - rotation_center(0)) / grid_resolution_);
+		y_offset_min = (int)std::floor((target_min_(1) - rotation_center(1)) / grid_resolution_);
+		y_offset_max = (int)std::ceil((target_max_(1) - rotation_center(1)) / grid_resolution_);
+	}
+
+	int top_depth = (int)likelihood_grids_.size() - 1;
+	int top_step = 1 << top_depth;
+	std::vector<Candidate> candidates;
+	for (size_t angle_index = 0; angle_index < angles.size(); ++angle_index) {
+		for (int x_offset = x_offset_min; x_offset <= x_offset_max; x_offset += top_step) {
+			for (int y_offset = y_offset_min; y_offset <= y_offset_max; y_offset += top_step) {
+				Candidate candidate;
+				candidate.angle_index = angle_index;
+				candidate.x_offset = x_offset;
+				candidate.y_offset = y_offset;
+				candidate.score = 0.0f;
+				candidates.push_back(candidate);
+			}
+		}
+	}
+
+	const LikelihoodGrid& top_grid = likelihood_grids_[top_depth];
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < (int)candidates.size(); ++i) {
+		candidates[i].score = scoreCandidate(top_grid, discrete_scans[candidates[i].angle_index], candidates[i].x_offset, candidates[i].y_offset);
+	}
+	pcl::Registration<PointSource, PointTarget, float>::nr_iterations_ = (int)candidates.size();
+	std::sort(candidates.begin(), candidates.end(), std::greater<Candidate>());
+
+	Candidate best_candidate;
+	best_candidate.angle_index = angles.size();
+	best_candidate.x_offset = 0;
+	best_candidate.y_offset = 0;
+	best_candidate.score = (float)minimum_score_;
+	searchCandidates(discrete_scans, candidates, top_depth, best_candidate, timer);
+
+	if (best_candidate.angle_index < angles.size()) {
+		best_score_ = best_candidate.score;
+		float angle = angles[best_candidate.angle_index];
+		Eigen::Matrix4f pose_correction = Eigen::Matrix4f::Identity();
+		Eigen::Matrix2f rotation = Eigen::Rotation2Df(angle).toRotationMatrix();
+		pose_correction.block<2, 2>(0, 0) = rotation;
+		pose_correction.block<2, 1>(0, 3) = rotation_center + Eigen::Vector2f(best_candidate.x_offset * grid_resolution_, best_candidate.y_offset * grid_resolution_) - rotation * rotation_center;
+		pcl::transformPointCloud(output, output, pose_correction);
+		pcl::Registration<PointSource, PointTarget, float>::final_transformation_ = pose_correction * guess;
+		pcl::Registration<PointSource, PointTarget, float>::transformation_ = pose_correction;
+		pcl::Registration<PointSource, PointTarget, float>::converged_ = true;
+	}
+
+	int number_of_evaluated_candidates = getNumberOfRegistrationIterations();
+	ROS_DEBUG_STREAM("BranchAndBoundRegistration2D evaluated " << number_of_evaluated_candidates << " candidates with " << angles.size() << " angles in " << timer.getElapsedTimeInMilliSec() << " ms"
+			<< (convergence_time_limit_reached_ ? " (time limit reached)" : "") << " | best score: " << best_score_ << " (minimum score: " << minimum_score_ << ")");
+}
+
+
+template <typename PointSource, typename PointTarget>
+void BranchAndBoundRegistration2D<PointSource, PointTarget>::discretizeSourceCloud(const PointCloudSource& source, const Eigen::Vector2f& rotation_center,
+		std::vector<float>& angles_out, std::vector< std::vector<Eigen::Array2i> >& discrete_scans_out) {
+	float max_range = 0.0f;
+	for (size_t i = 0; i < source.size(); ++i) {
+		max_range = std::max(max_range, (Eigen::Vector2f(source.points[i].x, source.points[i].y) - rotation_center).norm());
+	}
+
+	// angular step that moves the farthest point by at most one cell
+	double angular_step = angular_step_;
+	if (angular_step <= 0.0) {
+		angular_step = (max_range > grid_resolution_) ? std::acos(1.0 - (grid_resolution_ * grid_resolution_) / (2.0 * max_range * max_range)) : M_PI / 180.0;
+	}
+
+	angles_out.clear();
+	if (angular_search_window_ >= M_PI - 1e-4) {
+		int number_of_angles = (int)std::ceil(2.0 * M_PI / angular_step);
+		double full_circle_angular_step = 2.0 * M_PI / number_of_angles;
+		for (int i = 0; i < number_of_angles; ++i) { angles_out.push_back((float)((i - number_of_angles / 2) * full_circle_angular_step)); }
+	} else {
+		int number_of_half_window_angles = (int)std::ceil(angular_search_window_ / angular_step);
+		for (int i = -number_of_half_window_angles; i <= number_of_half_window_angles; ++i) { angles_out.push_back((float)(i * angular_step)); }
+	}
+
+	discrete_scans_out.resize(angles_out.size());
+	float resolution = (float)grid_resolution_;
+	#pragma omp parallel for schedule(dynamic, 8)
+	for (int angle_index = 0; angle_index < (int)angles_out.size(); ++angle_index) {
+		Eigen::Matrix2f rotation = Eigen::Rotation2Df(angles_out[angle_index]).toRotationMatrix();
+		std::vector<Eigen::Array2i>& discrete_scan = discrete_scans_out[angle_index];
+		discrete_scan.resize(source.size());
+		for (size_t i = 0; i < source.size(); ++i) {
+			Eigen::Vector2f point = rotation * (Eigen::Vector2f(source.points[i].x, source.points[i].y) - rotation_center) + rotation_center - grid_origin_;
+			discrete_scan[i] = Eigen::Array2i((int)std::floor(point(0) / resolution), (int)std::floor(point(1) / resolution));
+		}
+	}
+}
+
+
+template <typename PointSource, typename PointTarget>
+float BranchAndBoundRegistration2D<PointSource, PointTarget>::scoreCandidate(const LikelihoodGrid& grid, const std::vector<Eigen::Array2i>& discrete_scan, int x_offset, int y_offset) {
+	if (discrete_scan.empty()) { return 0.0f; }
+	size_t score = 0;
+	for (size_t i = 0; i < discrete_scan.size(); ++i) {
+		score += grid.getCell(discrete_scan[i](0) + x_offset, discrete_scan[i](1) + y_offset);
+	}
+	return (float)score / (255.0f * (float)discrete_scan.size());
+}
+
+
+template <typename PointSource, typename PointTarget>
+void BranchAndBoundRegistration2D<PointSource, PointTarget>::searchCandidates(const std::vector< std::vector<Eigen::Array2i> >& discrete_scans, std::vector<Candidate>& candidates, int depth,
+		Candidate& best_candidate, PerformanceTimer& timer) {
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		const Candidate& candidate = candidates[i];
+		if (candidate.score <= best_candidate.score) { return; } // candidates are sorted and their score is an upper bound of the score of their children
+
+		if (convergence_time_limit_seconds_ > 0.0 && (convergence_time_limit_reached_ || timer.getElapsedTimeInSec() > convergence_time_limit_seconds_)) {
+			convergence_time_limit_reached_ = true;
+			return;
+		}
+
+		if (depth == 0) {
+			best_candidate = candidate;
+			return;
+		}
+
+		int child_depth = depth - 1;
+		int child_step = 1 << child_depth;
+		const LikelihoodGrid& child_grid = likelihood_grids_[child_depth];
+		std::vector<Candidate> child_candidates;
+		child_candidates.reserve(4);
+		for (int x = 0; x < 2; ++x) {
+			for (int y = 0; y < 2; ++y) {
+				Candidate child_candidate;
+				child_candidate.angle_index = candidate.angle_index;
+				child_candidate.x_offset = candidate.x_offset + x * child_step;
+				child_candidate.y_offset = candidate.y_offset + y * child_step;
+				child_candidate.score = scoreCandidate(child_grid, discrete_scans[candidate.angle_index], child_candidate.x_offset, child_candidate.y_offset);
+				child_candidates.push_back(child_candidate);
+			}
+		}
+		pcl::Registration<PointSource, PointTarget, float>::nr_iterations_ += 4;
+		std::sort(child_candidates.begin(), child_candidates.end(), std::greater<Candidate>());
+		searchCandidates(discrete_scans, child_candidates, child_depth, best_candidate, timer);
+	}
+}
+
+
+
+// ##########################################################################   BranchAndBound2D   ############################################################################
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <BranchAndBound2D-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void BranchAndBound2D<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace) {
+	typename pcl::Registration<PointT, PointT, float>::Ptr matcher_base(new BranchAndBoundRegistration2D<PointT, PointT>());
+	typename BranchAndBoundRegistration2D<PointT, PointT>::Ptr matcher = boost::static_pointer_cast< BranchAndBoundRegistration2D<PointT, PointT> >(matcher_base);
+
+	double grid_resolution, likelihood_sigma;
+	private_node_handle->param(configuration_namespace + "grid_resolution", grid_resolution, 0.05);
+	private_node_handle->param(configuration_namespace + "likelihood_sigma", likelihood_sigma, 0.05);
+	matcher->setGridResolution(grid_resolution);
+	matcher->setLikelihoodSigma(likelihood_sigma);
+
+	int number_of_precomputed_grids;
+	private_node_handle->param(configuration_namespace + "number_of_precomputed_grids", number_of_precomputed_grids, 7);
+	matcher->setNumberOfPrecomputedGrids(number_of_precomputed_grids);
+
+	double linear_search_window, angular_search_window, angular_step;
+	private_node_handle->param(configuration_namespace + "linear_search_window", linear_search_window, -1.0);
+	private_node_handle->param(configuration_namespace + "angular_search_window", angular_search_window, M_PI);
+	private_node_handle->param(configuration_namespace + "angular_step", angular_step, -1.0);
+	matcher->setLinearSearchWindow(linear_search_window);
+	matcher->setAngularSearchWindow(angular_search_window);
+	matcher->setAngularStep(angular_step);
+
+	double minimum_score, convergence_time_limit_seconds;
+	private_node_handle->param(configuration_namespace + "minimum_score", minimum_score, 0.5);
+	private_node_handle->param(configuration_namespace + "convergence_time_limit_seconds", convergence_time_limit_seconds, -1.0);
+	matcher->setMinimumScore(minimum_score);
+	matcher->setConvergenceTimeLimitSeconds(convergence_time_limit_seconds);
+
+	CloudMatcher<PointT>::setCloudMatcher(matcher_base);
+	CloudMatcher<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+}
+
+
+template<typename PointT>
+int BranchAndBound2D<PointT>::getNumberOfRegistrationIterations() {
+	typename BranchAndBoundRegistration2D<PointT, PointT>::Ptr matcher = boost::dynamic_pointer_cast< BranchAndBoundRegistration2D<PointT, PointT> >(CloudMatcher<PointT>::cloud_matcher_);
+	if (matcher) { return matcher->getNumberOfRegistrationIterations(); }
+	return -1;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </BranchAndBound2D-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
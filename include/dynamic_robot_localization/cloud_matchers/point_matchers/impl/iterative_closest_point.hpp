@@ -57,18 +57,76 @@ void IterativeClosestPoint<PointT>::setupConfigurationFromParameterServer(ros::N
 	  matcher->setTransformationRotationEpsilon(convergence_rotation_threshold_);
 
 	CloudMatcher<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+	setupMultiResolutionLevelsFromParameterServer(private_node_handle, configuration_namespace);
+}
+
+
+template<typename PointT>
+void IterativeClosestPoint<PointT>::setupMultiResolutionLevelsFromParameterServer(ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
+	multi_resolution_levels_.clear();
+	multi_resolution_levels_reference_cloud_.reset();
+	private_node_handle->param(configuration_namespace + "multi_resolution_levels_rebuild_ratio_of_new_points", multi_resolution_levels_rebuild_ratio_of_new_points_, 0.1);
+	std::string multi_resolution_levels_namespace = configuration_namespace + "multi_resolution_levels/";
+	XmlRpc::XmlRpcValue levels;
+	if (!CloudMatcher<PointT>::cloud_matcher_ || !private_node_handle->getParam(multi_resolution_levels_namespace, levels) || levels.getType() != XmlRpc::XmlRpcValue::TypeStruct) {
+		return;
+	}
+
+	typename pcl::IterativeClosestPoint<PointT, PointT, float>::Ptr matcher = boost::dynamic_pointer_cast< typename pcl::IterativeClosestPoint<PointT, PointT, float> >(CloudMatcher<PointT>::cloud_matcher_);
+	for (XmlRpc::XmlRpcValue::iterator it = levels.begin(); it != levels.end(); ++it) {
+		std::string level_namespace = multi_resolution_levels_namespace + it->first + "/";
+		MultiResolutionLevel level;
+		level.name = it->first;
+		double max_correspondence_distance;
+		int max_number_of_registration_iterations;
+		private_node_handle->param(level_namespace + "voxel_grid_leaf_size", level.voxel_grid_leaf_size, 0.1);
+		private_node_handle->param(level_namespace + "max_correspondence_distance", max_correspondence_distance, 1.0);
+		private_node_handle->param(level_namespace + "max_number_of_registration_iterations", max_number_of_registration_iterations, 10);
+		if (level.voxel_grid_leaf_size <= 0.0 || max_number_of_registration_iterations <= 0) {
+			continue;
+		}
+
+		level.matcher.reset(new IterativeClosestPointTimeConstrained<PointT, PointT, float>());
+		level.matcher->setMaxCorrespondenceDistance(max_correspondence_distance);
+		level.matcher->setMaximumIterations(max_number_of_registration_iterations);
+		level.matcher->setTransformationEpsilon(CloudMatcher<PointT>::cloud_matcher_->getTransformationEpsilon());
+		level.matcher->setEuclideanFitnessEpsilon(CloudMatcher<PointT>::cloud_matcher_->getEuclideanFitnessEpsilon());
+		if (matcher) { level.matcher->setUseReciprocalCorrespondences(matcher->getUseReciprocalCorrespondences()); }
+		if (CloudMatcher<PointT>::transformation_estimation_ptr_) { level.matcher->setTransformationEstimation(CloudMatcher<PointT>::transformation_estimation_ptr_); }
+		multi_resolution_levels_.push_back(level);
+
+		ROS_DEBUG_STREAM("Added multi resolution level " << level.name << " to " << CloudMatcher<PointT>::cloud_matcher_->getClassName() << " with a voxel grid leaf size of " << level.voxel_grid_leaf_size
+				<< ", a max correspondence distance of " << max_correspondence_distance << " and a max number of registration iterations of " << max_number_of_registration_iterations);
+	}
+}
+
+
+template<typename PointT>
+void IterativeClosestPoint<PointT>::setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+		typename pcl::search::KdTree<PointT>::Ptr& search_method) {
+	CloudMatcher<PointT>::setupReferenceCloud(reference_cloud, reference_cloud_keypoints, search_method);
+	reference_cloud_ = reference_cloud; // the multi resolution levels are only voxelized in the next registration (and only if the reference cloud changed enough)
 }
 
 
 template<typename PointT>
 bool IterativeClosestPoint<PointT>::registerCloud(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, typename pcl::search::KdTree<PointT>::Ptr& ambient_pointcloud_search_method, typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
 		tf2::Transform& best_pose_correction_out, std::vector<tf2::Transform>& accepted_pose_corrections_out, typename pcl::PointCloud<PointT>::Ptr& pointcloud_registered_out, bool return_aligned_keypoints) {
+	Eigen::Matrix4f multi_resolution_pose_correction = Eigen::Matrix4f::Identity();
+	if (!multi_resolution_levels_.empty() && !CloudMatcher<PointT>::match_only_keypoints_) {
+		alignMultiResolutionLevels(ambient_pointcloud, multi_resolution_pose_correction);
+	}
+
 	typename DefaultConvergenceCriteriaWithTime<float>::Ptr convergence_criteria = getConvergenceCriteria();
 	if (convergence_criteria) {
-		convergence_criteria->resetConvergenceTimer();
+		convergence_criteria->resetConvergenceTimer(); // the time of the multi resolution levels is not included in the time limit of the full resolution registration
 	}
 
-	if (CloudMatcher<PointT>::registerCloud(ambient_pointcloud, ambient_pointcloud_search_method, pointcloud_keypoints, best_pose_correction_out, accepted_pose_corrections_out, pointcloud_registered_out, return_aligned_keypoints)) {
+	CloudMatcher<PointT>::setRegistrationInitialGuess(multi_resolution_pose_correction);
+	bool registration_successful = CloudMatcher<PointT>::registerCloud(ambient_pointcloud, ambient_pointcloud_search_method, pointcloud_keypoints, best_pose_correction_out, accepted_pose_corrections_out, pointcloud_registered_out, return_aligned_keypoints);
+	CloudMatcher<PointT>::setRegistrationInitialGuess(Eigen::Matrix4f::Identity());
+
+	if (registration_successful) {
 		cumulative_sum_of_convergence_time_ += convergence_criteria->getConvergenceElaspedTime();
 		++number_of_convergence_time_measurements;
 
@@ -156,6 +214,101 @@ void IterativeClosestPoint<PointT>::resetTransformCloudElapsedTime() {
 	typename IterativeClosestPointTimeConstrained<PointT, PointT>::Ptr matcher = boost::dynamic_pointer_cast< IterativeClosestPointTimeConstrained<PointT, PointT> >(CloudMatcher<PointT>::cloud_matcher_);
 	if (matcher) { matcher->resetTransformCloudElapsedTime(); }
 }
+
+
+template<typename PointT>
+bool IterativeClosestPoint<PointT>::alignMultiResolutionLevels(const typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, Eigen::Matrix4f& pose_correction_out) {
+	DRL_TRACE_SCOPE("multi_resolution_registration");
+	bool pose_correction_updated = false;
+	pcl::PointCloud<PointT> level_registered_cloud;
+	updateMultiResolutionLevelsReferenceClouds();
+
+	for (size_t i = 0; i < multi_resolution_levels_.size(); ++i) {
+		MultiResolutionLevel& level = multi_resolution_levels_[i];
+		if (!level.matcher->getInputTarget() || level.matcher->getInputTarget()->size() < 3) { continue; }
+
+		typename pcl::PointCloud<PointT>::Ptr level_ambient_pointcloud(new pcl::PointCloud<PointT>());
+		downsamplePointCloud(ambient_pointcloud, *level_ambient_pointcloud, level.voxel_grid_leaf_size);
+		if (level_ambient_pointcloud->size() < 3) { continue; }
+
+		typename pcl::search::KdTree<PointT>::Ptr level_ambient_pointcloud_search_method(new pcl::search::KdTree<PointT>());
+		level_ambient_pointcloud_search_method->setInputCloud(level_ambient_pointcloud);
+		level.matcher->setInputSource(level_ambient_pointcloud);
+		level.matcher->setSearchMethodSource(level_ambient_pointcloud_search_method, true);
+		typename DefaultConvergenceCriteriaWithTime<float>::Ptr level_convergence_criteria = boost::dynamic_pointer_cast< DefaultConvergenceCriteriaWithTime<float> >(level.matcher->getConvergeCriteria());
+		if (level_convergence_criteria) { level_convergence_criteria->resetConvergenceTimer(); }
+		level.matcher->align(level_registered_cloud, pose_correction_out);
+
+		Eigen::Matrix4f level_pose_correction = level.matcher->getFinalTransformation();
+		if (level.matcher->hasConverged() && pcl_isfinite(level_pose_correction.sum())) {
+			pose_correction_out = level_pose_correction;
+			pose_correction_updated = true;
+			ROS_DEBUG_STREAM("Multi resolution level " << level.name << " registered " << level_ambient_pointcloud->size() << " points in "
+					<< (level_convergence_criteria ? level_convergence_criteria->getNumberOfRegistrationIterations() : -1) << " iterations");
+		} else {
+			ROS_DEBUG_STREAM("Multi resolution level " << level.name << " failed to register " << level_ambient_pointcloud->size() << " points (keeping the pose correction of the previous level)");
+		}
+	}
+
+	return pose_correction_updated;
+}
+
+
+template<typename PointT>
+void IterativeClosestPoint<PointT>::updateMultiResolutionLevelsReferenceClouds() {
+	if (!reference_cloud_) { return; }
+
+	// the reference cloud is only appended in incremental map updates, so the coarse levels can miss a small ratio of the newest points
+	const PointT* reference_cloud_points_data = reference_cloud_->points.empty() ? NULL : &reference_cloud_->points[0];
+	size_t reference_cloud_size = reference_cloud_->size();
+	if (multi_resolution_levels_reference_cloud_ == reference_cloud_
+			&& multi_resolution_levels_reference_cloud_points_data_ == reference_cloud_points_data
+			&& reference_cloud_size >= multi_resolution_levels_reference_cloud_size_
+			&& (double)(reference_cloud_size - multi_resolution_levels_reference_cloud_size_) <= multi_resolution_levels_rebuild_ratio_of_new_points_ * (double)multi_resolution_levels_reference_cloud_size_) {
+		return;
+	}
+
+	for (size_t i = 0; i < multi_resolution_levels_.size(); ++i) {
+		typename pcl::PointCloud<PointT>::Ptr level_reference_cloud(new pcl::PointCloud<PointT>());
+		downsamplePointCloud(reference_cloud_, *level_reference_cloud, multi_resolution_levels_[i].voxel_grid_leaf_size);
+		typename pcl::search::KdTree<PointT>::Ptr level_search_method(new pcl::search::KdTree<PointT>());
+		level_search_method->setInputCloud(level_reference_cloud);
+		multi_resolution_levels_[i].matcher->setInputTarget(level_reference_cloud);
+		multi_resolution_levels_[i].matcher->setSearchMethodTarget(level_search_method, true);
+		ROS_DEBUG_STREAM("Multi resolution level " << multi_resolution_levels_[i].name << " has a reference cloud with " << level_reference_cloud->size() << " points (full resolution has " << reference_cloud_size << " points)");
+	}
+
+	multi_resolution_levels_reference_cloud_ = reference_cloud_;
+	multi_resolution_levels_reference_cloud_points_data_ = reference_cloud_points_data;
+	multi_resolution_levels_reference_cloud_size_ = reference_cloud_size;
+}
+
+
+template<typename PointT>
+void IterativeClosestPoint<PointT>::downsamplePointCloud(const typename pcl::PointCloud<PointT>::Ptr& pointcloud, typename pcl::PointCloud<PointT>& pointcloud_downsampled_out, double voxel_grid_leaf_size) {
+	pcl::VoxelGrid<PointT> voxel_grid;
+	voxel_grid.setLeafSize(voxel_grid_leaf_size, voxel_grid_leaf_size, voxel_grid_leaf_size);
+	voxel_grid.setDownsampleAllData(true);
+	voxel_grid.setInputCloud(pointcloud);
+	voxel_grid.filter(pointcloud_downsampled_out);
+
+	// the averaged normals must be normalized again (and the voxels with normals that cancelled each other are discarded)
+	size_t number_of_valid_points = 0;
+	for (size_t i = 0; i < pointcloud_downsampled_out.size(); ++i) {
+		PointT& point = pointcloud_downsampled_out.points[i];
+		float normal_norm = std::sqrt(point.normal_x * point.normal_x + point.normal_y * point.normal_y + point.normal_z * point.normal_z);
+		if (pcl_isfinite(normal_norm) && normal_norm > 1e-3f) {
+			point.normal_x /= normal_norm;
+			point.normal_y /= normal_norm;
+			point.normal_z /= normal_norm;
+			pointcloud_downsampled_out.points[number_of_valid_points++] = point;
+		}
+	}
+	pointcloud_downsampled_out.points.resize(number_of_valid_points);
+	pointcloud_downsampled_out.width = number_of_valid_points;
+	pointcloud_downsampled_out.height = 1;
+	pointcloud_downsampled_out.is_dense = true;
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IterativeClosestPoint-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
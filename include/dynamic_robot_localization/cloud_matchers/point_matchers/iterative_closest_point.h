@@ -12,14 +12,17 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <cmath>
 #include <string>
 #include <limits>
 #include <algorithm>
+#include <vector>
 
 // ROS includes
 
 // PCL includes
 #include <pcl/registration/icp.h>
+#include <pcl/filters/voxel_grid.h>
 
 // external libs includes
 #include <boost/smart_ptr/shared_ptr.hpp>
@@ -90,12 +93,16 @@ class IterativeClosestPoint : public CloudMatcher<PointT> {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constants>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		IterativeClosestPoint() : cumulative_sum_of_convergence_time_(0.0), number_of_convergence_time_measurements(0) { }
+		IterativeClosestPoint() : cumulative_sum_of_convergence_time_(0.0), number_of_convergence_time_measurements(0),
+			multi_resolution_levels_rebuild_ratio_of_new_points_(0.1), multi_resolution_levels_reference_cloud_points_data_(NULL), multi_resolution_levels_reference_cloud_size_(0) { }
 		virtual ~IterativeClosestPoint() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IterativeClosestPoint-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace = "");
+		void setupMultiResolutionLevelsFromParameterServer(ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		virtual void setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+				typename pcl::search::KdTree<PointT>::Ptr& search_method);
 		virtual bool registerCloud(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
 						typename pcl::search::KdTree<PointT>::Ptr& ambient_pointcloud_search_method,
 						typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
@@ -107,6 +114,13 @@ class IterativeClosestPoint : public CloudMatcher<PointT> {
 		virtual std::string getMatcherConvergenceState();
 		virtual double getTransformCloudElapsedTimeMS();
 		virtual void resetTransformCloudElapsedTime();
+
+		/** \brief Aligns the voxelized ambient cloud with the voxelized reference cloud of each multi resolution level (from the coarsest to the finest), using the result of each level as initial guess of the next one */
+		bool alignMultiResolutionLevels(const typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, Eigen::Matrix4f& pose_correction_out);
+
+		/** \brief Voxelizes the reference cloud of each multi resolution level if the reference cloud was replaced or grew more than the configured ratio since the last update */
+		void updateMultiResolutionLevelsReferenceClouds();
+		static void downsamplePointCloud(const typename pcl::PointCloud<PointT>::Ptr& pointcloud, typename pcl::PointCloud<PointT>& pointcloud_downsampled_out, double voxel_grid_leaf_size);
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IterativeClosestPoint-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -118,6 +132,12 @@ class IterativeClosestPoint : public CloudMatcher<PointT> {
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
+		struct MultiResolutionLevel {
+			std::string name;
+			double voxel_grid_leaf_size;
+			typename IterativeClosestPointTimeConstrained<PointT, PointT, float>::Ptr matcher; // each level has its own target and search tree, to avoid rebuilding them in every registration
+		};
+
 		double convergence_absolute_mse_threshold_;
 		double convergence_rotation_threshold_;
 		int convergence_max_iterations_similar_transforms_;
@@ -126,6 +146,12 @@ class IterativeClosestPoint : public CloudMatcher<PointT> {
 		size_t number_of_convergence_time_measurements;
 		double convergence_time_limit_seconds_as_mean_convergence_time_percentage_;
 		int minimum_number_of_convergence_time_measurements_to_adjust_convergence_time_limit_;
+		std::vector<MultiResolutionLevel> multi_resolution_levels_;
+		double multi_resolution_levels_rebuild_ratio_of_new_points_;
+		typename pcl::PointCloud<PointT>::Ptr reference_cloud_;
+		typename pcl::PointCloud<PointT>::Ptr multi_resolution_levels_reference_cloud_;
+		const PointT* multi_resolution_levels_reference_cloud_points_data_;
+		size_t multi_resolution_levels_reference_cloud_size_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
@@ -12,7 +12,9 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <algorithm>
 #include <iterator>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -32,7 +34,9 @@
 namespace dynamic_robot_localization {
 // ########################################################################   CircularBufferPointCloud   #######################################################################
 /**
- * \brief Description...
+ * \brief Circular buffer that stores the points in a pcl::PointCloud, keeping track of the oldest element position and the number of valid elements.
+ * Inserting and erasing only updates the slots involved, and the point cloud is only linearized (when there are erased slots inside the buffer) when a consumer requests it.
+ * When all the slots are valid, the point cloud is given as is (with the points in buffer order instead of insertion order).
  */
 template <typename PointT>
 class CircularBufferPointCloud {
@@ -60,47 +64,66 @@ class CircularBufferPointCloud {
 		void insert(typename pcl::PointCloud<PointT>::const_iterator first, typename pcl::PointCloud<PointT>::const_iterator last);
 		bool insertWithSwappping(pcl::PointCloud<PointT>& new_elements);
 		bool insertWithSwappping(typename pcl::PointCloud<PointT>::iterator first, typename pcl::PointCloud<PointT>::iterator last);
+
+		/** \brief Inserts in the empty slots of the buffer and then replaces the elements older than the ones inserted (going backwards). */
 		void insertReverse(const PointT& new_element);
 		void insertReverse(const pcl::PointCloud<PointT>& new_elements);
 		void insertReverse(typename pcl::PointCloud<PointT>::const_iterator first, typename pcl::PointCloud<PointT>::const_iterator last);
 		void eraseNewest(size_t count = 1);
 		void eraseOldest(size_t count = 1);
 
-		typename pcl::PointCloud<PointT>::iterator begin() { return pointcloud_->begin(); }
-		typename pcl::PointCloud<PointT>::const_iterator begin() const { return pointcloud_->begin(); }
-		typename pcl::PointCloud<PointT>::iterator end() { return pointcloud_->end(); }
-		typename pcl::PointCloud<PointT>::const_iterator end() const { return pointcloud_->end(); }
-		PointT& operator[](size_t element_index) { return (*pointcloud_)[element_index]; }
-		const PointT& operator[](size_t element_index) const { return (*pointcloud_)[element_index]; }
-		PointT& at(size_t element_index) { return pointcloud_->at(element_index); }
-		const PointT& at(size_t element_index) const { return pointcloud_->at(element_index); }
-		PointT& front(size_t element_index) { return pointcloud_->front(); }
-		const PointT& front(size_t element_index) const  { return pointcloud_->front(); }
-		PointT& back(size_t element_index) { return pointcloud_->back(); }
-		const PointT& back(size_t element_index) const { return pointcloud_->back(); }
-
-		bool empty()  { return pointcloud_->empty(); }
-		size_t size() { return pointcloud_->size(); }
-		void resize(size_t number_elements) { pointcloud_->resize(number_elements); max_buffer_size_ = number_elements; }
-		void reserve(size_t number_elements) { if (pointcloud_->size() < number_elements) { pointcloud_->reserve(number_elements); max_buffer_size_ = number_elements; } }
-		void clear() { pointcloud_->clear(); }
+		/** \brief Moves the valid elements to the beginning of the point cloud and drops the erased slots (only has work to do after erasing elements or changing the buffer size). */
+		void linearize();
+
+		typename pcl::PointCloud<PointT>::iterator begin() { linearize(); return pointcloud_->begin(); }
+		typename pcl::PointCloud<PointT>::iterator end() { linearize(); return pointcloud_->end(); }
+
+		/** \brief Access elements in insertion order (0 is the oldest element). */
+		PointT& operator[](size_t element_index) { return (*pointcloud_)[getBufferPosition(element_index)]; }
+		const PointT& operator[](size_t element_index) const { return (*pointcloud_)[getBufferPosition(element_index)]; }
+		PointT& at(size_t element_index) { checkElementIndex(element_index); return (*this)[element_index]; }
+		const PointT& at(size_t element_index) const { checkElementIndex(element_index); return (*this)[element_index]; }
+		PointT& front() { return (*this)[0]; }
+		const PointT& front() const  { return (*this)[0]; }
+		PointT& back() { return (*this)[number_elements_ - 1]; }
+		const PointT& back() const { return (*this)[number_elements_ - 1]; }
+
+		bool empty() const { return number_elements_ == 0; }
+		size_t size() const { return number_elements_; }
+		void resize(size_t number_elements);
+		void reserve(size_t number_elements);
+		void clear() { pointcloud_->clear(); oldest_element_position_ = 0; number_elements_ = 0; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </CircularBufferPointCloud-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		typename pcl::PointCloud<PointT>::Ptr getPointCloud() const { return pointcloud_; }
+		/** \brief Point cloud with the valid elements (linearized only if there are erased slots inside the buffer). */
+		typename pcl::PointCloud<PointT>::Ptr getPointCloud() { linearize(); return pointcloud_; }
 		size_t getMaxBufferSize() const { return max_buffer_size_; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		void setMaxBufferSize(size_t max_buffer_size) { max_buffer_size_ = max_buffer_size; }
+		void setMaxBufferSize(size_t max_buffer_size);
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 	// ========================================================================   </public-section>  ===========================================================================
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
-		size_t fillBuffer(size_t number_elements_to_insert, typename pcl::PointCloud<PointT>::const_iterator first);
+		inline size_t getBufferPosition(size_t element_index) const {
+			size_t buffer_position = oldest_element_position_ + element_index;
+			return (buffer_position >= max_buffer_size_) ? buffer_position - max_buffer_size_ : buffer_position;
+		}
+
+		inline void checkElementIndex(size_t element_index) const {
+			if (element_index >= number_elements_) { throw std::out_of_range("CircularBufferPointCloud element index out of range"); }
+		}
+
+		/** \brief Sorts the buffer in insertion order and drops the erased slots (required before changing the buffer size). */
+		void moveOldestElementToBeginning();
+		size_t reserveInsertionSlots(size_t number_elements_to_insert, size_t& insert_position_out);
+
 		typename pcl::PointCloud<PointT>::Ptr pointcloud_;
-		size_t next_insert_position_;
+		size_t oldest_element_position_;
+		size_t number_elements_;
 		size_t max_buffer_size_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
@@ -109,6 +132,6 @@ class CircularBufferPointCloud {
 
 
 #ifdef DRL_NO_PRECOMPILE
-#include <dynamic_robot_localization/commom/impl/circular_buffer_pointcloud.hpp>
+#include <dynamic_robot_localization/common/impl/circular_buffer_pointcloud.hpp>
 #endif
 
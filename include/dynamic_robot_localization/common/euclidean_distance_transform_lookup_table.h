@@ -0,0 +1,175 @@
+#pragma once
+
+/**\file euclidean_distance_transform_lookup_table.h
+ * \brief Voxel grid with the index of the closest reference point of each cell, computed with the Euclidean distance transform and persisted in a memory mapped file.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// ROS includes
+#include <ros/ros.h>
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/common/common.h>
+
+// external libs includes
+#include <boost/cstdint.hpp>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <Eigen/Core>
+#include <omp.h>
+
+// project includes
+#include <dynamic_robot_localization/common/hash_utils.h>
+#include <dynamic_robot_localization/common/memory_mapped_file.h>
+#include <dynamic_robot_localization/common/performance_timer.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// #################################################################   EuclideanDistanceTransformLookupTable   ##################################################################
+/**
+ * \brief Lookup table with the index of the closest reference point for each cell of a voxel grid that covers the reference cloud (plus a margin).
+ * The table is computed in linear time with the separable Euclidean distance transform (Felzenszwalb and Huttenlocher), propagating the index of the closest point along with the distance.
+ * If a filename is given, the table is saved after a header with the hash of the reference cloud and of the grid configuration, and it is memory mapped when loading
+ * (a table is only reused if it was computed for the same reference cloud, resolution and margins).
+ * When points are appended to the reference cloud (incremental map update), only the cells around the new points are updated, directly in the memory mapped file.
+ */
+template <typename PointT>
+class EuclideanDistanceTransformLookupTable {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <typedefs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		typedef boost::shared_ptr< EuclideanDistanceTransformLookupTable<PointT> > Ptr;
+		typedef boost::shared_ptr< const EuclideanDistanceTransformLookupTable<PointT> > ConstPtr;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </typedefs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constants>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		static const boost::uint32_t LOOKUP_TABLE_FORMAT_VERSION = 1;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constants>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		EuclideanDistanceTransformLookupTable();
+		virtual ~EuclideanDistanceTransformLookupTable() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <EuclideanDistanceTransformLookupTable-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		/** \brief Loads or computes the table for the reference cloud. If the same cloud only received new points since the last call, the table is updated around them. */
+		bool setupReferenceCloud(const typename pcl::PointCloud<PointT>::ConstPtr& reference_cloud);
+
+		/** \brief Returns the index of the closest reference point or -1 if the point is outside the table (or the table is empty). */
+		inline int getClosestPointIndex(float x, float y, float z) const {
+			if (cells_ == NULL) { return -1; }
+			long cell_x = (long)std::floor((x - minimum_bounds_(0)) * cell_resolution_inverse_);
+			long cell_y = (long)std::floor((y - minimum_bounds_(1)) * cell_resolution_inverse_);
+			long cell_z = (long)std::floor((z - minimum_bounds_(2)) * cell_resolution_inverse_);
+			if (cell_x < 0 || cell_y < 0 || cell_z < 0 || cell_x >= (long)number_of_cells_[0] || cell_y >= (long)number_of_cells_[1] || cell_z >= (long)number_of_cells_[2]) { return -1; }
+			return cells_[computeCellIndex((size_t)cell_x, (size_t)cell_y, (size_t)cell_z)];
+		}
+
+		inline bool isInsideLookupTable(float x, float y, float z) const {
+			return cells_ != NULL && x >= minimum_bounds_(0) && y >= minimum_bounds_(1) && z >= minimum_bounds_(2) && x < maximum_bounds_(0) && y < maximum_bounds_(1) && z < maximum_bounds_(2);
+		}
+
+		void clear();
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </EuclideanDistanceTransformLookupTable-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline double getCellResolution() const { return cell_resolution_; }
+		inline const Eigen::Vector3f& getLookupTableMargin() const { return lookup_table_margin_; }
+		inline const std::string& getFilename() const { return filename_; }
+		inline double getIncrementalUpdateRadius() const { return incremental_update_radius_; }
+		inline size_t getNumberOfCells() const { return number_of_cells_[0] * number_of_cells_[1] * number_of_cells_[2]; }
+		inline const typename pcl::PointCloud<PointT>::ConstPtr& getReferenceCloud() const { return reference_cloud_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline void setCellResolution(double cell_resolution) { cell_resolution_ = cell_resolution; }
+		inline void setLookupTableMargin(const Eigen::Vector3f& lookup_table_margin) { lookup_table_margin_ = lookup_table_margin; }
+		inline void setFilename(const std::string& filename) { filename_ = filename; }
+		inline void setIncrementalUpdateRadius(double incremental_update_radius) { incremental_update_radius_ = incremental_update_radius; }
+		inline void setMaximumNumberOfCells(size_t maximum_number_of_cells) { maximum_number_of_cells_ = maximum_number_of_cells; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		struct LookupTableHeader {
+			char magic[8];
+			boost::uint32_t format_version;
+			boost::uint32_t cell_size;
+			boost::uint64_t reference_cloud_hash;
+			boost::uint64_t configuration_hash;
+			boost::uint64_t number_of_reference_points;
+			boost::uint64_t number_of_cells[3];
+			float minimum_bounds[4];
+			boost::uint64_t data_offset;
+		};
+
+		static const size_t LOOKUP_TABLE_DATA_ALIGNMENT = 64;
+		static const size_t NUMBER_OF_REFERENCE_CLOUD_SAMPLES = 64;
+
+		inline size_t computeCellIndex(size_t cell_x, size_t cell_y, size_t cell_z) const { return (cell_z * number_of_cells_[1] + cell_y) * number_of_cells_[0] + cell_x; }
+		inline Eigen::Vector3f computeCellCenter(size_t cell_x, size_t cell_y, size_t cell_z) const {
+			return minimum_bounds_ + Eigen::Vector3f((float)cell_x + 0.5f, (float)cell_y + 0.5f, (float)cell_z + 0.5f) * (float)cell_resolution_;
+		}
+
+		static boost::uint64_t computeReferenceCloudHash(const pcl::PointCloud<PointT>& reference_cloud, size_t first_point_index, size_t last_point_index, boost::uint64_t hash = hash_utils::HASH_INITIAL_VALUE);
+		/** \brief Hash of NUMBER_OF_REFERENCE_CLOUD_SAMPLES points evenly spaced in [0, number_of_points[, for checking in constant time that the points used to compute the table were kept. */
+		static boost::uint64_t computeReferenceCloudSamplesHash(const pcl::PointCloud<PointT>& reference_cloud, size_t number_of_points);
+		boost::uint64_t computeConfigurationHash() const;
+		bool computeLookupTableBounds(const pcl::PointCloud<PointT>& reference_cloud);
+		void computeEuclideanDistanceTransform(const pcl::PointCloud<PointT>& reference_cloud, boost::int32_t* cells);
+		static void computeDistanceTransform1D(const float* distances, const boost::int32_t* indices, size_t number_of_samples,
+				float* distances_out, boost::int32_t* indices_out, std::vector<size_t>& parabolas_vertices, std::vector<double>& parabolas_boundaries);
+		bool updateLookupTableWithNewPoints(const pcl::PointCloud<PointT>& reference_cloud, size_t first_new_point_index);
+		void fillHeader(LookupTableHeader& header) const;
+		bool loadFromFile();
+		bool saveToFile(const boost::int32_t* cells) const;
+		bool updateFileHeader();
+		bool invalidateFileHeader();
+
+		double cell_resolution_;
+		float cell_resolution_inverse_;
+		Eigen::Vector3f lookup_table_margin_;
+		Eigen::Vector3f minimum_bounds_;
+		Eigen::Vector3f maximum_bounds_;
+		size_t number_of_cells_[3];
+		size_t maximum_number_of_cells_;
+		std::string filename_;
+		double incremental_update_radius_;
+
+		typename pcl::PointCloud<PointT>::ConstPtr reference_cloud_;
+		size_t number_of_reference_points_;
+		boost::uint64_t reference_cloud_hash_;
+		boost::uint64_t reference_cloud_samples_hash_;
+
+		boost::int32_t* cells_;  // points to cells_memory_ or to the memory mapped file
+		std::vector<boost::int32_t> cells_memory_;
+		boost::shared_ptr<MemoryMappedFile> lookup_table_file_;
+
+	public:
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/common/impl/euclidean_distance_transform_lookup_table.hpp>
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+/**\file hash_utils.h
+ * \brief Fast non cryptographic hashing (64 bit FNV-1a over words) used to validate the binary caches against their source files and configurations.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <cstddef>
+#include <string>
+
+// ROS includes
+
+// PCL includes
+
+// external libs includes
+#include <boost/cstdint.hpp>
+
+// project includes
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// ###############################################################################   hash_utils   ##############################################################################
+namespace hash_utils {
+
+const boost::uint64_t HASH_INITIAL_VALUE = 0xcbf29ce484222325ULL;
+
+boost::uint64_t computeHash(const void* data, size_t number_of_bytes, boost::uint64_t hash = HASH_INITIAL_VALUE);
+boost::uint64_t computeHash(const std::string& data, boost::uint64_t hash = HASH_INITIAL_VALUE);
+bool computeFileHash(const std::string& filename, boost::uint64_t& hash_out);
+
+} /* namespace hash_utils */
+} /* namespace dynamic_robot_localization */
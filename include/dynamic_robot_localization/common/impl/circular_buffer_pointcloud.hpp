@@ -17,63 +17,25 @@ namespace dynamic_robot_localization {
 // =============================================================================  <public-section>  ============================================================================
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 template<typename PointT>
-CircularBufferPointCloud<PointT>::CircularBufferPointCloud(size_t max_buffer_size, typename pcl::PointCloud<PointT>::Ptr pointcloud) : pointcloud_(pointcloud), max_buffer_size_(max_buffer_size) {
+CircularBufferPointCloud<PointT>::CircularBufferPointCloud(size_t max_buffer_size, typename pcl::PointCloud<PointT>::Ptr pointcloud) :
+		pointcloud_(pointcloud), oldest_element_position_(0), number_elements_(0), max_buffer_size_(max_buffer_size) {
 	if (pointcloud_->size() > max_buffer_size) {
 		pointcloud_->resize(max_buffer_size_);
 	}
 
-	if (pointcloud_->size() == max_buffer_size) {
-		next_insert_position_ = 0;
-	} else {
-		next_insert_position_ = pointcloud->size();
-	}
+	number_elements_ = pointcloud_->size();
 }
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <CircularBufferPointCloud-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-template<typename PointT>
-size_t CircularBufferPointCloud<PointT>::fillBuffer(size_t number_elements_to_insert, typename pcl::PointCloud<PointT>::const_iterator first) {
-	if (number_elements_to_insert == 0) { return 0; }
-
-	if (pointcloud_->size() < max_buffer_size_) { // filling the buffer
-		size_t remaining_empty_slots_buffer = max_buffer_size_ - pointcloud_->size();
-		size_t number_elements_inserted = std::min(number_elements_to_insert, remaining_empty_slots_buffer);
-
-		if (next_insert_position_ == pointcloud_->size()) { 									// filling the buffer at the end
-			pointcloud_->insert(pointcloud_->end(), first, first + number_elements_inserted);
-		} else {																				// inserting elements (happens if vector size was modified)
-			pointcloud_->insert(pointcloud_->begin() + next_insert_position_, first, first + number_elements_inserted);
-		}
-
-		next_insert_position_ += number_elements_inserted;
-
-		if (number_elements_inserted < number_elements_to_insert) {
-			number_elements_to_insert -= number_elements_inserted;
-		} else {
-			return 0;
-		}
-	}
-
-	return number_elements_to_insert; // remaining elements to insert
-}
-
-
 template<typename PointT>
 void CircularBufferPointCloud<PointT>::insert(const PointT& new_element) {
-	if (pointcloud_->size() < max_buffer_size_) {
-		if (next_insert_position_ == pointcloud_->size()) {
-			pointcloud_->push_back(new_element); 												// filling the buffer at the end
-		} else {
-			pointcloud_->insert(pointcloud_->begin() + next_insert_position_, new_element); 	// inserting elements (happens if vector size was modified)
-		}
-	} else {
-		(*pointcloud_)[next_insert_position_] = new_element; 									// replacing old elements
-	}
+	if (max_buffer_size_ == 0) { return; }
 
-	if (++next_insert_position_ >= max_buffer_size_) {
-		next_insert_position_ = 0;																// wrap around
-	}
+	size_t insert_position;
+	reserveInsertionSlots(1, insert_position);
+	(*pointcloud_)[insert_position] = new_element;
 }
 
 
@@ -89,31 +51,14 @@ void CircularBufferPointCloud<PointT>::insert(const pcl::PointCloud<PointT>& new
 
 template<typename PointT>
 void CircularBufferPointCloud<PointT>::insert(typename pcl::PointCloud<PointT>::const_iterator first, typename pcl::PointCloud<PointT>::const_iterator last) {
-	size_t number_elements_to_insert = std::distance(first, last);
-	if (number_elements_to_insert > max_buffer_size_) {
-		last = first + max_buffer_size_;
-	}
+	size_t number_elements_to_insert = std::min((size_t)std::distance(first, last), max_buffer_size_);
 
-	size_t remaining_number_elements_to_insert = fillBuffer(number_elements_to_insert, first);
-	std::advance(first, number_elements_to_insert - remaining_number_elements_to_insert);
-
-	if (remaining_number_elements_to_insert > 0) {
-		if (next_insert_position_ + remaining_number_elements_to_insert < pointcloud_->size()) { // replacing old elements
-			for (size_t i = 0; i < remaining_number_elements_to_insert; ++i) {
-				(*pointcloud_)[next_insert_position_++] = *first++;
-			}
-		} else { // replacing old elements with wrap around
-			size_t next_element_to_insert = 0;
-			size_t number_elements_until_end_of_buffer = pointcloud_->size() - next_insert_position_;
-			for (; next_element_to_insert < number_elements_until_end_of_buffer; ++next_element_to_insert) {
-				(*pointcloud_)[next_insert_position_++] = *first++;
-			}
-
-			next_insert_position_ = 0;
-			for (; next_element_to_insert < remaining_number_elements_to_insert; ++next_element_to_insert) {
-				(*pointcloud_)[next_insert_position_++] = *first++;
-			}
-		}
+	while (number_elements_to_insert > 0) {
+		size_t insert_position;
+		size_t number_elements_inserted = reserveInsertionSlots(number_elements_to_insert, insert_position);
+		std::copy(first, first + number_elements_inserted, pointcloud_->begin() + insert_position);
+		std::advance(first, number_elements_inserted);
+		number_elements_to_insert -= number_elements_inserted;
 	}
 }
 
@@ -130,28 +75,14 @@ bool CircularBufferPointCloud<PointT>::insertWithSwappping(pcl::PointCloud<Point
 
 template<typename PointT>
 bool CircularBufferPointCloud<PointT>::insertWithSwappping(typename pcl::PointCloud<PointT>::iterator first, typename pcl::PointCloud<PointT>::iterator last) {
-	size_t number_elements_to_insert = std::distance(first, last);
-	if (number_elements_to_insert > max_buffer_size_) {
-		last = first + max_buffer_size_;
-	}
-	size_t remaining_number_elements_to_insert = fillBuffer(number_elements_to_insert, first);
-	std::advance(first, number_elements_to_insert - remaining_number_elements_to_insert);
-
-	if (next_insert_position_ + remaining_number_elements_to_insert < pointcloud_->size()) { // swapping old elements
-		for (size_t i = 0; i < remaining_number_elements_to_insert; ++i) {
-			std::swap((*pointcloud_)[next_insert_position_++], *first++);
-		}
-	} else { // swapping old elements with wrap around
-		size_t next_element_to_insert = 0;
-		size_t number_elements_until_end_of_buffer = pointcloud_->size() - next_insert_position_;
-		for (; next_element_to_insert < number_elements_until_end_of_buffer; ++next_element_to_insert) {
-			std::swap((*pointcloud_)[next_insert_position_++], *first++);
-		}
-
-		next_insert_position_ = 0;
-		for (; next_element_to_insert < remaining_number_elements_to_insert; ++next_element_to_insert) {
-			std::swap((*pointcloud_)[next_insert_position_++], *first++);
-		}
+	size_t number_elements_to_insert = std::min((size_t)std::distance(first, last), max_buffer_size_);
+
+	while (number_elements_to_insert > 0) {
+		size_t insert_position;
+		size_t number_elements_inserted = reserveInsertionSlots(number_elements_to_insert, insert_position);
+		std::swap_ranges(first, first + number_elements_inserted, pointcloud_->begin() + insert_position);
+		std::advance(first, number_elements_inserted);
+		number_elements_to_insert -= number_elements_inserted;
 	}
 
 	return true; // swapping performed
@@ -160,15 +91,10 @@ bool CircularBufferPointCloud<PointT>::insertWithSwappping(typename pcl::PointCl
 
 template<typename PointT>
 void CircularBufferPointCloud<PointT>::insertReverse(const PointT& new_element) {
-	if (pointcloud_->empty()) { // filling the buffer
-		pointcloud_->push_back(new_element);
-		++next_insert_position_;
+	if (number_elements_ == 0) { // filling the buffer
+		insert(new_element);
 	} else { // replace last element inserted
-		if (next_insert_position_ == 0) {
-			pointcloud_->back() = new_element;
-		} else {
-			(*pointcloud_)[next_insert_position_ - 1] = new_element;
-		}
+		back() = new_element;
 	}
 }
 
@@ -185,74 +111,109 @@ void CircularBufferPointCloud<PointT>::insertReverse(const pcl::PointCloud<Point
 
 template<typename PointT>
 void CircularBufferPointCloud<PointT>::insertReverse(typename pcl::PointCloud<PointT>::const_iterator first, typename pcl::PointCloud<PointT>::const_iterator last) {
-	size_t number_elements_to_insert = std::distance(first, last);
-	if (number_elements_to_insert > max_buffer_size_) {
-		last = first + max_buffer_size_;
-	}
-	size_t remaining_number_elements_to_insert = fillBuffer(number_elements_to_insert, first);
-	std::advance(first, number_elements_to_insert - remaining_number_elements_to_insert);
-
-	size_t next_insert_position_reverse = next_insert_position_;
-	if (remaining_number_elements_to_insert > 0) {
-		if (remaining_number_elements_to_insert <= next_insert_position_reverse) { // replacing old elements
-			for (size_t i = 0; i < remaining_number_elements_to_insert; ++i) {
-				(*pointcloud_)[next_insert_position_reverse--] = *first++;
-			}
-		} else { // replacing old elements with wrap around
-			size_t next_element_to_insert = 0;
-			for (; next_element_to_insert <= next_insert_position_; ++next_element_to_insert) {
-				(*pointcloud_)[next_insert_position_reverse--] = *first++;
-			}
-
-			next_insert_position_reverse = pointcloud_->size() - 1;
-			for (; next_element_to_insert < remaining_number_elements_to_insert; ++next_element_to_insert) {
-				(*pointcloud_)[next_insert_position_reverse--] = *first++;
-			}
-		}
+	size_t number_elements_to_insert = std::min((size_t)std::distance(first, last), max_buffer_size_);
+	size_t number_elements_to_fill_buffer = std::min(number_elements_to_insert, max_buffer_size_ - number_elements_);
+	insert(first, first + number_elements_to_fill_buffer);
+	std::advance(first, number_elements_to_fill_buffer);
+
+	size_t element_index = number_elements_ - number_elements_to_fill_buffer;
+	for (size_t i = number_elements_to_fill_buffer; i < number_elements_to_insert; ++i) { // replacing the elements older than the ones inserted, going backwards
+		(*this)[--element_index] = *first++;
 	}
 }
 
 
 template<typename PointT>
 void CircularBufferPointCloud<PointT>::eraseNewest(size_t count) {
-	if (count > 0 && !pointcloud_->empty()) {
-		if (count >= pointcloud_->size()) {
-			pointcloud_->clear();
-			next_insert_position_ = 0;
-		} else if (count <= next_insert_position_) { // remove newest elements
-			pointcloud_->erase(pointcloud_->begin() + (next_insert_position_ - count), pointcloud_->begin() + next_insert_position_);
-			next_insert_position_ -= count;
-		} else { // remove newest elements with wrap around
-			if (next_insert_position_ != 0) {
-				pointcloud_->erase(pointcloud_->begin(), pointcloud_->begin() + next_insert_position_);
-			}
-
-			pointcloud_->erase(pointcloud_->end() - (count - next_insert_position_), pointcloud_->end());
-			next_insert_position_ = 0;
-		}
-	}
+	number_elements_ -= std::min(count, number_elements_);
+	if (number_elements_ == 0) { oldest_element_position_ = 0; }
 }
 
+
 template<typename PointT>
 void CircularBufferPointCloud<PointT>::eraseOldest(size_t count) {
-	if (count > 0 && !pointcloud_->empty()) {
-		if (count >= pointcloud_->size()) {
-			pointcloud_->clear();
-			next_insert_position_ = 0;
-		} else if (next_insert_position_ + count <= pointcloud_->size()) { // remove oldest elements
-			pointcloud_->erase(pointcloud_->begin() + next_insert_position_, pointcloud_->begin() + (next_insert_position_ + count));
-		} else { // remove oldest elements with wrap around
-			pointcloud_->erase(pointcloud_->begin() + next_insert_position_, pointcloud_->end());
-			size_t number_elements_to_remove_at_beginning = count - (pointcloud_->size() - next_insert_position_);
-			pointcloud_->erase(pointcloud_->begin(), pointcloud_->begin() + number_elements_to_remove_at_beginning);
-			next_insert_position_ -= number_elements_to_remove_at_beginning;
-		}
+	count = std::min(count, number_elements_);
+	oldest_element_position_ = getBufferPosition(count);
+	number_elements_ -= count;
+	if (number_elements_ == 0) { oldest_element_position_ = 0; }
+}
+
+
+template<typename PointT>
+void CircularBufferPointCloud<PointT>::linearize() {
+	if (number_elements_ < pointcloud_->size()) { // otherwise all slots are valid
+		moveOldestElementToBeginning();
 	}
 }
+
+
+template<typename PointT>
+void CircularBufferPointCloud<PointT>::resize(size_t number_elements) {
+	moveOldestElementToBeginning();
+	pointcloud_->resize(number_elements);
+	number_elements_ = number_elements;
+	max_buffer_size_ = number_elements;
+}
+
+
+template<typename PointT>
+void CircularBufferPointCloud<PointT>::reserve(size_t number_elements) {
+	if (number_elements_ < number_elements) {
+		moveOldestElementToBeginning();
+		pointcloud_->reserve(number_elements);
+		max_buffer_size_ = number_elements;
+	}
+}
+
+
+template<typename PointT>
+void CircularBufferPointCloud<PointT>::setMaxBufferSize(size_t max_buffer_size) {
+	moveOldestElementToBeginning();
+	if (number_elements_ > max_buffer_size) { // keep the newest elements
+		pointcloud_->points.erase(pointcloud_->points.begin(), pointcloud_->points.begin() + (number_elements_ - max_buffer_size));
+		pointcloud_->resize(max_buffer_size);
+		number_elements_ = max_buffer_size;
+	}
+	max_buffer_size_ = max_buffer_size;
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </CircularBufferPointCloud-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
 // =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+void CircularBufferPointCloud<PointT>::moveOldestElementToBeginning() {
+	if (oldest_element_position_ != 0) {
+		std::rotate(pointcloud_->points.begin(), pointcloud_->points.begin() + oldest_element_position_, pointcloud_->points.end());
+		oldest_element_position_ = 0;
+	}
+
+	if (number_elements_ < pointcloud_->size()) {
+		pointcloud_->resize(number_elements_);
+	}
+}
+
+
+template<typename PointT>
+size_t CircularBufferPointCloud<PointT>::reserveInsertionSlots(size_t number_elements_to_insert, size_t& insert_position_out) {
+	size_t buffer_size = pointcloud_->size();
+	insert_position_out = getBufferPosition(number_elements_);
+
+	size_t number_slots;
+	if (insert_position_out < buffer_size) {	// replacing erased or oldest elements
+		number_slots = std::min(number_elements_to_insert, buffer_size - insert_position_out);
+	} else {									// filling the buffer at the end
+		number_slots = std::min(number_elements_to_insert, max_buffer_size_ - buffer_size);
+		pointcloud_->resize(buffer_size + number_slots);
+	}
+
+	number_elements_ += number_slots;
+	if (number_elements_ > max_buffer_size_) {	// oldest elements were replaced
+		oldest_element_position_ = getBufferPosition(number_elements_ - max_buffer_size_);
+		number_elements_ = max_buffer_size_;
+	}
+
+	return number_slots;
+}
 // =============================================================================   </protected-section>  =======================================================================
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
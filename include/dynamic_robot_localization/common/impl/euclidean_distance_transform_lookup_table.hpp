@@ -0,0 +1,453 @@
+/**\file euclidean_distance_transform_lookup_table.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/euclidean_distance_transform_lookup_table.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+EuclideanDistanceTransformLookupTable<PointT>::EuclideanDistanceTransformLookupTable() :
+	cell_resolution_(0.01),
+	cell_resolution_inverse_(100.0f),
+	lookup_table_margin_(1.0f, 1.0f, 1.0f),
+	minimum_bounds_(Eigen::Vector3f::Zero()),
+	maximum_bounds_(Eigen::Vector3f::Zero()),
+	maximum_number_of_cells_(536870912),
+	incremental_update_radius_(0.1),
+	number_of_reference_points_(0),
+	reference_cloud_hash_(hash_utils::HASH_INITIAL_VALUE),
+	reference_cloud_samples_hash_(hash_utils::HASH_INITIAL_VALUE),
+	cells_(NULL) {
+	number_of_cells_[0] = 0;
+	number_of_cells_[1] = 0;
+	number_of_cells_[2] = 0;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <EuclideanDistanceTransformLookupTable-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+bool EuclideanDistanceTransformLookupTable<PointT>::setupReferenceCloud(const typename pcl::PointCloud<PointT>::ConstPtr& reference_cloud) {
+	if (!reference_cloud || reference_cloud->empty() || cell_resolution_ <= 0.0 || reference_cloud->size() > (size_t)std::numeric_limits<boost::int32_t>::max()) {
+		clear();
+		return false;
+	}
+
+	PerformanceTimer performance_timer;
+	performance_timer.start();
+	cell_resolution_inverse_ = (float)(1.0 / cell_resolution_);
+
+	// incremental map update -> the same reference cloud kept the points used to compute the table and received new points at its end
+	// (the previous points are checked with a fixed number of samples and only the new points are hashed, to keep the update proportional to the number of new points)
+	if (cells_ != NULL && reference_cloud == reference_cloud_ && reference_cloud->size() >= number_of_reference_points_) {
+		if (computeReferenceCloudSamplesHash(*reference_cloud, number_of_reference_points_) == reference_cloud_samples_hash_) {
+			if (reference_cloud->size() == number_of_reference_points_) {
+				return true;
+			}
+
+			size_t number_of_new_points = reference_cloud->size() - number_of_reference_points_;
+			if (updateLookupTableWithNewPoints(*reference_cloud, number_of_reference_points_)) {
+				reference_cloud_hash_ = computeReferenceCloudHash(*reference_cloud, number_of_reference_points_, reference_cloud->size(), reference_cloud_hash_);
+				number_of_reference_points_ = reference_cloud->size();
+				reference_cloud_samples_hash_ = computeReferenceCloudSamplesHash(*reference_cloud, number_of_reference_points_);
+				updateFileHeader();
+				ROS_DEBUG_STREAM("Updated the Euclidean distance transform lookup table with " << number_of_new_points << " new reference points in " << performance_timer.getElapsedTimeFormated());
+				return true;
+			}
+
+			ROS_DEBUG("Recomputing the Euclidean distance transform lookup table because there are new reference points outside its bounds");
+		}
+	}
+
+	clear();
+	reference_cloud_ = reference_cloud;
+	number_of_reference_points_ = reference_cloud->size();
+	reference_cloud_hash_ = computeReferenceCloudHash(*reference_cloud, 0, number_of_reference_points_);
+	reference_cloud_samples_hash_ = computeReferenceCloudSamplesHash(*reference_cloud, number_of_reference_points_);
+
+	if (!filename_.empty() && loadFromFile()) {
+		ROS_INFO_STREAM("Loaded Euclidean distance transform lookup table with " << getNumberOfCells() << " cells from file " << filename_ << " in " << performance_timer.getElapsedTimeFormated());
+		return true;
+	}
+
+	if (!computeLookupTableBounds(*reference_cloud)) {
+		clear();
+		return false;
+	}
+
+	cells_memory_.resize(getNumberOfCells());
+	computeEuclideanDistanceTransform(*reference_cloud, &cells_memory_[0]);
+	cells_ = &cells_memory_[0];
+	ROS_INFO_STREAM("Computed Euclidean distance transform lookup table with " << getNumberOfCells() << " cells in " << performance_timer.getElapsedTimeFormated());
+
+	if (!filename_.empty()) {
+		if (saveToFile(cells_) && loadFromFile()) {
+			std::vector<boost::int32_t>().swap(cells_memory_); // the memory mapped file is used from now on
+			ROS_INFO_STREAM("Saved Euclidean distance transform lookup table to file " << filename_);
+		} else {
+			cells_ = &cells_memory_[0];
+			ROS_WARN_STREAM("Failed to save Euclidean distance transform lookup table to file " << filename_);
+		}
+	}
+
+	return true;
+}
+
+
+template<typename PointT>
+void EuclideanDistanceTransformLookupTable<PointT>::clear() {
+	cells_ = NULL;
+	std::vector<boost::int32_t>().swap(cells_memory_);
+	lookup_table_file_.reset();
+	reference_cloud_.reset();
+	number_of_reference_points_ = 0;
+	reference_cloud_hash_ = hash_utils::HASH_INITIAL_VALUE;
+	reference_cloud_samples_hash_ = hash_utils::HASH_INITIAL_VALUE;
+	number_of_cells_[0] = 0;
+	number_of_cells_[1] = 0;
+	number_of_cells_[2] = 0;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </EuclideanDistanceTransformLookupTable-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+boost::uint64_t EuclideanDistanceTransformLookupTable<PointT>::computeReferenceCloudHash(const pcl::PointCloud<PointT>& reference_cloud, size_t first_point_index, size_t last_point_index, boost::uint64_t hash) {
+	last_point_index = std::min(last_point_index, reference_cloud.size());
+	for (size_t i = first_point_index; i < last_point_index; ++i) {
+		hash = hash_utils::computeHash(&reference_cloud.points[i].x, 3 * sizeof(float), hash); // x, y, z are contiguous (the padding of the points is not hashed)
+	}
+	return hash;
+}
+
+
+template<typename PointT>
+boost::uint64_t EuclideanDistanceTransformLookupTable<PointT>::computeReferenceCloudSamplesHash(const pcl::PointCloud<PointT>& reference_cloud, size_t number_of_points) {
+	boost::uint64_t hash = hash_utils::computeHash(&number_of_points, sizeof(size_t));
+	number_of_points = std::min(number_of_points, reference_cloud.size());
+	if (number_of_points == 0) { return hash; }
+
+	size_t number_of_samples = std::min(number_of_points, (size_t)NUMBER_OF_REFERENCE_CLOUD_SAMPLES);
+	for (size_t i = 0; i < number_of_samples; ++i) {
+		size_t point_index = (number_of_samples > 1) ? (i * (number_of_points - 1)) / (number_of_samples - 1) : 0; // includes the first and last points
+		hash = hash_utils::computeHash(&reference_cloud.points[point_index].x, 3 * sizeof(float), hash);
+	}
+	return hash;
+}
+
+
+template<typename PointT>
+boost::uint64_t EuclideanDistanceTransformLookupTable<PointT>::computeConfigurationHash() const {
+	boost::uint64_t hash = hash_utils::computeHash(&cell_resolution_, sizeof(double));
+	return hash_utils::computeHash(lookup_table_margin_.data(), 3 * sizeof(float), hash);
+}
+
+
+template<typename PointT>
+bool EuclideanDistanceTransformLookupTable<PointT>::computeLookupTableBounds(const pcl::PointCloud<PointT>& reference_cloud) {
+	Eigen::Vector4f minimum_point, maximum_point;
+	pcl::getMinMax3D(reference_cloud, minimum_point, maximum_point);
+	minimum_bounds_ = minimum_point.head<3>() - lookup_table_margin_;
+	Eigen::Vector3f extent = maximum_point.head<3>() + lookup_table_margin_ - minimum_bounds_;
+
+	double number_of_cells = 1.0;
+	for (int i = 0; i < 3; ++i) {
+		number_of_cells_[i] = (size_t)std::max(1.0f, std::floor(extent(i) * cell_resolution_inverse_) + 1.0f);
+		number_of_cells *= (double)number_of_cells_[i];
+	}
+
+	if (!pcl_isfinite(extent.sum()) || number_of_cells > (double)maximum_number_of_cells_) {
+		ROS_WARN_STREAM("Discarded Euclidean distance transform lookup table with " << number_of_cells << " cells (maximum is " << maximum_number_of_cells_ << ") | Increase the cell resolution or decrease the margins");
+		return false;
+	}
+
+	maximum_bounds_ = minimum_bounds_ + Eigen::Vector3f((float)number_of_cells_[0], (float)number_of_cells_[1], (float)number_of_cells_[2]) * (float)cell_resolution_;
+	return true;
+}
+
+
+template<typename PointT>
+void EuclideanDistanceTransformLookupTable<PointT>::computeEuclideanDistanceTransform(const pcl::PointCloud<PointT>& reference_cloud, boost::int32_t* cells) {
+	size_t number_of_cells = getNumberOfCells();
+	std::vector<float> distances(number_of_cells, std::numeric_limits<float>::infinity());
+	std::fill(cells, cells + number_of_cells, -1);
+
+	// seed cells -> closest reference point to the cell center (the distances are in cell units)
+	for (size_t i = 0; i < reference_cloud.size(); ++i) {
+		const PointT& point = reference_cloud.points[i];
+		if (!pcl_isfinite(point.x) || !pcl_isfinite(point.y) || !pcl_isfinite(point.z)) { continue; }
+		Eigen::Vector3f cell_coordinates = (point.getVector3fMap() - minimum_bounds_) * cell_resolution_inverse_;
+		size_t cell_x = std::min((size_t)std::max(0.0f, cell_coordinates(0)), number_of_cells_[0] - 1);
+		size_t cell_y = std::min((size_t)std::max(0.0f, cell_coordinates(1)), number_of_cells_[1] - 1);
+		size_t cell_z = std::min((size_t)std::max(0.0f, cell_coordinates(2)), number_of_cells_[2] - 1);
+		float distance = (cell_coordinates - Eigen::Vector3f((float)cell_x + 0.5f, (float)cell_y + 0.5f, (float)cell_z + 0.5f)).squaredNorm();
+		size_t cell_index = computeCellIndex(cell_x, cell_y, cell_z);
+		if (distance < distances[cell_index]) {
+			distances[cell_index] = distance;
+			cells[cell_index] = (boost::int32_t)i;
+		}
+	}
+
+	// separable transform -> 1D transform along the lines of each axis, propagating the closest point index of the parabola that defines the lower envelope
+	size_t axis_strides[3] = { 1, number_of_cells_[0], number_of_cells_[0] * number_of_cells_[1] };
+	for (int axis = 0; axis < 3; ++axis) {
+		size_t number_of_samples = number_of_cells_[axis];
+		if (number_of_samples < 2) { continue; }
+		size_t stride = axis_strides[axis];
+		long number_of_lines = (long)(number_of_cells / number_of_samples);
+
+		#pragma omp parallel
+		{
+			std::vector<float> line_distances(number_of_samples), line_distances_out(number_of_samples);
+			std::vector<boost::int32_t> line_indices(number_of_samples), line_indices_out(number_of_samples);
+			std::vector<size_t> parabolas_vertices(number_of_samples);
+			std::vector<double> parabolas_boundaries(number_of_samples + 1);
+
+			#pragma omp for schedule(dynamic, 64)
+			for (long line = 0; line < number_of_lines; ++line) {
+				size_t first_cell;
+				if (axis == 0) {
+					first_cell = (size_t)line * number_of_samples;
+				} else if (axis == 1) {
+					first_cell = ((size_t)line / number_of_cells_[0]) * axis_strides[2] + ((size_t)line % number_of_cells_[0]);
+				} else {
+					first_cell = (size_t)line;
+				}
+
+				for (size_t i = 0; i < number_of_samples; ++i) {
+					line_distances[i] = distances[first_cell + i * stride];
+					line_indices[i] = cells[first_cell + i * stride];
+				}
+
+				computeDistanceTransform1D(&line_distances[0], &line_indices[0], number_of_samples, &line_distances_out[0], &line_indices_out[0], parabolas_vertices, parabolas_boundaries);
+
+				for (size_t i = 0; i < number_of_samples; ++i) {
+					distances[first_cell + i * stride] = line_distances_out[i];
+					cells[first_cell + i * stride] = line_indices_out[i];
+				}
+			}
+		}
+	}
+}
+
+
+template<typename PointT>
+void EuclideanDistanceTransformLookupTable<PointT>::computeDistanceTransform1D(const float* distances, const boost::int32_t* indices, size_t number_of_samples,
+		float* distances_out, boost::int32_t* indices_out, std::vector<size_t>& parabolas_vertices, std::vector<double>& parabolas_boundaries) {
+	// lower envelope of the parabolas rooted at the samples with finite distance (Felzenszwalb and Huttenlocher)
+	long k = -1;
+	for (size_t q = 0; q < number_of_samples; ++q) {
+		if (!(distances[q] < std::numeric_limits<float>::infinity())) { continue; }
+
+		if (k < 0) {
+			k = 0;
+			parabolas_vertices[0] = q;
+			parabolas_boundaries[0] = -std::numeric_limits<double>::infinity();
+			parabolas_boundaries[1] = std::numeric_limits<double>::infinity();
+			continue;
+		}
+
+		double s;
+		while (true) { // parabolas_boundaries[0] is -infinity, so k never becomes negative
+			size_t v = parabolas_vertices[k];
+			s = (((double)distances[q] + (double)q * (double)q) - ((double)distances[v] + (double)v * (double)v)) / (2.0 * ((double)q - (double)v));
+			if (s > parabolas_boundaries[k]) { break; }
+			--k;
+		}
+
+		++k;
+		parabolas_vertices[k] = q;
+		parabolas_boundaries[k] = s;
+		parabolas_boundaries[k + 1] = std::numeric_limits<double>::infinity();
+	}
+
+	if (k < 0) {
+		for (size_t q = 0; q < number_of_samples; ++q) {
+			distances_out[q] = std::numeric_limits<float>::infinity();
+			indices_out[q] = -1;
+		}
+		return;
+	}
+
+	k = 0;
+	for (size_t q = 0; q < number_of_samples; ++q) {
+		while (parabolas_boundaries[k + 1] < (double)q) { ++k; }
+		size_t v = parabolas_vertices[k];
+		double offset = (double)q - (double)v;
+		distances_out[q] = (float)(offset * offset + (double)distances[v]);
+		indices_out[q] = indices[v];
+	}
+}
+
+
+template<typename PointT>
+bool EuclideanDistanceTransformLookupTable<PointT>::updateLookupTableWithNewPoints(const pcl::PointCloud<PointT>& reference_cloud, size_t first_new_point_index) {
+	if (cells_ == NULL || (lookup_table_file_ && !lookup_table_file_->isWritable())) { return false; }
+
+	for (size_t i = first_new_point_index; i < reference_cloud.size(); ++i) {
+		const PointT& point = reference_cloud.points[i];
+		if (pcl_isfinite(point.x) && pcl_isfinite(point.y) && pcl_isfinite(point.z) && !isInsideLookupTable(point.x, point.y, point.z)) { return false; }
+	}
+
+	// the cells are changed in place in the shared memory mapped file, so it must not match any reference cloud until its header is updated after the new cells are written back
+	if (lookup_table_file_ && !invalidateFileHeader()) { return false; }
+
+	// the cells farther than the update radius keep their previous closest point (only the correspondences close to the new points are relevant for the registration)
+	long radius_in_cells = (long)std::ceil(incremental_update_radius_ * cell_resolution_inverse_);
+	float squared_radius = (float)(incremental_update_radius_ * incremental_update_radius_) + (float)(0.75 * cell_resolution_ * cell_resolution_);
+	for (size_t i = first_new_point_index; i < reference_cloud.size(); ++i) {
+		const PointT& point = reference_cloud.points[i];
+		if (!pcl_isfinite(point.x) || !pcl_isfinite(point.y) || !pcl_isfinite(point.z)) { continue; }
+		Eigen::Vector3f point_position = point.getVector3fMap();
+		Eigen::Vector3f cell_coordinates = (point_position - minimum_bounds_) * cell_resolution_inverse_;
+		long cell_center[3] = { (long)cell_coordinates(0), (long)cell_coordinates(1), (long)cell_coordinates(2) };
+		long cell_min[3], cell_max[3];
+		for (int axis = 0; axis < 3; ++axis) {
+			cell_min[axis] = std::max(0L, cell_center[axis] - radius_in_cells);
+			cell_max[axis] = std::min((long)number_of_cells_[axis] - 1, cell_center[axis] + radius_in_cells);
+		}
+
+		for (long cell_z = cell_min[2]; cell_z <= cell_max[2]; ++cell_z) {
+			for (long cell_y = cell_min[1]; cell_y <= cell_max[1]; ++cell_y) {
+				for (long cell_x = cell_min[0]; cell_x <= cell_max[0]; ++cell_x) {
+					Eigen::Vector3f cell_position = computeCellCenter((size_t)cell_x, (size_t)cell_y, (size_t)cell_z);
+					float new_point_squared_distance = (cell_position - point_position).squaredNorm();
+					if (new_point_squared_distance > squared_radius) { continue; }
+
+					boost::int32_t& cell = cells_[computeCellIndex((size_t)cell_x, (size_t)cell_y, (size_t)cell_z)];
+					if (cell < 0 || (size_t)cell >= reference_cloud.size() || new_point_squared_distance < (cell_position - reference_cloud.points[cell].getVector3fMap()).squaredNorm()) {
+						cell = (boost::int32_t)i;
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+
+template<typename PointT>
+void EuclideanDistanceTransformLookupTable<PointT>::fillHeader(LookupTableHeader& header) const {
+	std::memset(&header, 0, sizeof(LookupTableHeader));
+	std::memcpy(header.magic, "DRLEDTL", 8);
+	header.format_version = LOOKUP_TABLE_FORMAT_VERSION;
+	header.cell_size = sizeof(boost::int32_t);
+	header.reference_cloud_hash = reference_cloud_hash_;
+	header.configuration_hash = computeConfigurationHash();
+	header.number_of_reference_points = number_of_reference_points_;
+	for (int i = 0; i < 3; ++i) {
+		header.number_of_cells[i] = number_of_cells_[i];
+		header.minimum_bounds[i] = minimum_bounds_(i);
+	}
+	header.data_offset = ((sizeof(LookupTableHeader) + LOOKUP_TABLE_DATA_ALIGNMENT - 1) / LOOKUP_TABLE_DATA_ALIGNMENT) * LOOKUP_TABLE_DATA_ALIGNMENT;
+}
+
+
+template<typename PointT>
+bool EuclideanDistanceTransformLookupTable<PointT>::loadFromFile() {
+	boost::shared_ptr<MemoryMappedFile> lookup_table_file(new MemoryMappedFile());
+	if (!lookup_table_file->open(filename_, true) || lookup_table_file->getSize() < sizeof(LookupTableHeader)) {
+		ROS_DEBUG_STREAM("Euclidean distance transform lookup table " << filename_ << " is not available");
+		return false;
+	}
+
+	LookupTableHeader header, expected_header;
+	std::memcpy(&header, lookup_table_file->getData(), sizeof(LookupTableHeader));
+	fillHeader(expected_header);
+
+	if (std::memcmp(header.magic, expected_header.magic, sizeof(header.magic)) != 0 || header.format_version != expected_header.format_version || header.cell_size != expected_header.cell_size) {
+		ROS_WARN_STREAM("Discarded Euclidean distance transform lookup table " << filename_ << " because it has a different format");
+		return false;
+	}
+
+	if (header.reference_cloud_hash != expected_header.reference_cloud_hash || header.number_of_reference_points != expected_header.number_of_reference_points || header.configuration_hash != expected_header.configuration_hash) {
+		ROS_INFO_STREAM("Discarded Euclidean distance transform lookup table " << filename_ << " because the reference point cloud or the lookup table configuration changed");
+		return false;
+	}
+
+	// the bounds are loaded from the file because they may be from a previous version of the reference cloud (before incremental map updates)
+	double number_of_cells = (double)header.number_of_cells[0] * (double)header.number_of_cells[1] * (double)header.number_of_cells[2];
+	if (header.data_offset != expected_header.data_offset || number_of_cells <= 0.0 || number_of_cells > (double)maximum_number_of_cells_
+			|| lookup_table_file->getSize() != header.data_offset + (size_t)number_of_cells * sizeof(boost::int32_t)) {
+		ROS_WARN_STREAM("Discarded Euclidean distance transform lookup table " << filename_ << " because it is truncated");
+		return false;
+	}
+
+	for (int i = 0; i < 3; ++i) {
+		number_of_cells_[i] = (size_t)header.number_of_cells[i];
+		minimum_bounds_(i) = header.minimum_bounds[i];
+	}
+	maximum_bounds_ = minimum_bounds_ + Eigen::Vector3f((float)number_of_cells_[0], (float)number_of_cells_[1], (float)number_of_cells_[2]) * (float)cell_resolution_;
+
+	lookup_table_file_ = lookup_table_file;
+	cells_ = reinterpret_cast<boost::int32_t*>(lookup_table_file_->getMutableData() + header.data_offset);
+	return true;
+}
+
+
+template<typename PointT>
+bool EuclideanDistanceTransformLookupTable<PointT>::saveToFile(const boost::int32_t* cells) const {
+	LookupTableHeader header;
+	fillHeader(header);
+
+	std::string temporary_filename = filename_ + ".tmp";
+	std::ofstream lookup_table_file(temporary_filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!lookup_table_file.is_open()) { return false; }
+
+	char padding[LOOKUP_TABLE_DATA_ALIGNMENT];
+	std::memset(padding, 0, LOOKUP_TABLE_DATA_ALIGNMENT);
+	lookup_table_file.write(reinterpret_cast<const char*>(&header), sizeof(LookupTableHeader));
+	lookup_table_file.write(padding, header.data_offset - sizeof(LookupTableHeader));
+	lookup_table_file.write(reinterpret_cast<const char*>(cells), getNumberOfCells() * sizeof(boost::int32_t));
+	lookup_table_file.close();
+
+	if (lookup_table_file.fail() || std::rename(temporary_filename.c_str(), filename_.c_str()) != 0) {
+		std::remove(temporary_filename.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+
+template<typename PointT>
+bool EuclideanDistanceTransformLookupTable<PointT>::updateFileHeader() {
+	if (!lookup_table_file_ || !lookup_table_file_->isWritable()) { return false; }
+
+	// the cells were already updated in the memory mapped file, so only the hash and number of points of the reference cloud have to be updated (after the cells are written back)
+	if (!lookup_table_file_->flush(true)) { return false; }
+	LookupTableHeader header;
+	fillHeader(header);
+	std::memcpy(lookup_table_file_->getMutableData(), &header, sizeof(LookupTableHeader));
+	return lookup_table_file_->flush();
+}
+
+
+template<typename PointT>
+bool EuclideanDistanceTransformLookupTable<PointT>::invalidateFileHeader() {
+	if (!lookup_table_file_ || !lookup_table_file_->isWritable()) { return false; }
+
+	LookupTableHeader header;
+	std::memcpy(&header, lookup_table_file_->getData(), sizeof(LookupTableHeader));
+	header.reference_cloud_hash = 0;
+	header.number_of_reference_points = 0;
+	std::memcpy(lookup_table_file_->getMutableData(), &header, sizeof(LookupTableHeader));
+	return lookup_table_file_->flush(true);
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
@@ -0,0 +1,201 @@
+/**\file incremental_kdtree.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/incremental_kdtree.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+IncrementalKdTree<PointT>::IncrementalKdTree(bool sorted) :
+		pcl::search::KdTree<PointT>(sorted),
+		number_of_new_points_(0),
+		number_of_points_in_main_tree_(0),
+		number_of_indexed_points_(0),
+		max_ratio_of_new_points_before_rebalance_(0.25) {}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IncrementalKdTree-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void IncrementalKdTree<PointT>::setInputCloud(const PointCloudConstPtr& cloud, const IndicesConstPtr& indices) {
+	cloud_ = cloud;
+	cloud_indices_ = indices;
+	number_of_indexed_points_ = cloud ? cloud->size() : 0;
+	number_of_points_in_main_tree_ = indices ? indices->size() : number_of_indexed_points_;
+	new_points_trees_.clear();
+	number_of_new_points_ = 0;
+	pcl::search::KdTree<PointT>::setInputCloud(cloud, indices);
+}
+
+
+template<typename PointT>
+void IncrementalKdTree<PointT>::updateIndexWithNewPoints() {
+	if (!cloud_) { return; }
+
+	size_t cloud_size = cloud_->size();
+	if (cloud_size < number_of_indexed_points_) {
+		setInputCloud(cloud_, cloud_indices_);
+		return;
+	}
+
+	if (cloud_size == number_of_indexed_points_) { return; }
+
+	NewPointsTree new_points_tree;
+	new_points_tree.indices.reset(new std::vector<int>());
+	new_points_tree.indices->reserve(cloud_size - number_of_indexed_points_);
+	for (size_t i = number_of_indexed_points_; i < cloud_size; ++i) {
+		new_points_tree.indices->push_back((int)i);
+	}
+	number_of_new_points_ += cloud_size - number_of_indexed_points_;
+	number_of_indexed_points_ = cloud_size;
+
+	if (rebalanceRequired()) {
+		rebalance();
+		return;
+	}
+
+	// merge with the small trees that are not larger than the new one (their sizes double at each level, so each point is reindexed at most a logarithmic number of times)
+	while (!new_points_trees_.empty() && new_points_trees_.back().indices->size() <= new_points_tree.indices->size()) {
+		const std::vector<int>& smaller_tree_indices = *(new_points_trees_.back().indices);
+		new_points_tree.indices->insert(new_points_tree.indices->end(), smaller_tree_indices.begin(), smaller_tree_indices.end());
+		new_points_trees_.pop_back();
+	}
+
+	new_points_tree.search_method.reset(new pcl::search::KdTree<PointT>(this->sorted_results_));
+	new_points_tree.search_method->setEpsilon(this->getEpsilon());
+	new_points_tree.search_method->setInputCloud(cloud_, new_points_tree.indices);
+	new_points_trees_.push_back(new_points_tree);
+}
+
+
+template<typename PointT>
+void IncrementalKdTree<PointT>::rebalance() {
+	if (!cloud_) { return; }
+
+	if (cloud_indices_) { // the points outside the initial indices remain excluded from the index
+		boost::shared_ptr< std::vector<int> > indices(new std::vector<int>());
+		indices->reserve(cloud_indices_->size() + number_of_new_points_);
+		indices->insert(indices->end(), cloud_indices_->begin(), cloud_indices_->end());
+		for (size_t i = number_of_indexed_points_ - number_of_new_points_; i < number_of_indexed_points_; ++i) { // the new points are always appended at the end of the cloud
+			indices->push_back((int)i);
+		}
+		cloud_indices_ = indices;
+	}
+
+	pcl::search::KdTree<PointT>::setInputCloud(cloud_, cloud_indices_);
+	number_of_points_in_main_tree_ = cloud_indices_ ? cloud_indices_->size() : number_of_indexed_points_;
+	new_points_trees_.clear();
+	number_of_new_points_ = 0;
+}
+
+
+template<typename PointT>
+int IncrementalKdTree<PointT>::nearestKSearch(const PointT& point, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const {
+	k_indices.clear();
+	k_sqr_distances.clear();
+	if (k <= 0) { return 0; }
+
+	if (number_of_points_in_main_tree_ > 0) {
+		pcl::search::KdTree<PointT>::nearestKSearch(point, (int)std::min((size_t)k, number_of_points_in_main_tree_), k_indices, k_sqr_distances);
+	}
+
+	if (new_points_trees_.empty()) { return (int)k_indices.size(); }
+
+	SearchBuffers& search_buffers = getSearchBuffers();
+	for (size_t i = 0; i < new_points_trees_.size(); ++i) {
+		new_points_trees_[i].search_method->nearestKSearch(point, (int)std::min((size_t)k, new_points_trees_[i].indices->size()), search_buffers.tree_indices, search_buffers.tree_sqr_distances);
+		mergeSearchResults(k_indices, k_sqr_distances, search_buffers.tree_indices, search_buffers.tree_sqr_distances, (size_t)k, search_buffers.merged_indices, search_buffers.merged_sqr_distances);
+		k_indices.swap(search_buffers.merged_indices);
+		k_sqr_distances.swap(search_buffers.merged_sqr_distances);
+	}
+
+	return (int)k_indices.size();
+}
+
+
+template<typename PointT>
+int IncrementalKdTree<PointT>::radiusSearch(const PointT& point, double radius, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances, unsigned int max_nn) const {
+	k_indices.clear();
+	k_sqr_distances.clear();
+
+	if (number_of_points_in_main_tree_ > 0) {
+		pcl::search::KdTree<PointT>::radiusSearch(point, radius, k_indices, k_sqr_distances, max_nn);
+	}
+
+	if (new_points_trees_.empty()) { return (int)k_indices.size(); }
+
+	size_t max_number_of_results = (max_nn == 0) ? std::numeric_limits<size_t>::max() : (size_t)max_nn;
+	SearchBuffers& search_buffers = getSearchBuffers();
+	for (size_t i = 0; i < new_points_trees_.size(); ++i) {
+		if (!this->sorted_results_ && k_indices.size() >= max_number_of_results) { break; }
+		new_points_trees_[i].search_method->radiusSearch(point, radius, search_buffers.tree_indices, search_buffers.tree_sqr_distances, max_nn);
+
+		if (this->sorted_results_) {
+			mergeSearchResults(k_indices, k_sqr_distances, search_buffers.tree_indices, search_buffers.tree_sqr_distances, max_number_of_results, search_buffers.merged_indices, search_buffers.merged_sqr_distances);
+			k_indices.swap(search_buffers.merged_indices);
+			k_sqr_distances.swap(search_buffers.merged_sqr_distances);
+		} else {
+			size_t number_of_results_to_add = std::min(max_number_of_results - k_indices.size(), search_buffers.tree_indices.size());
+			k_indices.insert(k_indices.end(), search_buffers.tree_indices.begin(), search_buffers.tree_indices.begin() + number_of_results_to_add);
+			k_sqr_distances.insert(k_sqr_distances.end(), search_buffers.tree_sqr_distances.begin(), search_buffers.tree_sqr_distances.begin() + number_of_results_to_add);
+		}
+	}
+
+	return (int)k_indices.size();
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IncrementalKdTree-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+bool IncrementalKdTree<PointT>::rebalanceRequired() const {
+	return (double)number_of_new_points_ > max_ratio_of_new_points_before_rebalance_ * (double)number_of_points_in_main_tree_;
+}
+
+
+template<typename PointT>
+typename IncrementalKdTree<PointT>::SearchBuffers& IncrementalKdTree<PointT>::getSearchBuffers() const {
+	SearchBuffers* search_buffers = search_buffers_.get();
+	if (search_buffers == NULL) {
+		search_buffers = new SearchBuffers();
+		search_buffers_.reset(search_buffers);
+	}
+	return *search_buffers;
+}
+
+
+template<typename PointT>
+void IncrementalKdTree<PointT>::mergeSearchResults(const std::vector<int>& first_indices, const std::vector<float>& first_sqr_distances,
+		const std::vector<int>& second_indices, const std::vector<float>& second_sqr_distances,
+		size_t max_number_of_results, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const {
+	k_indices.clear();
+	k_sqr_distances.clear();
+
+	size_t first_position = 0;
+	size_t second_position = 0;
+	while (k_indices.size() < max_number_of_results && (first_position < first_indices.size() || second_position < second_indices.size())) {
+		bool use_first = (second_position >= second_indices.size())
+				|| (first_position < first_indices.size() && first_sqr_distances[first_position] <= second_sqr_distances[second_position]);
+
+		if (use_first) {
+			k_indices.push_back(first_indices[first_position]);
+			k_sqr_distances.push_back(first_sqr_distances[first_position++]);
+		} else {
+			k_indices.push_back(second_indices[second_position]);
+			k_sqr_distances.push_back(second_sqr_distances[second_position++]);
+		}
+	}
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+} /* namespace dynamic_robot_localization */
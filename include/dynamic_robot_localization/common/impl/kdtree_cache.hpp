@@ -0,0 +1,102 @@
+/**\file kdtree_cache.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/kdtree_cache.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <KdTreeCache-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+typename KdTreeCache<PointT>::KdTreePtr KdTreeCache<PointT>::getSearchMethod(const PointCloudConstPtr& pointcloud) {
+	if (!pointcloud) { return KdTreePtr(); }
+
+	int cache_entry_index = findCacheEntry(pointcloud.get());
+	if (cache_entry_index >= 0) {
+		if (isCacheEntryValid(cache_entries_[cache_entry_index])) {
+			++number_of_cache_hits_;
+			return cache_entries_[cache_entry_index].search_method;
+		}
+		cache_entries_.erase(cache_entries_.begin() + cache_entry_index);
+	}
+
+	KdTreePtr search_method(new pcl::search::KdTree<PointT>());
+	search_method->setInputCloud(pointcloud);
+	++number_of_kdtree_builds_;
+	setCacheEntry(search_method);
+	return search_method;
+}
+
+
+template<typename PointT>
+void KdTreeCache<PointT>::addSearchMethod(const KdTreePtr& search_method) {
+	if (search_method && search_method->getInputCloud()) {
+		setCacheEntry(search_method);
+	}
+}
+
+
+template<typename PointT>
+void KdTreeCache<PointT>::invalidateSearchMethod(const PointCloudConstPtr& pointcloud) {
+	int cache_entry_index = findCacheEntry(pointcloud.get());
+	if (cache_entry_index >= 0) {
+		cache_entries_.erase(cache_entries_.begin() + cache_entry_index);
+	}
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </KdTreeCache-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+bool KdTreeCache<PointT>::isCacheEntryValid(const CacheEntry& cache_entry) const {
+	// the kd-tree may have been reused by a pipeline stage for another cloud
+	return cache_entry.search_method->getInputCloud().get() == cache_entry.pointcloud.get()
+			&& cache_entry.points_data == getPointsData(*cache_entry.pointcloud)
+			&& cache_entry.number_of_points == cache_entry.pointcloud->size();
+}
+
+
+template<typename PointT>
+int KdTreeCache<PointT>::findCacheEntry(const pcl::PointCloud<PointT>* pointcloud) const {
+	for (size_t i = 0; i < cache_entries_.size(); ++i) {
+		if (cache_entries_[i].pointcloud.get() == pointcloud) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+
+template<typename PointT>
+void KdTreeCache<PointT>::setCacheEntry(const KdTreePtr& search_method) {
+	CacheEntry cache_entry;
+	cache_entry.pointcloud = search_method->getInputCloud();
+	cache_entry.points_data = getPointsData(*cache_entry.pointcloud);
+	cache_entry.number_of_points = cache_entry.pointcloud->size();
+	cache_entry.search_method = search_method;
+
+	int cache_entry_index = findCacheEntry(cache_entry.pointcloud.get());
+	if (cache_entry_index >= 0) {
+		cache_entries_[cache_entry_index] = cache_entry;
+	} else {
+		cache_entries_.push_back(cache_entry);
+	}
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
@@ -0,0 +1,91 @@
+/**\file keypoint_descriptors_cache.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/keypoint_descriptors_cache.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <KeypointDescriptorsCache-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void KeypointDescriptorsCache<PointT>::invalidateDescriptors(const PointCloudConstPtr& pointcloud) {
+	for (size_t i = 0; i < cache_entries_.size();) {
+		if (cache_entries_[i].keypoints.get() == pointcloud.get() || cache_entries_[i].surface.get() == pointcloud.get()) {
+			cache_entries_.erase(cache_entries_.begin() + i);
+		} else {
+			++i;
+		}
+	}
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </KeypointDescriptorsCache-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+bool KeypointDescriptorsCache<PointT>::isCacheEntryValid(const CacheEntry& cache_entry) const {
+	// the keypoints and surface clouds may have been reallocated or resized by a pipeline stage
+	return cache_entry.keypoints_data == getPointsData(*cache_entry.keypoints)
+			&& cache_entry.number_of_keypoints == cache_entry.keypoints->size()
+			&& cache_entry.surface_data == getPointsData(*cache_entry.surface)
+			&& cache_entry.number_of_surface_points == cache_entry.surface->size();
+}
+
+
+template<typename PointT>
+int KeypointDescriptorsCache<PointT>::findCacheEntry(const PointCloudConstPtr& keypoints, const PointCloudConstPtr& surface,
+		const std::type_info& descriptor_type, boost::uint64_t descriptor_configuration_hash) {
+	if (!keypoints || !surface) { return -1; }
+
+	for (size_t i = 0; i < cache_entries_.size(); ++i) {
+		if (cache_entries_[i].keypoints.get() == keypoints.get() && cache_entries_[i].surface.get() == surface.get()
+				&& *cache_entries_[i].descriptor_type == descriptor_type && cache_entries_[i].descriptor_configuration_hash == descriptor_configuration_hash) {
+			if (isCacheEntryValid(cache_entries_[i])) {
+				return (int)i;
+			}
+			cache_entries_.erase(cache_entries_.begin() + i);
+			return -1;
+		}
+	}
+	return -1;
+}
+
+
+template<typename PointT>
+void KeypointDescriptorsCache<PointT>::setCacheEntry(const PointCloudConstPtr& keypoints, const PointCloudConstPtr& surface,
+		const std::type_info& descriptor_type, boost::uint64_t descriptor_configuration_hash, const boost::shared_ptr<void>& descriptors) {
+	CacheEntry cache_entry;
+	cache_entry.keypoints = keypoints;
+	cache_entry.keypoints_data = getPointsData(*keypoints);
+	cache_entry.number_of_keypoints = keypoints->size();
+	cache_entry.surface = surface;
+	cache_entry.surface_data = getPointsData(*surface);
+	cache_entry.number_of_surface_points = surface->size();
+	cache_entry.descriptor_type = &descriptor_type;
+	cache_entry.descriptor_configuration_hash = descriptor_configuration_hash;
+	cache_entry.descriptors = descriptors;
+
+	int cache_entry_index = findCacheEntry(keypoints, surface, descriptor_type, descriptor_configuration_hash);
+	if (cache_entry_index >= 0) {
+		cache_entries_[cache_entry_index] = cache_entry;
+	} else {
+		cache_entries_.push_back(cache_entry);
+	}
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
@@ -0,0 +1,204 @@
+/**\file pointcloud2_reader.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/pointcloud2_reader.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+PointCloud2Reader<PointT>::PointCloud2Reader() :
+	cached_message_point_step_(0),
+	field_mapping_valid_(false),
+	copy_full_point_(false),
+	crop_box_enabled_(false),
+	crop_box_min_(Eigen::Vector3f::Zero()),
+	crop_box_max_(Eigen::Vector3f::Zero()),
+	number_of_nans_in_last_pointcloud_(0),
+	number_of_points_outside_crop_box_in_last_pointcloud_(0) {}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <PointCloud2Reader-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+bool PointCloud2Reader<PointT>::read(const sensor_msgs::PointCloud2& pointcloud_msg, pcl::PointCloud<PointT>& pointcloud_out, bool keep_organized_layout) {
+	DRL_TRACE_SCOPE("pointcloud2_reader/read");
+	number_of_nans_in_last_pointcloud_ = 0;
+	number_of_points_outside_crop_box_in_last_pointcloud_ = 0;
+
+	size_t number_of_points = (size_t)pointcloud_msg.width * (size_t)pointcloud_msg.height;
+	if ((size_t)pointcloud_msg.row_step * (size_t)pointcloud_msg.height > pointcloud_msg.data.size() || (size_t)pointcloud_msg.point_step * (size_t)pointcloud_msg.width > (size_t)pointcloud_msg.row_step) {
+		ROS_WARN_STREAM("Discarded PointCloud2 message with " << pointcloud_msg.data.size() << " bytes, which is inconsistent with its layout [ width: " << pointcloud_msg.width << " | height: " << pointcloud_msg.height << " | point_step: " << pointcloud_msg.point_step << " | row_step: " << pointcloud_msg.row_step << " ]");
+		return false;
+	}
+
+	if (!isMessageLayoutCached(pointcloud_msg) && !updateFieldMapping(pointcloud_msg)) {
+		return false;
+	}
+
+	pcl_conversions::toPCL(pointcloud_msg.header, pointcloud_out.header);
+	keep_organized_layout = keep_organized_layout && pointcloud_msg.height > 1;
+
+	if ((bool)pointcloud_msg.is_bigendian != isHostBigEndian()) {
+		// byte swapping is delegated to PCL (rare case in which the sensor and the localization system have different endianness)
+		pcl::PCLPointCloud2 pcl_pointcloud;
+		pcl_conversions::toPCL(pointcloud_msg, pcl_pointcloud);
+		pcl::fromPCLPointCloud2(pcl_pointcloud, pointcloud_out);
+		removeRejectedPoints(pointcloud_out, keep_organized_layout);
+		return true;
+	}
+
+	pointcloud_out.points.clear(); // unmapped fields must keep the PointT default values
+	pointcloud_out.points.resize(number_of_points);
+
+	size_t number_of_accepted_points = 0;
+	const uint32_t point_step = pointcloud_msg.point_step;
+	for (uint32_t row = 0; row < pointcloud_msg.height; ++row) {
+		const uint8_t* message_point_data = &pointcloud_msg.data[(size_t)row * (size_t)pointcloud_msg.row_step];
+		for (uint32_t column = 0; column < pointcloud_msg.width; ++column, message_point_data += point_step) {
+			PointT& point = pointcloud_out.points[number_of_accepted_points];
+			if (copy_full_point_) {
+				std::memcpy(&point, message_point_data, sizeof(PointT));
+			} else {
+				uint8_t* point_data = reinterpret_cast<uint8_t*>(&point);
+				for (size_t i = 0; i < field_copy_blocks_.size(); ++i) {
+					std::memcpy(point_data + field_copy_blocks_[i].point_offset, message_point_data + field_copy_blocks_[i].message_offset, field_copy_blocks_[i].size);
+				}
+			}
+
+			if (isPointAccepted(point)) {
+				++number_of_accepted_points;
+			} else if (keep_organized_layout) {
+				invalidatePoint(point);
+				++number_of_accepted_points;
+			}
+		}
+	}
+
+	pointcloud_out.points.resize(number_of_accepted_points);
+	if (number_of_accepted_points == number_of_points) {
+		pointcloud_out.width = pointcloud_msg.width;
+		pointcloud_out.height = pointcloud_msg.height;
+	} else {
+		pointcloud_out.width = (uint32_t)number_of_accepted_points;
+		pointcloud_out.height = 1;
+	}
+	pointcloud_out.is_dense = !keep_organized_layout || (number_of_nans_in_last_pointcloud_ + number_of_points_outside_crop_box_in_last_pointcloud_) == 0;
+	return true;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </PointCloud2Reader-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+bool PointCloud2Reader<PointT>::isMessageLayoutCached(const sensor_msgs::PointCloud2& pointcloud_msg) const {
+	if (!field_mapping_valid_ || pointcloud_msg.point_step != cached_message_point_step_ || pointcloud_msg.fields.size() != cached_message_fields_.size()) {
+		return false;
+	}
+
+	for (size_t i = 0; i < pointcloud_msg.fields.size(); ++i) {
+		const sensor_msgs::PointField& field = pointcloud_msg.fields[i];
+		const sensor_msgs::PointField& cached_field = cached_message_fields_[i];
+		if (field.offset != cached_field.offset || field.datatype != cached_field.datatype || field.count != cached_field.count || field.name != cached_field.name) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+template<typename PointT>
+bool PointCloud2Reader<PointT>::updateFieldMapping(const sensor_msgs::PointCloud2& pointcloud_msg) {
+	field_mapping_valid_ = false;
+	field_copy_blocks_.clear();
+	cached_message_fields_ = pointcloud_msg.fields;
+	cached_message_point_step_ = pointcloud_msg.point_step;
+
+	std::vector<pcl::PCLPointField> point_fields;
+	pcl::getFields<PointT>(point_fields);
+
+	size_t number_of_xyz_fields_found = 0;
+	for (size_t i = 0; i < point_fields.size(); ++i) {
+		const pcl::PCLPointField& point_field = point_fields[i];
+		for (size_t j = 0; j < pointcloud_msg.fields.size(); ++j) {
+			const sensor_msgs::PointField& message_field = pointcloud_msg.fields[j];
+			if (message_field.name == point_field.name && message_field.datatype == point_field.datatype && message_field.count == point_field.count) {
+				FieldCopyBlock field_copy_block;
+				field_copy_block.message_offset = message_field.offset;
+				field_copy_block.point_offset = point_field.offset;
+				field_copy_block.size = (size_t)pcl::getFieldSize(point_field.datatype) * (size_t)std::max(point_field.count, (uint32_t)1);
+				if (field_copy_block.message_offset + field_copy_block.size <= pointcloud_msg.point_step) {
+					field_copy_blocks_.push_back(field_copy_block);
+					if (point_field.name == "x" || point_field.name == "y" || point_field.name == "z") { ++number_of_xyz_fields_found; }
+				}
+				break;
+			}
+		}
+	}
+
+	if (number_of_xyz_fields_found != 3) {
+		ROS_WARN_STREAM("Discarded PointCloud2 message because it does not have the x, y, z fields with the same type as the localization point type");
+		return false;
+	}
+
+	// merge the fields that have the same relative offsets in the message and in PointT, to copy them with a single memcpy
+	std::sort(field_copy_blocks_.begin(), field_copy_blocks_.end());
+	std::vector<FieldCopyBlock> merged_field_copy_blocks;
+	merged_field_copy_blocks.push_back(field_copy_blocks_[0]);
+	for (size_t i = 1; i < field_copy_blocks_.size(); ++i) {
+		FieldCopyBlock& last_block = merged_field_copy_blocks.back();
+		const FieldCopyBlock& block = field_copy_blocks_[i];
+		if (block.point_offset >= last_block.point_offset && block.message_offset - last_block.message_offset == block.point_offset - last_block.point_offset) {
+			last_block.size = std::max(last_block.size, block.point_offset + block.size - last_block.point_offset);
+		} else {
+			merged_field_copy_blocks.push_back(block);
+		}
+	}
+	field_copy_blocks_.swap(merged_field_copy_blocks);
+
+	copy_full_point_ = (field_copy_blocks_.size() == 1 && field_copy_blocks_[0].message_offset == 0 && field_copy_blocks_[0].point_offset == 0
+			&& field_copy_blocks_[0].size == sizeof(PointT) && pointcloud_msg.point_step == sizeof(PointT));
+	field_mapping_valid_ = true;
+
+	ROS_DEBUG_STREAM("PointCloud2 field mapping updated [ number of copy blocks: " << field_copy_blocks_.size() << " | copy full point: " << (copy_full_point_ ? "true" : "false") << " ]");
+	return true;
+}
+
+
+template<typename PointT>
+void PointCloud2Reader<PointT>::removeRejectedPoints(pcl::PointCloud<PointT>& pointcloud, bool keep_organized_layout) {
+	size_t number_of_points = pointcloud.size();
+	size_t number_of_accepted_points = 0;
+	for (size_t i = 0; i < number_of_points; ++i) {
+		if (isPointAccepted(pointcloud.points[i])) {
+			if (number_of_accepted_points != i) { pointcloud.points[number_of_accepted_points] = pointcloud.points[i]; }
+			++number_of_accepted_points;
+		} else if (keep_organized_layout) {
+			invalidatePoint(pointcloud.points[i]);
+			++number_of_accepted_points;
+		}
+	}
+
+	if (number_of_accepted_points != number_of_points) {
+		pointcloud.points.resize(number_of_accepted_points);
+		pointcloud.width = (uint32_t)number_of_accepted_points;
+		pointcloud.height = 1;
+	}
+	pointcloud.is_dense = !keep_organized_layout || (number_of_nans_in_last_pointcloud_ + number_of_points_outside_crop_box_in_last_pointcloud_) == 0;
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
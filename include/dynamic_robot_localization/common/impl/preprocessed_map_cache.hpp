@@ -0,0 +1,115 @@
+/**\file preprocessed_map_cache.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/preprocessed_map_cache.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <PreprocessedMapCache-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+bool PreprocessedMapCache<PointT>::loadFromFile(const std::string& filename, pcl::PointCloud<PointT>& reference_pointcloud_out, pcl::PointCloud<PointT>& reference_pointcloud_keypoints_out) const {
+	MemoryMappedFile cache_file;
+	if (!cache_file.open(filename) || cache_file.getSize() < sizeof(CacheHeader)) {
+		ROS_DEBUG_STREAM("Preprocessed reference point cloud cache " << filename << " is not available");
+		return false;
+	}
+
+	CacheHeader header, expected_header;
+	std::memcpy(&header, cache_file.getData(), sizeof(CacheHeader));
+	fillHeader(expected_header, (size_t)header.number_of_reference_points, (size_t)header.number_of_keypoints);
+
+	if (std::memcmp(header.magic, expected_header.magic, sizeof(header.magic)) != 0 || header.format_version != expected_header.format_version
+			|| header.point_size != expected_header.point_size || header.point_fields_hash != expected_header.point_fields_hash) {
+		ROS_WARN_STREAM("Discarded preprocessed reference point cloud cache " << filename << " because it has a different format or point type");
+		return false;
+	}
+
+	if (header.source_file_hash != source_file_hash_ || header.configuration_hash != configuration_hash_) {
+		ROS_INFO_STREAM("Discarded preprocessed reference point cloud cache " << filename << " because the reference point cloud file or its preprocessing configuration changed");
+		return false;
+	}
+
+	if (header.data_offset != expected_header.data_offset || cache_file.getSize() != header.data_offset + (header.number_of_reference_points + header.number_of_keypoints) * sizeof(PointT)) {
+		ROS_WARN_STREAM("Discarded preprocessed reference point cloud cache " << filename << " because it is truncated");
+		return false;
+	}
+
+	const char* data = cache_file.getData() + header.data_offset;
+	copyPoints(data, (size_t)header.number_of_reference_points, reference_pointcloud_out);
+	copyPoints(data + header.number_of_reference_points * sizeof(PointT), (size_t)header.number_of_keypoints, reference_pointcloud_keypoints_out);
+	return true;
+}
+
+
+template<typename PointT>
+bool PreprocessedMapCache<PointT>::saveToFile(const std::string& filename, const pcl::PointCloud<PointT>& reference_pointcloud, const pcl::PointCloud<PointT>& reference_pointcloud_keypoints) const {
+	CacheHeader header;
+	fillHeader(header, reference_pointcloud.size(), reference_pointcloud_keypoints.size());
+
+	std::string temporary_filename = filename + ".tmp";
+	std::ofstream cache_file(temporary_filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!cache_file.is_open()) { return false; }
+
+	char padding[CACHE_DATA_ALIGNMENT];
+	std::memset(padding, 0, CACHE_DATA_ALIGNMENT);
+	cache_file.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+	cache_file.write(padding, header.data_offset - sizeof(CacheHeader));
+	if (!reference_pointcloud.empty()) { cache_file.write(reinterpret_cast<const char*>(&reference_pointcloud.points[0]), reference_pointcloud.size() * sizeof(PointT)); }
+	if (!reference_pointcloud_keypoints.empty()) { cache_file.write(reinterpret_cast<const char*>(&reference_pointcloud_keypoints.points[0]), reference_pointcloud_keypoints.size() * sizeof(PointT)); }
+	cache_file.close();
+
+	if (cache_file.fail() || std::rename(temporary_filename.c_str(), filename.c_str()) != 0) {
+		std::remove(temporary_filename.c_str());
+		return false;
+	}
+
+	return true;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </PreprocessedMapCache-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+void PreprocessedMapCache<PointT>::fillHeader(CacheHeader& header, size_t number_of_reference_points, size_t number_of_keypoints) const {
+	std::memset(&header, 0, sizeof(CacheHeader));
+	std::memcpy(header.magic, "DRLMAPC", 8);
+	header.format_version = CACHE_FORMAT_VERSION;
+	header.point_size = sizeof(PointT);
+	header.point_fields_hash = hash_utils::computeHash(pcl::getFieldsList(pcl::PointCloud<PointT>()));
+	header.source_file_hash = source_file_hash_;
+	header.configuration_hash = configuration_hash_;
+	header.number_of_reference_points = number_of_reference_points;
+	header.number_of_keypoints = number_of_keypoints;
+	header.data_offset = ((sizeof(CacheHeader) + CACHE_DATA_ALIGNMENT - 1) / CACHE_DATA_ALIGNMENT) * CACHE_DATA_ALIGNMENT;
+}
+
+
+template<typename PointT>
+void PreprocessedMapCache<PointT>::copyPoints(const char* data, size_t number_of_points, pcl::PointCloud<PointT>& pointcloud_out) {
+	pointcloud_out.resize(number_of_points);
+	if (number_of_points > 0) {
+		std::memcpy(&pointcloud_out.points[0], data, number_of_points * sizeof(PointT));
+	}
+	pointcloud_out.width = (uint32_t)number_of_points;
+	pointcloud_out.height = 1;
+	pointcloud_out.is_dense = true;
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
@@ -0,0 +1,126 @@
+#pragma once
+
+/**\file incremental_kdtree.h
+ * \brief Kd-tree search method that allows incremental insertion of points without rebuilding the index of the full point cloud.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// ROS includes
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/search/kdtree.h>
+
+// external libs includes
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <boost/thread/tss.hpp>
+
+// project includes
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// ############################################################################   IncrementalKdTree   ##########################################################################
+/**
+ * \brief Kd-tree that indexes a growing point cloud using a main tree (built with the points available at the last rebalance) and a forest of small trees with the points appended after it.
+ * The small trees are kept with decreasing sizes (logarithmic method), so each update only indexes the new points and merges them with the small trees that are not larger,
+ * which keeps the amortized insertion cost logarithmic and the number of small trees logarithmic in the number of new points.
+ * The main tree is rebuilt lazily when the number of new points exceeds the configured ratio of the points in the main tree.
+ * The returned indices are always relative to the input cloud, so it can be shared by all the matchers that use the reference cloud.
+ */
+template <typename PointT>
+class IncrementalKdTree : public pcl::search::KdTree<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <typedefs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		typedef boost::shared_ptr< IncrementalKdTree<PointT> > Ptr;
+		typedef boost::shared_ptr< const IncrementalKdTree<PointT> > ConstPtr;
+		typedef typename pcl::search::KdTree<PointT>::PointCloudConstPtr PointCloudConstPtr;
+		typedef typename pcl::search::KdTree<PointT>::IndicesConstPtr IndicesConstPtr;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </typedefs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		explicit IncrementalKdTree(bool sorted = true);
+		virtual ~IncrementalKdTree() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IncrementalKdTree-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		using pcl::search::KdTree<PointT>::nearestKSearch;
+		using pcl::search::KdTree<PointT>::radiusSearch;
+
+		/** \brief Rebuilds the full index (the cloud indices are only used in the main tree). Use updateIndexWithNewPoints when points were only appended to the cloud. */
+		virtual void setInputCloud(const PointCloudConstPtr& cloud, const IndicesConstPtr& indices = IndicesConstPtr());
+
+		/** \brief Indexes the points that were appended to the input cloud after the last update in a new small tree (rebalancing the index if needed). */
+		void updateIndexWithNewPoints();
+
+		/** \brief Rebuilds the main tree with all the indexed points. */
+		void rebalance();
+
+		virtual int nearestKSearch(const PointT& point, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const;
+		virtual int radiusSearch(const PointT& point, double radius, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances, unsigned int max_nn = 0) const;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IncrementalKdTree-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline size_t getNumberOfPointsInMainTree() const { return number_of_points_in_main_tree_; }
+		inline size_t getNumberOfNewPoints() const { return number_of_new_points_; }
+		inline size_t getNumberOfNewPointsTrees() const { return new_points_trees_.size(); }
+		inline double getMaxRatioOfNewPointsBeforeRebalance() const { return max_ratio_of_new_points_before_rebalance_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline void setMaxRatioOfNewPointsBeforeRebalance(double ratio) { max_ratio_of_new_points_before_rebalance_ = ratio; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		struct NewPointsTree {
+			typename pcl::search::KdTree<PointT>::Ptr search_method;
+			boost::shared_ptr< std::vector<int> > indices;
+		};
+
+		/** \brief Per thread buffers used to merge the results of the small trees without allocating memory on each query. */
+		struct SearchBuffers {
+			std::vector<int> tree_indices;
+			std::vector<float> tree_sqr_distances;
+			std::vector<int> merged_indices;
+			std::vector<float> merged_sqr_distances;
+		};
+
+		bool rebalanceRequired() const;
+		SearchBuffers& getSearchBuffers() const;
+		void mergeSearchResults(const std::vector<int>& first_indices, const std::vector<float>& first_sqr_distances,
+				const std::vector<int>& second_indices, const std::vector<float>& second_sqr_distances,
+				size_t max_number_of_results, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const;
+
+		PointCloudConstPtr cloud_;
+		IndicesConstPtr cloud_indices_;
+		std::vector<NewPointsTree> new_points_trees_;
+		mutable boost::thread_specific_ptr<SearchBuffers> search_buffers_;
+		size_t number_of_new_points_;
+		size_t number_of_points_in_main_tree_;
+		size_t number_of_indexed_points_;
+		double max_ratio_of_new_points_before_rebalance_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/common/impl/incremental_kdtree.hpp>
+#endif
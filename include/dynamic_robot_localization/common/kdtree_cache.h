@@ -0,0 +1,100 @@
+#pragma once
+
+/**\file kdtree_cache.h
+ * \brief Cache of kd-trees that allows the pipeline stages of a scan cycle to share the search structure of the same point cloud.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <vector>
+
+// ROS includes
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/search/kdtree.h>
+
+// external libs includes
+#include <boost/smart_ptr/shared_ptr.hpp>
+
+// project includes
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// ###############################################################################   KdTreeCache   #############################################################################
+/**
+ * \brief Keeps the kd-trees built for the point clouds of a scan cycle, indexed by the cloud identity and version (address and size of its points buffer).
+ * A kd-tree is only built when a stage requests it for a point cloud that was not indexed yet or that was changed (in which case the old kd-tree is discarded).
+ * Point clouds that are changed in place without reallocating their points buffer must be explicitly invalidated.
+ * The cache keeps a reference to the indexed point clouds, so it should be cleared at the start of each scan cycle.
+ */
+template <typename PointT>
+class KdTreeCache {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <typedefs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		typedef boost::shared_ptr< KdTreeCache<PointT> > Ptr;
+		typedef boost::shared_ptr< const KdTreeCache<PointT> > ConstPtr;
+		typedef typename pcl::PointCloud<PointT>::ConstPtr PointCloudConstPtr;
+		typedef typename pcl::search::KdTree<PointT>::Ptr KdTreePtr;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </typedefs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		KdTreeCache() : number_of_cache_hits_(0), number_of_kdtree_builds_(0) {}
+		virtual ~KdTreeCache() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <KdTreeCache-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		/** \brief Returns the cached kd-tree of the point cloud (building it if the cloud was not indexed yet or was changed). */
+		KdTreePtr getSearchMethod(const PointCloudConstPtr& pointcloud);
+
+		/** \brief Adds (or updates) a kd-tree that was built outside the cache (it is associated with the kd-tree input cloud). */
+		void addSearchMethod(const KdTreePtr& search_method);
+
+		/** \brief Discards the kd-tree of a point cloud that was changed in place. */
+		void invalidateSearchMethod(const PointCloudConstPtr& pointcloud);
+
+		void clear() { cache_entries_.clear(); }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </KdTreeCache-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline size_t getNumberOfCachedSearchMethods() const { return cache_entries_.size(); }
+		inline size_t getNumberOfCacheHits() const { return number_of_cache_hits_; }
+		inline size_t getNumberOfKdTreeBuilds() const { return number_of_kdtree_builds_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		struct CacheEntry {
+			PointCloudConstPtr pointcloud;
+			const PointT* points_data;
+			size_t number_of_points;
+			KdTreePtr search_method;
+		};
+
+		static inline const PointT* getPointsData(const pcl::PointCloud<PointT>& pointcloud) { return pointcloud.points.empty() ? NULL : &pointcloud.points[0]; }
+		bool isCacheEntryValid(const CacheEntry& cache_entry) const;
+		int findCacheEntry(const pcl::PointCloud<PointT>* pointcloud) const;
+		void setCacheEntry(const KdTreePtr& search_method);
+
+		std::vector<CacheEntry> cache_entries_;
+		size_t number_of_cache_hits_;
+		size_t number_of_kdtree_builds_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/common/impl/kdtree_cache.hpp>
+#endif
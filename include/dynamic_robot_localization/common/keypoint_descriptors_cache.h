@@ -0,0 +1,120 @@
+#pragma once
+
+/**\file keypoint_descriptors_cache.h
+ * \brief Cache of keypoint descriptors that allows the feature matchers of a scan cycle to share the descriptors computed for the same keypoints.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <typeinfo>
+#include <vector>
+
+// ROS includes
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+// external libs includes
+#include <boost/cstdint.hpp>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <boost/pointer_cast.hpp>
+
+// project includes
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// ########################################################################   KeypointDescriptorsCache   ########################################################################
+/**
+ * \brief Keeps the descriptors computed for the keypoints of a scan cycle, indexed by the identity and version of the keypoints and surface clouds
+ * (address and size of their points buffers), the descriptor type and the hash of the descriptor configuration.
+ * Feature matchers with the same descriptor configuration that run on the same keypoints (for example, tracking and tracking recovery) reuse the descriptors instead of recomputing them.
+ * Point clouds that are changed in place without reallocating their points buffer must be explicitly invalidated.
+ * The cache keeps a reference to the clouds and descriptors, so it should be cleared at the start of each scan cycle.
+ */
+template <typename PointT>
+class KeypointDescriptorsCache {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <typedefs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		typedef boost::shared_ptr< KeypointDescriptorsCache<PointT> > Ptr;
+		typedef boost::shared_ptr< const KeypointDescriptorsCache<PointT> > ConstPtr;
+		typedef typename pcl::PointCloud<PointT>::ConstPtr PointCloudConstPtr;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </typedefs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		KeypointDescriptorsCache() : number_of_cache_hits_(0) {}
+		virtual ~KeypointDescriptorsCache() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <KeypointDescriptorsCache-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		/** \brief Returns the cached descriptors of the keypoints (or a null pointer if they were not computed yet with the same surface and configuration). */
+		template <typename FeatureT>
+		typename pcl::PointCloud<FeatureT>::Ptr getDescriptors(const PointCloudConstPtr& keypoints, const PointCloudConstPtr& surface, boost::uint64_t descriptor_configuration_hash) {
+			int cache_entry_index = findCacheEntry(keypoints, surface, typeid(FeatureT), descriptor_configuration_hash);
+			if (cache_entry_index >= 0) {
+				++number_of_cache_hits_;
+				return boost::static_pointer_cast< pcl::PointCloud<FeatureT> >(cache_entries_[cache_entry_index].descriptors);
+			}
+			return typename pcl::PointCloud<FeatureT>::Ptr();
+		}
+
+		/** \brief Adds (or updates) the descriptors computed for the keypoints. */
+		template <typename FeatureT>
+		void addDescriptors(const PointCloudConstPtr& keypoints, const PointCloudConstPtr& surface, boost::uint64_t descriptor_configuration_hash,
+				const typename pcl::PointCloud<FeatureT>::Ptr& descriptors) {
+			if (keypoints && surface && descriptors) {
+				setCacheEntry(keypoints, surface, typeid(FeatureT), descriptor_configuration_hash, boost::static_pointer_cast<void>(descriptors));
+			}
+		}
+
+		/** \brief Discards the descriptors that were computed for (or with the surface of) a point cloud that was changed in place. */
+		void invalidateDescriptors(const PointCloudConstPtr& pointcloud);
+
+		void clear() { cache_entries_.clear(); }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </KeypointDescriptorsCache-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline size_t getNumberOfCachedDescriptors() const { return cache_entries_.size(); }
+		inline size_t getNumberOfCacheHits() const { return number_of_cache_hits_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		struct CacheEntry {
+			PointCloudConstPtr keypoints;
+			const PointT* keypoints_data;
+			size_t number_of_keypoints;
+			PointCloudConstPtr surface;
+			const PointT* surface_data;
+			size_t number_of_surface_points;
+			const std::type_info* descriptor_type;
+			boost::uint64_t descriptor_configuration_hash;
+			boost::shared_ptr<void> descriptors;
+		};
+
+		static inline const PointT* getPointsData(const pcl::PointCloud<PointT>& pointcloud) { return pointcloud.points.empty() ? NULL : &pointcloud.points[0]; }
+		bool isCacheEntryValid(const CacheEntry& cache_entry) const;
+		int findCacheEntry(const PointCloudConstPtr& keypoints, const PointCloudConstPtr& surface, const std::type_info& descriptor_type, boost::uint64_t descriptor_configuration_hash);
+		void setCacheEntry(const PointCloudConstPtr& keypoints, const PointCloudConstPtr& surface, const std::type_info& descriptor_type, boost::uint64_t descriptor_configuration_hash,
+				const boost::shared_ptr<void>& descriptors);
+
+		std::vector<CacheEntry> cache_entries_;
+		size_t number_of_cache_hits_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/common/impl/keypoint_descriptors_cache.hpp>
+#endif
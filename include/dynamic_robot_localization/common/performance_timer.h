@@ -5,7 +5,7 @@
 #ifdef _WIN32   // Windows system specific
 	#include <windows.h>
 #else           // Unix based system specific
-	#include <sys/time.h>
+	#include <time.h>
 #endif
 
 #include <stdlib.h>
@@ -42,8 +42,8 @@ class PerformanceTimer {
 			LARGE_INTEGER startCountWin;
 			LARGE_INTEGER endCountWin;
 		#else
-			timeval startCount;
-			timeval endCount;
+			timespec startCount;                  // monotonic clock (immune to system time adjustments)
+			timespec endCount;
 		#endif
 
 		void calculateElapsedTimeMicroSec();
@@ -0,0 +1,138 @@
+#pragma once
+
+/**\file pointcloud2_reader.h
+ * \brief Conversion of sensor_msgs::PointCloud2 to pcl::PointCloud reading the message buffer in place and removing NaNs / out of bounds points in the same pass.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+// ROS includes
+#include <ros/console.h>
+#include <sensor_msgs/PointCloud2.h>
+#include <sensor_msgs/PointField.h>
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/PCLPointField.h>
+#include <pcl/common/io.h>
+#include <pcl_conversions/pcl_conversions.h>
+
+// external libs includes
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <Eigen/Core>
+
+// project includes
+#include <dynamic_robot_localization/common/tracer.h>
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// ############################################################################   PointCloud2Reader   ##########################################################################
+/**
+ * \brief Replaces pcl::fromROSMsg + pcl::removeNaNFromPointCloud with a single pass over the message buffer.
+ * The mapping between the message fields and the PointT fields is computed only when the message layout changes,
+ * and each point is copied with one memcpy per contiguous block of matching fields (or a single memcpy when the layouts are identical).
+ * Points with NaN coordinates or outside the optional axis aligned crop box are overwritten by the next point, so the output cloud is compacted during the copy.
+ */
+template <typename PointT>
+class PointCloud2Reader {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <typedefs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		typedef boost::shared_ptr< PointCloud2Reader<PointT> > Ptr;
+		typedef boost::shared_ptr< const PointCloud2Reader<PointT> > ConstPtr;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </typedefs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		PointCloud2Reader();
+		virtual ~PointCloud2Reader() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <PointCloud2Reader-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		/**
+		 * \brief Converts the message into pointcloud_out, keeping only the points with finite coordinates (and inside the crop box if it is enabled).
+		 * If keep_organized_layout is true and the message is organized, the rejected points are kept with NaN coordinates, in order to preserve the image layout.
+		 */
+		bool read(const sensor_msgs::PointCloud2& pointcloud_msg, pcl::PointCloud<PointT>& pointcloud_out, bool keep_organized_layout = false);
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </PointCloud2Reader-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline size_t getNumberOfNaNsInLastPointCloud() const { return number_of_nans_in_last_pointcloud_; }
+		inline size_t getNumberOfPointsOutsideCropBoxInLastPointCloud() const { return number_of_points_outside_crop_box_in_last_pointcloud_; }
+		inline bool isCropBoxEnabled() const { return crop_box_enabled_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline void setCropBox(const Eigen::Vector3f& box_min, const Eigen::Vector3f& box_max) { crop_box_min_ = box_min; crop_box_max_ = box_max; crop_box_enabled_ = true; }
+		inline void disableCropBox() { crop_box_enabled_ = false; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		struct FieldCopyBlock {
+			size_t message_offset;
+			size_t point_offset;
+			size_t size;
+			bool operator<(const FieldCopyBlock& other) const { return message_offset < other.message_offset; }
+		};
+
+		static inline bool isHostBigEndian() {
+			const uint16_t value = 1;
+			return *reinterpret_cast<const uint8_t*>(&value) == 0;
+		}
+
+		bool isMessageLayoutCached(const sensor_msgs::PointCloud2& pointcloud_msg) const;
+		bool updateFieldMapping(const sensor_msgs::PointCloud2& pointcloud_msg);
+		void removeRejectedPoints(pcl::PointCloud<PointT>& pointcloud, bool keep_organized_layout = false);
+
+		static inline void invalidatePoint(PointT& point) {
+			point.x = point.y = point.z = std::numeric_limits<float>::quiet_NaN();
+		}
+
+		inline bool isPointAccepted(const PointT& point) {
+			if (!pcl_isfinite(point.x) || !pcl_isfinite(point.y) || !pcl_isfinite(point.z)) {
+				++number_of_nans_in_last_pointcloud_;
+				return false;
+			}
+
+			if (crop_box_enabled_ && (point.x < crop_box_min_.x() || point.y < crop_box_min_.y() || point.z < crop_box_min_.z() ||
+					point.x > crop_box_max_.x() || point.y > crop_box_max_.y() || point.z > crop_box_max_.z())) {
+				++number_of_points_outside_crop_box_in_last_pointcloud_;
+				return false;
+			}
+
+			return true;
+		}
+
+		std::vector<sensor_msgs::PointField> cached_message_fields_;
+		uint32_t cached_message_point_step_;
+		bool field_mapping_valid_;
+		bool copy_full_point_;
+		std::vector<FieldCopyBlock> field_copy_blocks_;
+		bool crop_box_enabled_;
+		Eigen::Vector3f crop_box_min_;
+		Eigen::Vector3f crop_box_max_;
+		size_t number_of_nans_in_last_pointcloud_;
+		size_t number_of_points_outside_crop_box_in_last_pointcloud_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/common/impl/pointcloud2_reader.hpp>
+#endif
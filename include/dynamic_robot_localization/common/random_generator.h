@@ -0,0 +1,91 @@
+#pragma once
+
+/**\file random_generator.h
+ * \brief Small and fast seedable pseudo random number generator (xoroshiro128+) that can be used by each thread without locking.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <ctime>
+
+// ROS includes
+
+// PCL includes
+
+// external libs includes
+#include <boost/cstdint.hpp>
+#include <boost/atomic.hpp>
+
+// project includes
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// #############################################################################   RandomGenerator   ###########################################################################
+/**
+ * \brief xoroshiro128+ generator (http://xoshiro.di.unimi.it) with the state initialized with splitmix64.
+ * Each thread should use its own instance. Reseeding with (seed, counter) gives independent and reproducible streams,
+ * which allows parallel loops to generate the same random numbers in each iteration regardless of the number of threads.
+ */
+class RandomGenerator {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		explicit RandomGenerator(boost::uint64_t seed = 0, boost::uint64_t counter = 0) { setSeed(seed, counter); }
+		virtual ~RandomGenerator() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <RandomGenerator-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline void setSeed(boost::uint64_t seed, boost::uint64_t counter = 0) {
+			boost::uint64_t splitmix_state = seed ^ (counter * 0xd1b54a32d192ed03ULL);
+			state_[0] = splitMix64(splitmix_state);
+			state_[1] = splitMix64(splitmix_state);
+			if (state_[0] == 0 && state_[1] == 0) { state_[1] = 1; } // all zeros state is invalid
+		}
+
+		inline boost::uint64_t next() {
+			const boost::uint64_t s0 = state_[0];
+			boost::uint64_t s1 = state_[1];
+			const boost::uint64_t result = s0 + s1;
+			s1 ^= s0;
+			state_[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16);
+			state_[1] = rotl(s1, 37);
+			return result;
+		}
+
+		/** \brief Random number in [0, 1[ */
+		inline double nextDouble() { return (double)(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+		/** \brief Random index in [0, n-1] */
+		inline int getRandomIndex(int n) { return static_cast<int>(n * nextDouble()); }
+
+		/** \brief Seed that changes in each call, for when reproducibility is not required */
+		static inline boost::uint64_t generateSeed() {
+			static boost::atomic<boost::uint64_t> number_of_calls(0); // can be called concurrently by the matchers threads
+			boost::uint64_t state = (boost::uint64_t)std::time(NULL) ^ ((boost::uint64_t)std::clock() << 32) ^ (++number_of_calls * 0x9e3779b97f4a7c15ULL);
+			return splitMix64(state);
+		}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </RandomGenerator-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		static inline boost::uint64_t rotl(const boost::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+		static inline boost::uint64_t splitMix64(boost::uint64_t& state) {
+			boost::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			return z ^ (z >> 31);
+		}
+
+		boost::uint64_t state_[2];
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
@@ -0,0 +1,167 @@
+#pragma once
+
+/**\file tracer.h
+ * \brief Low overhead tracing of the localization stages, with per thread ring buffers, Chrome trace export and latency histograms.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#define DRL_TRACE_CONCATENATE_IMPL(prefix, line) prefix##line
+#define DRL_TRACE_CONCATENATE(prefix, line) DRL_TRACE_CONCATENATE_IMPL(prefix, line)
+
+/** \brief Traces the enclosing scope (span_name must be a constant string, since its id is only computed once) */
+#define DRL_TRACE_SCOPE(span_name) \
+	static const boost::uint32_t DRL_TRACE_CONCATENATE(drl_trace_span_id_, __LINE__) = dynamic_robot_localization::Tracer::getInstance().getSpanId(span_name); \
+	dynamic_robot_localization::TraceSpan DRL_TRACE_CONCATENATE(drl_trace_span_, __LINE__)(DRL_TRACE_CONCATENATE(drl_trace_span_id_, __LINE__))
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+// ROS includes
+
+// PCL includes
+
+// external libs includes
+#include <boost/cstdint.hpp>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+// project includes
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// ###################################################################################   Tracer   ##############################################################################
+/**
+ * \brief Records the start time and duration of named spans in a fixed size ring buffer per thread (no allocations or contended locks after the first span of each thread).
+ * The recorded spans can be exported to the Chrome trace format (chrome://tracing or https://ui.perfetto.dev) and summarized in latency histograms,
+ * which are rolling because the ring buffers only keep the most recent spans.
+ */
+class Tracer {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constants>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		static const size_t NUMBER_OF_HISTOGRAM_BINS = 24; // bin i has the spans with durations in [2^i, 2^(i+1)[ microseconds (the first bin also has the spans shorter than 1 us)
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constants>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		struct TraceEvent {
+			boost::uint32_t span_id;
+			boost::uint64_t start_time_ns;
+			boost::uint64_t duration_ns;
+		};
+
+		struct LatencyStatistics {
+			std::string span_name;
+			size_t number_of_samples;
+			double mean_ms;
+			double min_ms;
+			double percentile_50_ms;
+			double percentile_90_ms;
+			double percentile_99_ms;
+			double max_ms;
+			std::vector<size_t> histogram;
+		};
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		static Tracer& getInstance();
+		virtual ~Tracer() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <Tracer-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		/** \brief Monotonic clock (not affected by ntp / system time adjustments) in nanoseconds */
+		static inline boost::uint64_t getMonotonicTimeNs() {
+			#ifdef _WIN32
+				static LARGE_INTEGER frequency = { 0 };
+				if (frequency.QuadPart == 0) { QueryPerformanceFrequency(&frequency); }
+				LARGE_INTEGER count;
+				QueryPerformanceCounter(&count);
+				return (boost::uint64_t)((double)count.QuadPart * (1000000000.0 / (double)frequency.QuadPart));
+			#else
+				timespec time;
+				clock_gettime(CLOCK_MONOTONIC, &time);
+				return (boost::uint64_t)time.tv_sec * 1000000000ULL + (boost::uint64_t)time.tv_nsec;
+			#endif
+		}
+
+		boost::uint32_t getSpanId(const std::string& span_name);
+		void recordEvent(boost::uint32_t span_id, boost::uint64_t start_time_ns, boost::uint64_t end_time_ns);
+		void setCurrentThreadName(const std::string& thread_name);
+		void clear();
+
+		/** \brief Exports the spans in the ring buffers to a json file in the Chrome trace event format */
+		bool exportChromeTrace(const std::string& filename);
+
+		/** \brief Computes the latency statistics of each span using the events that started in the last window_seconds (0 -> all the events in the ring buffers) */
+		void computeLatencyStatistics(std::vector<LatencyStatistics>& latency_statistics_out, double window_seconds = 0.0);
+		std::string getLatencyStatisticsReport(double window_seconds = 0.0);
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </Tracer-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline bool isEnabled() const { return enabled_; }
+		inline size_t getRingBufferCapacity() const { return ring_buffer_capacity_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline void setEnabled(bool enabled) { enabled_ = enabled; }
+		void setRingBufferCapacity(size_t ring_buffer_capacity);
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		struct ThreadRingBuffer {
+			boost::mutex mutex; // only contended while exporting
+			std::vector<TraceEvent> events;
+			size_t next_event_index;
+			size_t number_of_events;
+			size_t thread_index;
+			std::string thread_name;
+		};
+
+		Tracer();
+		ThreadRingBuffer& getThreadRingBuffer();
+		void collectEvents(std::vector< std::pair<size_t, TraceEvent> >& events_out, boost::uint64_t minimum_start_time_ns = 0);
+		static void releaseThreadRingBuffer(ThreadRingBuffer*) {} // ring buffers are owned by thread_ring_buffers_, to keep the events of threads that already finished
+
+		volatile bool enabled_;
+		size_t ring_buffer_capacity_;
+		boost::mutex registry_mutex_;
+		std::vector<std::string> span_names_;
+		std::map<std::string, boost::uint32_t> span_ids_;
+		std::vector< boost::shared_ptr<ThreadRingBuffer> > thread_ring_buffers_;
+		boost::thread_specific_ptr<ThreadRingBuffer> current_thread_ring_buffer_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+
+// #################################################################################   TraceSpan   #############################################################################
+/**
+ * \brief Records the lifetime of the object as a span in the Tracer (it only reads the clock when tracing is enabled).
+ * The span ids must be interned with Tracer::getSpanId at configuration time, because that lookup locks the registry of span names.
+ */
+class TraceSpan {
+	public:
+		explicit TraceSpan(boost::uint32_t span_id) : span_id_(span_id), start_time_ns_(Tracer::getInstance().isEnabled() ? Tracer::getMonotonicTimeNs() : 0) {}
+
+		~TraceSpan() {
+			if (start_time_ns_ != 0) { Tracer::getInstance().recordEvent(span_id_, start_time_ns_, Tracer::getMonotonicTimeNs()); }
+		}
+
+	protected:
+		boost::uint32_t span_id_;
+		boost::uint64_t start_time_ns_;
+};
+
+} /* namespace dynamic_robot_localization */
@@ -45,6 +45,7 @@ Localization<PointT>::Localization() :
 	compute_keypoints_when_estimating_initial_pose_(true),
 	compute_inliers_angular_distribution_(true),
 	compute_outliers_angular_distribution_(true),
+	compute_angular_distribution_during_outlier_detection_(true),
 	inliers_angular_distribution_(-1.0),
 	outliers_angular_distribution_(-1.0),
 	last_pose_weighted_mean_filter_(-1.0),
@@ -63,6 +64,7 @@ Localization<PointT>::Localization() :
 	ignore_height_corrections_(false),
 	last_accepted_pose_valid_(false),
 	last_accepted_pose_performed_tracking_reset_(false),
+	angular_distribution_computed_during_outlier_detection_(false),
 	received_external_initial_pose_estimation_(false),
 	use_internal_tracking_(true),
 	last_accepted_pose_base_link_to_map_(tf2::Transform::getIdentity()),
@@ -72,6 +74,7 @@ Localization<PointT>::Localization() :
 	reference_pointcloud_keypoints_(new pcl::PointCloud<PointT>()),
 	last_number_points_inserted_in_circular_buffer_(0),
 	reference_pointcloud_search_method_(new pcl::search::KdTree<PointT>()),
+	ambient_keypoints_descriptors_cache_(new KeypointDescriptorsCache<PointT>()),
 	number_of_registration_iterations_for_all_matchers_(0),
 	correspondence_estimation_time_for_all_matchers_(0),
 	transformation_estimation_time_for_all_matchers_(0),
@@ -82,7 +85,21 @@ Localization<PointT>::Localization() :
 	outlier_percentage_(0.0),
 	number_inliers_(0),
 	root_mean_square_error_inliers_(0.0),
-	publish_aligned_pointcloud_only_if_there_is_subscribers_(true) {}
+	publish_aligned_pointcloud_only_if_there_is_subscribers_(true),
+	use_pipelined_processing_(false),
+	pipelined_processing_queue_size_(2),
+	pipelined_processing_max_translation_correction_(0.1),
+	pipelined_processing_max_rotation_correction_(0.05),
+	pipelined_processing_sensors_synchronization_time_window_(0.0),
+	pipelined_processing_odom_to_map_(tf2::Transform::getIdentity()),
+	multi_hypothesis_tracking_recovery_enabled_(false),
+	multi_hypothesis_tracking_recovery_number_of_hypotheses_(16),
+	multi_hypothesis_tracking_recovery_linear_uncertainty_(0.2),
+	multi_hypothesis_tracking_recovery_linear_uncertainty_per_meter_travelled_(0.1),
+	multi_hypothesis_tracking_recovery_angular_uncertainty_(0.1),
+	multi_hypothesis_tracking_recovery_angular_uncertainty_per_radian_rotated_(0.2),
+	multi_hypothesis_tracking_recovery_inliers_max_distance_(0.05),
+	multi_hypothesis_tracking_recovery_max_number_of_validated_hypotheses_(3) {}
 
 template<typename PointT>
 Localization<PointT>::~Localization() {}
@@ -123,6 +140,12 @@ void Localization<PointT>::setupConfigurationFromParameterServer(ros::NodeHandle
 	tracking_recovery_matchers_.clear();
 	setupFeatureCloudMatchersConfigurations(tracking_recovery_matchers_, "tracking_recovery_matchers/feature_matchers/");
 	setupPointCloudMatchersConfigurations(tracking_recovery_matchers_, "tracking_recovery_matchers/point_matchers/");
+	setupMultiHypothesisTrackingRecovery();
+
+	ambient_keypoints_descriptors_cache_->clear();
+	setupKeypointDescriptorsCache(initial_pose_estimators_feature_matchers_);
+	setupKeypointDescriptorsCache(tracking_matchers_);
+	setupKeypointDescriptorsCache(tracking_recovery_matchers_); // the multi hypothesis matchers run in parallel on their own clouds
 
 	setupTransformationValidatorsConfigurations(transformation_validators_, "transformation_validators/");
 	setupTransformationValidatorsConfigurations(transformation_validators_tracking_recovery_, "transformation_validators_tracking_recovery/");
@@ -131,6 +154,8 @@ void Localization<PointT>::setupConfigurationFromParameterServer(ros::NodeHandle
 	setupRegistrationCovarianceEstimatorsConfigurations();
 
 	updateNormalsEstimationFlags();
+	setupPipelinedProcessing();
+	setupTracing();
 
 	pose_to_tf_publisher_->setupConfigurationFromParameterServer(node_handle, private_node_handle, "");
 	pose_to_tf_publisher_->setBaseLinkFrameId(base_link_frame_id_);
@@ -275,6 +300,21 @@ void Localization<PointT>::setupMessageManagement() {
 		ambient_pointcloud_with_circular_buffer_.reset(new CircularBufferPointCloud<PointT>(maximum_number_points_ambient_pointcloud_circular_buffer));
 	}
 
+	bool ambient_pointcloud_ingestion_crop_box_enabled;
+	private_node_handle_->param("message_management/ambient_pointcloud_ingestion_crop_box/enabled", ambient_pointcloud_ingestion_crop_box_enabled, false);
+	if (ambient_pointcloud_ingestion_crop_box_enabled) {
+		double box_min_x, box_min_y, box_min_z, box_max_x, box_max_y, box_max_z;
+		private_node_handle_->param("message_management/ambient_pointcloud_ingestion_crop_box/box_min_x", box_min_x, -100.0);
+		private_node_handle_->param("message_management/ambient_pointcloud_ingestion_crop_box/box_min_y", box_min_y, -100.0);
+		private_node_handle_->param("message_management/ambient_pointcloud_ingestion_crop_box/box_min_z", box_min_z, -100.0);
+		private_node_handle_->param("message_management/ambient_pointcloud_ingestion_crop_box/box_max_x", box_max_x, 100.0);
+		private_node_handle_->param("message_management/ambient_pointcloud_ingestion_crop_box/box_max_y", box_max_y, 100.0);
+		private_node_handle_->param("message_management/ambient_pointcloud_ingestion_crop_box/box_max_z", box_max_z, 100.0);
+		ambient_pointcloud_reader_.setCropBox(Eigen::Vector3f(box_min_x, box_min_y, box_min_z), Eigen::Vector3f(box_max_x, box_max_y, box_max_z));
+	} else {
+		ambient_pointcloud_reader_.disableCropBox();
+	}
+
 	private_node_handle_->param("message_management/localization_detailed_use_millimeters_in_root_mean_square_error_inliers", localization_detailed_use_millimeters_in_root_mean_square_error_inliers_, false);
 	private_node_handle_->param("message_management/localization_detailed_use_millimeters_in_translation_corrections", localization_detailed_use_millimeters_in_translation_corrections_, false);
 	private_node_handle_->param("message_management/localization_detailed_use_degrees_in_rotation_corrections", localization_detailed_use_degrees_in_rotation_corrections_, false);
@@ -286,6 +326,7 @@ template<typename PointT>
 void Localization<PointT>::setupReferencePointCloud() {
 	private_node_handle_->param("reference_pointclouds/reference_pointcloud_filename", reference_pointcloud_filename_, std::string(""));
 	private_node_handle_->param("reference_pointclouds/reference_pointcloud_preprocessed_save_filename", reference_pointcloud_preprocessed_save_filename_, std::string(""));
+	private_node_handle_->param("reference_pointclouds/reference_pointcloud_preprocessed_cache_filename", reference_pointcloud_preprocessed_cache_filename_, std::string(""));
 	private_node_handle_->param("reference_pointclouds/save_reference_pointclouds_in_binary_format", save_reference_pointclouds_in_binary_format_, true);
 	private_node_handle_->param("reference_pointclouds/minimum_number_of_points_in_reference_pointcloud", minimum_number_of_points_in_reference_pointcloud_, 10);
 
@@ -312,10 +353,108 @@ void Localization<PointT>::setupReferencePointCloud() {
 	}
 
 	private_node_handle_->param("reference_pointclouds/use_incremental_map_update", use_incremental_map_update_, false);
+	if (use_incremental_map_update_) {
+		double max_ratio_of_new_points_before_rebalance;
+		private_node_handle_->param("reference_pointclouds/incremental_map_update_max_ratio_of_new_points_before_rebalance", max_ratio_of_new_points_before_rebalance, 0.25);
+		reference_pointcloud_incremental_search_method_ = typename IncrementalKdTree<PointT>::Ptr(new IncrementalKdTree<PointT>());
+		reference_pointcloud_incremental_search_method_->setMaxRatioOfNewPointsBeforeRebalance(max_ratio_of_new_points_before_rebalance);
+		reference_pointcloud_search_method_ = reference_pointcloud_incremental_search_method_;
+	} else {
+		reference_pointcloud_incremental_search_method_.reset();
+		reference_pointcloud_search_method_ = typename pcl::search::KdTree<PointT>::Ptr(new pcl::search::KdTree<PointT>());
+	}
 	reference_pointcloud_->header.frame_id = map_frame_id_;
 }
 
 
+template<typename PointT>
+void Localization<PointT>::setupPipelinedProcessing() {
+	private_node_handle_->param("message_management/pipelined_processing/enabled", use_pipelined_processing_, false);
+	private_node_handle_->param("message_management/pipelined_processing/queue_size", pipelined_processing_queue_size_, 2);
+	private_node_handle_->param("message_management/pipelined_processing/max_translation_correction_for_preprocessed_scans", pipelined_processing_max_translation_correction_, 0.1);
+	private_node_handle_->param("message_management/pipelined_processing/max_rotation_correction_for_preprocessed_scans", pipelined_processing_max_rotation_correction_, 0.05);
+	private_node_handle_->param("message_management/pipelined_processing/sensors_synchronization_time_window", pipelined_processing_sensors_synchronization_time_window_, 0.0);
+	if (pipelined_processing_queue_size_ < 1) { pipelined_processing_queue_size_ = 1; }
+}
+
+
+template<typename PointT>
+void Localization<PointT>::setupMultiHypothesisTrackingRecovery() {
+	int number_of_threads;
+	private_node_handle_->param("tracking_recovery_matchers/multi_hypothesis/enabled", multi_hypothesis_tracking_recovery_enabled_, false);
+	private_node_handle_->param("tracking_recovery_matchers/multi_hypothesis/number_of_threads", number_of_threads, 0);
+	private_node_handle_->param("tracking_recovery_matchers/multi_hypothesis/number_of_hypotheses", multi_hypothesis_tracking_recovery_number_of_hypotheses_, 16);
+	private_node_handle_->param("tracking_recovery_matchers/multi_hypothesis/linear_uncertainty", multi_hypothesis_tracking_recovery_linear_uncertainty_, 0.2);
+	private_node_handle_->param("tracking_recovery_matchers/multi_hypothesis/linear_uncertainty_per_meter_travelled", multi_hypothesis_tracking_recovery_linear_uncertainty_per_meter_travelled_, 0.1);
+	private_node_handle_->param("tracking_recovery_matchers/multi_hypothesis/angular_uncertainty", multi_hypothesis_tracking_recovery_angular_uncertainty_, 0.1);
+	private_node_handle_->param("tracking_recovery_matchers/multi_hypothesis/angular_uncertainty_per_radian_rotated", multi_hypothesis_tracking_recovery_angular_uncertainty_per_radian_rotated_, 0.2);
+	private_node_handle_->param("tracking_recovery_matchers/multi_hypothesis/inliers_max_distance", multi_hypothesis_tracking_recovery_inliers_max_distance_, 0.05);
+	private_node_handle_->param("tracking_recovery_matchers/multi_hypothesis/max_number_of_validated_hypotheses", multi_hypothesis_tracking_recovery_max_number_of_validated_hypotheses_, 3);
+
+	multi_hypothesis_tracking_recovery_matchers_.clear();
+	if (!multi_hypothesis_tracking_recovery_enabled_ || tracking_recovery_matchers_.empty() || multi_hypothesis_tracking_recovery_number_of_hypotheses_ < 1) { return; }
+
+	if (number_of_threads <= 0) { number_of_threads = omp_get_max_threads(); }
+	number_of_threads = std::max(1, std::min(number_of_threads, multi_hypothesis_tracking_recovery_number_of_hypotheses_));
+
+	// the matchers keep the state of the last registration, so each thread needs its own copy of the tracking recovery matchers
+	multi_hypothesis_tracking_recovery_matchers_.resize(number_of_threads);
+	for (size_t i = 0; i < multi_hypothesis_tracking_recovery_matchers_.size(); ++i) {
+		setupFeatureCloudMatchersConfigurations(multi_hypothesis_tracking_recovery_matchers_[i], "tracking_recovery_matchers/feature_matchers/");
+		setupPointCloudMatchersConfigurations(multi_hypothesis_tracking_recovery_matchers_[i], "tracking_recovery_matchers/point_matchers/");
+	}
+}
+
+
+template<typename PointT>
+void Localization<PointT>::setupTracing() {
+	bool tracing_enabled;
+	int tracing_ring_buffer_size;
+	private_node_handle_->param("tracing/enabled", tracing_enabled, false);
+	private_node_handle_->param("tracing/ring_buffer_size", tracing_ring_buffer_size, 4096);
+	private_node_handle_->param("tracing/chrome_trace_filename", tracing_chrome_trace_filename_, std::string(""));
+	private_node_handle_->param("tracing/latency_statistics_report_period", tracing_latency_statistics_report_period_, 10.0);
+	private_node_handle_->param("tracing/latency_statistics_window", tracing_latency_statistics_window_, 60.0);
+
+	Tracer& tracer = Tracer::getInstance();
+	if (tracing_ring_buffer_size > 0 && (size_t)tracing_ring_buffer_size != tracer.getRingBufferCapacity()) { tracer.setRingBufferCapacity((size_t)tracing_ring_buffer_size); }
+	tracer.setEnabled(tracing_enabled);
+	if (tracing_enabled) { tracer.setCurrentThreadName("localization"); }
+	tracing_last_report_time_ = ros::WallTime::now();
+}
+
+
+template<typename PointT>
+void Localization<PointT>::publishTracingReports(bool force_report) {
+	Tracer& tracer = Tracer::getInstance();
+	if (!tracer.isEnabled()) { return; }
+
+	ros::WallTime now = ros::WallTime::now();
+	if (!force_report && (tracing_latency_statistics_report_period_ <= 0.0 || (now - tracing_last_report_time_).toSec() < tracing_latency_statistics_report_period_)) { return; }
+	tracing_last_report_time_ = now;
+
+	ROS_INFO_STREAM(tracer.getLatencyStatisticsReport(tracing_latency_statistics_window_));
+	if (!tracing_chrome_trace_filename_.empty() && !tracer.exportChromeTrace(tracing_chrome_trace_filename_)) {
+		ROS_WARN_STREAM("Failed to export the localization trace to " << tracing_chrome_trace_filename_);
+	}
+}
+
+
+template<typename PointT>
+typename Localization<PointT>::AmbientPointCloudPreprocessor::Ptr Localization<PointT>::createAmbientPointCloudPreprocessor(const std::string& topic_name) {
+	typename AmbientPointCloudPreprocessor::Ptr preprocessor(new AmbientPointCloudPreprocessor());
+	preprocessor->topic_name = topic_name;
+	preprocessor->pointcloud_reader = ambient_pointcloud_reader_;
+	loadFiltersFromParameterServer(preprocessor->filters, "filters/ambient_pointcloud/");
+	loadFiltersFromParameterServer(preprocessor->filters_map_frame, "filters/ambient_pointcloud_map_frame/");
+	if (compute_normals_when_tracking_pose_) {
+		loadNormalEstimatorFromParameterServer(preprocessor->normal_estimator, "normal_estimators/ambient_pointcloud/");
+		loadCurvatureEstimatorFromParameterServer(preprocessor->normal_estimator, "curvature_estimators/ambient_pointcloud/");
+	}
+	return preprocessor;
+}
+
+
 template<typename PointT>
 void Localization<PointT>::setupFiltersConfigurations() {
 	reference_cloud_filters_.clear();
@@ -343,7 +482,9 @@ void Localization<PointT>::loadFiltersFromParameterServer(std::vector< typename
 		for (XmlRpc::XmlRpcValue::iterator it = filters.begin(); it != filters.end(); ++it) {
 			std::string filter_name = it->first;
 			typename CloudFilter<PointT>::Ptr cloud_filter;
-			if (filter_name.find("approximate_voxel_grid") != std::string::npos) {
+			if (filter_name.find("fused_crop_voxel_grid") != std::string::npos) {
+				cloud_filter.reset(new FusedCropVoxelGrid<PointT>());
+			} else if (filter_name.find("approximate_voxel_grid") != std::string::npos) {
 				cloud_filter.reset(new ApproximateVoxelGrid<PointT>());
 			} else if (filter_name.find("voxel_grid") != std::string::npos) {
 				cloud_filter.reset(new VoxelGrid<PointT>());
@@ -428,6 +569,10 @@ void Localization<PointT>::loadNormalEstimatorFromParameterServer(typename Norma
 				normal_estimator = typename NormalEstimator<PointT>::Ptr(new NormalEstimatorSAC<PointT>());
 			} else if (estimator_name.find("normal_estimation_omp") != std::string::npos) {
 				normal_estimator = typename NormalEstimator<PointT>::Ptr(new NormalEstimationOMP<PointT>());
+			} else if (estimator_name.find("integral_image_normal_estimation") != std::string::npos) {
+				normal_estimator = typename NormalEstimator<PointT>::Ptr(new IntegralImageNormalEstimation<PointT>());
+			} else if (estimator_name.find("normal_and_principal_curvatures_estimation") != std::string::npos) {
+				normal_estimator = typename NormalEstimator<PointT>::Ptr(new NormalAndPrincipalCurvaturesEstimation<PointT>());
 			} else if (estimator_name.find("moving_least_squares") != std::string::npos) {
 				normal_estimator = typename NormalEstimator<PointT>::Ptr(new MovingLeastSquares<PointT>());
 			}
@@ -548,6 +693,8 @@ void Localization<PointT>::setupPointCloudMatchersConfigurations(std::vector< ty
 				cloud_matcher.reset(new NormalDistributionsTransform2D<PointT>());
 			} else if (matcher_name.find("normal_distributions_transform_3d") != std::string::npos) {
 				cloud_matcher.reset(new NormalDistributionsTransform3D<PointT>());
+			} else if (matcher_name.find("branch_and_bound_2d") != std::string::npos) {
+				cloud_matcher.reset(new BranchAndBound2D<PointT>());
 			}
 
 			if (cloud_matcher) {
@@ -627,6 +774,14 @@ void Localization<PointT>::loadKeypointMatcherFromParameterServer(std::vector< t
 }
 
 
+template<typename PointT>
+void Localization<PointT>::setupKeypointDescriptorsCache(std::vector< typename CloudMatcher<PointT>::Ptr >& matchers) {
+	for (size_t i = 0; i < matchers.size(); ++i) {
+		matchers[i]->setKeypointDescriptorsCache(ambient_keypoints_descriptors_cache_);
+	}
+}
+
+
 template<typename PointT>
 void Localization<PointT>::setupTransformationValidatorsConfigurations(std::vector< TransformationValidator::Ptr >& validators, const std::string& configuration_namespace) {
 	validators.clear();
@@ -675,6 +830,7 @@ template<typename PointT>
 void Localization<PointT>::setupCloudAnalyzersConfigurations() {
 	private_node_handle_->param("cloud_analyzers/compute_inliers_angular_distribution", compute_inliers_angular_distribution_, true);
 	private_node_handle_->param("cloud_analyzers/compute_outliers_angular_distribution", compute_outliers_angular_distribution_, true);
+	private_node_handle_->param("cloud_analyzers/compute_angular_distribution_during_outlier_detection", compute_angular_distribution_during_outlier_detection_, true);
 
 	std::string configuration_namespace = "cloud_analyzers/";
 	XmlRpc::XmlRpcValue cloud_analyzers;
@@ -720,6 +876,30 @@ template<typename PointT>
 bool Localization<PointT>::loadReferencePointCloudFromFile(const std::string& reference_pointcloud_filename) {
 	PerformanceTimer performance_timer;
 	performance_timer.start();
+
+	PreprocessedMapCache<PointT> preprocessed_map_cache;
+	boost::uint64_t reference_pointcloud_file_hash;
+	bool preprocessed_map_cache_enabled = !reference_pointcloud_preprocessed_cache_filename_.empty() && hash_utils::computeFileHash(reference_pointcloud_filename, reference_pointcloud_file_hash);
+	if (preprocessed_map_cache_enabled) {
+		preprocessed_map_cache.setSourceFileHash(reference_pointcloud_file_hash);
+		preprocessed_map_cache.setConfigurationHash(computeReferencePointCloudPreprocessingConfigurationHash());
+		if (preprocessed_map_cache.loadFromFile(reference_pointcloud_preprocessed_cache_filename_, *reference_pointcloud_, *reference_pointcloud_keypoints_)
+				&& reference_pointcloud_->size() > minimum_number_of_points_in_reference_pointcloud_) {
+			ROS_INFO_STREAM("Loaded preprocessed reference point cloud from cache " << reference_pointcloud_preprocessed_cache_filename_ << " with " << reference_pointcloud_->size() << " points and "
+					<< reference_pointcloud_keypoints_->size() << " keypoints in " << performance_timer.getElapsedTimeFormated());
+			reference_pointcloud_->header.frame_id = map_frame_id_;
+			reference_pointcloud_keypoints_->header.frame_id = map_frame_id_;
+			localization_diagnostics_msg_.number_points_reference_pointcloud = reference_pointcloud_->size();
+			localization_diagnostics_msg_.number_points_reference_pointcloud_after_filtering = reference_pointcloud_->size();
+
+			last_map_received_time_ = ros::Time::now();
+			if (reference_cloud_normal_estimator_) reference_cloud_normal_estimator_->resetOccupancyGridMsg();
+			reference_pointcloud_search_method_->setInputCloud(reference_pointcloud_);
+			updateLocalizationPipelineWithPreprocessedReferenceCloud();
+			return true;
+		}
+	}
+
 	if (pointcloud_conversions::fromFile(reference_pointcloud_filename, *reference_pointcloud_)) {
 		if (reference_pointcloud_->size() > minimum_number_of_points_in_reference_pointcloud_) {
 			ROS_INFO_STREAM("Loaded reference point cloud from file " << reference_pointcloud_filename << " with " << reference_pointcloud_->size() << " points in " << performance_timer.getElapsedTimeFormated());
@@ -727,7 +907,16 @@ bool Localization<PointT>::loadReferencePointCloudFromFile(const std::string& re
 
 			last_map_received_time_ = ros::Time::now();
 			if (reference_cloud_normal_estimator_) reference_cloud_normal_estimator_->resetOccupancyGridMsg();
-			return updateLocalizationPipelineWithNewReferenceCloud();
+			if (!updateLocalizationPipelineWithNewReferenceCloud()) { return false; }
+
+			if (preprocessed_map_cache_enabled) {
+				if (preprocessed_map_cache.saveToFile(reference_pointcloud_preprocessed_cache_filename_, *reference_pointcloud_, *reference_pointcloud_keypoints_)) {
+					ROS_INFO_STREAM("Saved preprocessed reference point cloud cache to file " << reference_pointcloud_preprocessed_cache_filename_);
+				} else {
+					ROS_WARN_STREAM("Failed to save preprocessed reference point cloud cache to file " << reference_pointcloud_preprocessed_cache_filename_);
+				}
+			}
+			return true;
 		}
 	}
 
@@ -743,16 +932,11 @@ void Localization<PointT>::loadReferencePointCloudFromROSPointCloud(const sensor
 	performance_timer.start();
 	if ((reference_pointcloud_msg->width * reference_pointcloud_msg->height > minimum_number_of_points_in_reference_pointcloud_) && (!reference_pointcloud_received_ || (ros::Time::now() - last_map_received_time_) > min_seconds_between_reference_pointcloud_update_)) {
 		if (reference_pointcloud_msg->width > 0 && reference_pointcloud_msg->data.size() > 0 && reference_pointcloud_msg->fields.size() >= 3) {
-			pcl::fromROSMsg(*reference_pointcloud_msg, *reference_pointcloud_);
-			size_t pointcloud_size = reference_pointcloud_->size();
-
-			std::vector<int> indexes;
-			pcl::removeNaNFromPointCloud(*reference_pointcloud_, *reference_pointcloud_, indexes);
-			indexes.clear();
+			PointCloud2Reader<PointT> reference_pointcloud_reader;
+			if (!reference_pointcloud_reader.read(*reference_pointcloud_msg, *reference_pointcloud_)) { return; }
 
-			size_t number_of_nans_in_reference_pointcloud = pointcloud_size - reference_pointcloud_->size();
-			if (number_of_nans_in_reference_pointcloud > 0) {
-				ROS_DEBUG_STREAM("Removed " << number_of_nans_in_reference_pointcloud << " NaNs from reference cloud with " << pointcloud_size << " points");
+			if (reference_pointcloud_reader.getNumberOfNaNsInLastPointCloud() > 0) {
+				ROS_DEBUG_STREAM("Removed " << reference_pointcloud_reader.getNumberOfNaNsInLastPointCloud() << " NaNs from reference cloud with " << (reference_pointcloud_msg->width * reference_pointcloud_msg->height) << " points");
 			}
 
 			if (reference_pointcloud_->size() > minimum_number_of_points_in_reference_pointcloud_) {
@@ -859,15 +1043,7 @@ bool Localization<PointT>::updateLocalizationPipelineWithNewReferenceCloud() {
 					ROS_INFO_STREAM("Loaded " << reference_pointcloud_keypoints_->size() << " keypoints from file " << reference_pointcloud_keypoints_filename_);
 				}
 			}
-			localization_diagnostics_msg_.number_keypoints_reference_pointcloud = reference_pointcloud_keypoints_->size();
-
-			if (registration_covariance_estimator_) {
-				registration_covariance_estimator_->setReferenceCloud(reference_pointcloud_, reference_pointcloud_search_method_);
-			}
-
-			updateMatchersReferenceCloud();
-			publishReferencePointCloud();
-			reference_pointcloud_received_ = true;
+			updateLocalizationPipelineWithPreprocessedReferenceCloud();
 			return true;
 		}
 	}
@@ -877,8 +1053,57 @@ bool Localization<PointT>::updateLocalizationPipelineWithNewReferenceCloud() {
 }
 
 
+template<typename PointT>
+void Localization<PointT>::updateLocalizationPipelineWithPreprocessedReferenceCloud() {
+	localization_diagnostics_msg_.number_keypoints_reference_pointcloud = reference_pointcloud_keypoints_->size();
+
+	if (registration_covariance_estimator_) {
+		registration_covariance_estimator_->setReferenceCloud(reference_pointcloud_, reference_pointcloud_search_method_);
+	}
+
+	updateMatchersReferenceCloud();
+	publishReferencePointCloud();
+	reference_pointcloud_received_ = true;
+}
+
+
+template<typename PointT>
+boost::uint64_t Localization<PointT>::computeReferencePointCloudPreprocessingConfigurationHash() {
+	const char* preprocessing_namespaces[] = { "filters/reference_pointcloud", "normal_estimators/reference_pointcloud", "curvature_estimators/reference_pointcloud",
+			"keypoint_detectors/reference_pointcloud", "reference_pointclouds/reference_pointcloud_type" };
+
+	boost::uint64_t configuration_hash = hash_utils::HASH_INITIAL_VALUE;
+	for (size_t i = 0; i < sizeof(preprocessing_namespaces) / sizeof(preprocessing_namespaces[0]); ++i) {
+		configuration_hash = hash_utils::computeHash(std::string(preprocessing_namespaces[i]), configuration_hash);
+		XmlRpc::XmlRpcValue configuration;
+		if (private_node_handle_->getParam(preprocessing_namespaces[i], configuration)) {
+			configuration_hash = hash_utils::computeHash(configuration.toXml(), configuration_hash);
+		}
+	}
+
+	// the keypoints file is loaded instead of running the keypoint detectors, so its contents must also invalidate the cache
+	if (!reference_pointcloud_keypoints_filename_.empty()) {
+		configuration_hash = hash_utils::computeHash(reference_pointcloud_keypoints_filename_, configuration_hash);
+		struct stat keypoints_file_status;
+		if (stat(reference_pointcloud_keypoints_filename_.c_str(), &keypoints_file_status) == 0) {
+			boost::uint64_t keypoints_file_size = (boost::uint64_t)keypoints_file_status.st_size;
+			boost::int64_t keypoints_file_modification_time = (boost::int64_t)keypoints_file_status.st_mtime;
+			configuration_hash = hash_utils::computeHash(&keypoints_file_size, sizeof(keypoints_file_size), configuration_hash);
+			configuration_hash = hash_utils::computeHash(&keypoints_file_modification_time, sizeof(keypoints_file_modification_time), configuration_hash);
+		}
+	}
+
+	return configuration_hash;
+}
+
+
 template<typename PointT>
 void Localization<PointT>::updateMatchersReferenceCloud() {
+	// the matchers only search the reference kd tree (it is shared by all of them and by the multi hypothesis tracking recovery threads), so it must be built before
+	if (reference_pointcloud_search_method_->getInputCloud() != reference_pointcloud_) {
+		reference_pointcloud_search_method_->setInputCloud(reference_pointcloud_);
+	}
+
 	for (size_t i = 0; i < initial_pose_estimators_feature_matchers_.size(); ++i) {
 		initial_pose_estimators_feature_matchers_[i]->setupReferenceCloud(reference_pointcloud_, reference_pointcloud_keypoints_, reference_pointcloud_search_method_);
 	}
@@ -894,6 +1119,12 @@ void Localization<PointT>::updateMatchersReferenceCloud() {
 	for (size_t i = 0; i < tracking_recovery_matchers_.size(); ++i) {
 		tracking_recovery_matchers_[i]->setupReferenceCloud(reference_pointcloud_, reference_pointcloud_keypoints_, reference_pointcloud_search_method_);
 	}
+
+	for (size_t i = 0; i < multi_hypothesis_tracking_recovery_matchers_.size(); ++i) {
+		for (size_t j = 0; j < multi_hypothesis_tracking_recovery_matchers_[i].size(); ++j) {
+			multi_hypothesis_tracking_recovery_matchers_[i][j]->setupReferenceCloud(reference_pointcloud_, reference_pointcloud_keypoints_, reference_pointcloud_search_method_);
+		}
+	}
 }
 
 
@@ -1031,14 +1262,25 @@ void Localization<PointT>::startLocalization() {
 			std::stringstream ss(ambient_pointcloud_topics_);
 			std::string topic_name;
 
+			ambient_pointcloud_preprocessors_.clear();
 			while (ss >> topic_name && !topic_name.empty()) {
-				ambient_pointcloud_subscribers_.push_back(node_handle_->subscribe(topic_name, 1, &dynamic_robot_localization::Localization<PointT>::processAmbientPointCloud, this));
+				if (use_pipelined_processing_) {
+					typename AmbientPointCloudPreprocessor::Ptr preprocessor = createAmbientPointCloudPreprocessor(topic_name);
+					ros::SubscribeOptions subscribe_options = ros::SubscribeOptions::create<sensor_msgs::PointCloud2>(topic_name, pipelined_processing_queue_size_,
+							boost::bind(&dynamic_robot_localization::Localization<PointT>::preprocessAmbientPointCloud, this, _1, ambient_pointcloud_preprocessors_.size()), ros::VoidPtr(), &preprocessor->callback_queue);
+					ambient_pointcloud_subscribers_.push_back(node_handle_->subscribe(subscribe_options));
+					ambient_pointcloud_preprocessors_.push_back(preprocessor);
+				} else {
+					ambient_pointcloud_subscribers_.push_back(node_handle_->subscribe(topic_name, 1, &dynamic_robot_localization::Localization<PointT>::processAmbientPointCloud, this));
+				}
 				ROS_INFO_STREAM("Adding " << topic_name << " to the list of sensor_msgs::PointCloud2 topics to use in localization");
 			}
 		}
 
 
-		if (publish_tf_map_odom_) {
+		if (use_pipelined_processing_) {
+			spinPipelinedProcessing();
+		} else if (publish_tf_map_odom_) {
 			ros::Rate publish_rate(pose_to_tf_publisher_->getPublishRate());
 			while (ros::ok()) {
 				pose_to_tf_publisher_->sendTF();
@@ -1048,21 +1290,30 @@ void Localization<PointT>::startLocalization() {
 		} else {
 			ros::spin();
 		}
+
+		publishTracingReports(true);
 	}
 }
 
 
 template<typename PointT>
 bool Localization<PointT>::transformCloudToMapFrame(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, const ros::Time& timestamp) {
+	return transformCloudToMapFrame(ambient_pointcloud, timestamp, last_accepted_pose_odom_to_map_);
+}
+
+
+template<typename PointT>
+bool Localization<PointT>::transformCloudToMapFrame(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, const ros::Time& timestamp, const tf2::Transform& odom_to_map, bool transform_normals) {
+	DRL_TRACE_SCOPE("localization/transform_to_map_frame");
 	if (ambient_pointcloud->header.frame_id != map_frame_id_) {
-		tf2::Transform pose_tf_cloud_to_map = last_accepted_pose_odom_to_map_;
+		tf2::Transform pose_tf_cloud_to_map = odom_to_map;
 		if (ambient_pointcloud->header.frame_id != odom_frame_id_) {
 			tf2::Transform pose_tf_cloud_to_odom;
 			if (!pose_to_tf_publisher_->getTfCollector().lookForTransform(pose_tf_cloud_to_odom, odom_frame_id_, ambient_pointcloud->header.frame_id, timestamp)) {
 				ROS_WARN_STREAM("Dropping pointcloud because TF between " << ambient_pointcloud->header.frame_id << " and " << odom_frame_id_ << " isn't available");
 				return false;
 			}
-			pose_tf_cloud_to_map = last_accepted_pose_odom_to_map_ * pose_tf_cloud_to_odom;
+			pose_tf_cloud_to_map = odom_to_map * pose_tf_cloud_to_odom;
 		}
 
 		if (!math_utils::isTransformValid(pose_tf_cloud_to_map)) {
@@ -1070,7 +1321,11 @@ bool Localization<PointT>::transformCloudToMapFrame(typename pcl::PointCloud<Poi
 			return false;
 		}
 
-		pcl::transformPointCloud(*ambient_pointcloud, *ambient_pointcloud, laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<double>(pose_tf_cloud_to_map));
+		if (transform_normals) {
+			pcl::transformPointCloudWithNormals(*ambient_pointcloud, *ambient_pointcloud, laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<double>(pose_tf_cloud_to_map));
+		} else {
+			pcl::transformPointCloud(*ambient_pointcloud, *ambient_pointcloud, laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<double>(pose_tf_cloud_to_map));
+		}
 		ROS_DEBUG_STREAM("Transformed pointcloud from frame " << ambient_pointcloud->header.frame_id << " to frame " << map_frame_id_);
 		ambient_pointcloud->header.frame_id = map_frame_id_;
 	}
@@ -1081,7 +1336,17 @@ bool Localization<PointT>::transformCloudToMapFrame(typename pcl::PointCloud<Poi
 
 template<typename PointT>
 void Localization<PointT>::processAmbientPointCloud(const sensor_msgs::PointCloud2ConstPtr& ambient_cloud_msg) {
+	typename PreprocessedAmbientPointCloud::Ptr preprocessed_ambient_pointcloud(new PreprocessedAmbientPointCloud());
+	preprocessed_ambient_pointcloud->ambient_pointcloud_msg = ambient_cloud_msg;
+	processPreprocessedAmbientPointCloud(preprocessed_ambient_pointcloud);
+}
+
+
+template<typename PointT>
+void Localization<PointT>::processPreprocessedAmbientPointCloud(const typename PreprocessedAmbientPointCloud::Ptr& preprocessed_ambient_pointcloud) {
+	const sensor_msgs::PointCloud2ConstPtr& ambient_cloud_msg = preprocessed_ambient_pointcloud->ambient_pointcloud_msg;
 	try {
+		DRL_TRACE_SCOPE("localization/scan_processing");
 		PerformanceTimer performance_timer;
 		performance_timer.start();
 
@@ -1137,16 +1402,17 @@ void Localization<PointT>::processAmbientPointCloud(const sensor_msgs::PointClou
 			tf2::Transform pose_tf_initial_guess = last_accepted_pose_odom_to_map_ * transform_base_link_to_odom;
 
 
-			typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud(new pcl::PointCloud<PointT>());
-			pcl::fromROSMsg(*ambient_cloud_msg, *ambient_pointcloud);
-			ambient_pointcloud->header.frame_id = ambient_cloud_msg->header.frame_id;
-			size_t ambient_pointcloud_size = ambient_pointcloud->size();
-			std::vector<int> indexes;
-			pcl::removeNaNFromPointCloud(*ambient_pointcloud, *ambient_pointcloud, indexes);
-			indexes.clear();
-			size_t number_of_nans_in_ambient_pointcloud = ambient_pointcloud_size - ambient_pointcloud->size();
-			if (number_of_nans_in_ambient_pointcloud > 0) {
-				ROS_DEBUG_STREAM("Removed " << number_of_nans_in_ambient_pointcloud << " NaNs from ambient cloud with " << ambient_pointcloud_size << " points");
+			typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud = preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame;
+			if (!ambient_pointcloud) {
+				ambient_pointcloud.reset(new pcl::PointCloud<PointT>());
+				if (!ambient_pointcloud_reader_.read(*ambient_cloud_msg, *ambient_pointcloud)) { return; }
+				ambient_pointcloud->header.frame_id = ambient_cloud_msg->header.frame_id;
+				if (ambient_pointcloud_reader_.getNumberOfNaNsInLastPointCloud() > 0) {
+					ROS_DEBUG_STREAM("Removed " << ambient_pointcloud_reader_.getNumberOfNaNsInLastPointCloud() << " NaNs from ambient cloud with " << number_points_ambient_pointcloud << " points");
+				}
+				if (ambient_pointcloud_reader_.getNumberOfPointsOutsideCropBoxInLastPointCloud() > 0) {
+					ROS_DEBUG_STREAM("Removed " << ambient_pointcloud_reader_.getNumberOfPointsOutsideCropBoxInLastPointCloud() << " points outside the ingestion crop box from ambient cloud with " << number_points_ambient_pointcloud << " points");
+				}
 			}
 
 			tf2::Quaternion pose_tf_initial_guess_q = pose_tf_initial_guess.getRotation().normalize();
@@ -1161,7 +1427,7 @@ void Localization<PointT>::processAmbientPointCloud(const sensor_msgs::PointClou
 			typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_keypoints(new pcl::PointCloud<PointT>());
 			ambient_pointcloud_keypoints->header = ambient_pointcloud->header;
 
-			bool localizationUpdateSuccess = updateLocalizationWithAmbientPointCloud(ambient_pointcloud, ambient_cloud_msg->header.stamp, pose_tf_initial_guess, pose_tf_corrected, pose_corrections, ambient_pointcloud_keypoints) || (!reference_pointcloud_available_ && !reference_pointcloud_received_ && map_update_mode_ != NoIntegration);
+			bool localizationUpdateSuccess = updateLocalizationWithAmbientPointCloud(ambient_pointcloud, ambient_cloud_msg->header.stamp, pose_tf_initial_guess, pose_tf_corrected, pose_corrections, ambient_pointcloud_keypoints, preprocessed_ambient_pointcloud) || (!reference_pointcloud_available_ && !reference_pointcloud_received_ && map_update_mode_ != NoIntegration);
 
 			ros::Time pose_time;
 			if (add_odometry_displacement_) {
@@ -1364,6 +1630,335 @@ void Localization<PointT>::processAmbientPointCloud(const sensor_msgs::PointClou
 	} catch (std::exception& e) {
 		ROS_ERROR_STREAM("Exception caught in ambient pointcloud callback! Info: [" << e.what() <<"]");
 	}
+
+	publishTracingReports();
+}
+
+
+template<typename PointT>
+void Localization<PointT>::preprocessAmbientPointCloud(const sensor_msgs::PointCloud2ConstPtr& ambient_cloud_msg, size_t sensor_index) {
+	try {
+		AmbientPointCloudPreprocessor& preprocessor = *ambient_pointcloud_preprocessors_[sensor_index];
+		DRL_TRACE_SCOPE("preprocessing/scan_preprocessing");
+		if (Tracer::getInstance().isEnabled()) { Tracer::getInstance().setCurrentThreadName("preprocessing " + preprocessor.topic_name); }
+		if (ros::Time::now() - ambient_cloud_msg->header.stamp > max_seconds_ambient_pointcloud_age_) {
+			ROS_WARN_STREAM("Discarded ambient cloud in the preprocessing thread because it is older than " << max_seconds_ambient_pointcloud_age_.toSec() << " seconds");
+			return;
+		}
+
+		PerformanceTimer performance_timer;
+		performance_timer.start();
+
+		typename PreprocessedAmbientPointCloud::Ptr preprocessed_ambient_pointcloud(new PreprocessedAmbientPointCloud());
+		preprocessed_ambient_pointcloud->ambient_pointcloud_msg = ambient_cloud_msg;
+		preprocessed_ambient_pointcloud->sensor_index = sensor_index;
+		preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame.reset(new pcl::PointCloud<PointT>());
+		if (!preprocessor.pointcloud_reader.read(*ambient_cloud_msg, *preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame)) { return; }
+		preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame->header.frame_id = ambient_cloud_msg->header.frame_id;
+		preprocessed_ambient_pointcloud->number_points_ambient_pointcloud = preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame->size();
+
+		// the circular buffer and the integration filters depend on the result of the previous registration and must be applied in the localization thread
+		if (!ambient_pointcloud_with_circular_buffer_ && ambient_pointcloud_integration_filters_.empty()) {
+			{
+				boost::mutex::scoped_lock lock(preprocessed_ambient_pointclouds_mutex_);
+				preprocessed_ambient_pointcloud->odom_to_map_used_in_preprocessing = pipelined_processing_odom_to_map_;
+			}
+			const tf2::Transform& odom_to_map = preprocessed_ambient_pointcloud->odom_to_map_used_in_preprocessing;
+			const ros::Time& pointcloud_time = ambient_cloud_msg->header.stamp;
+
+			// ==============================================================  filters
+			if (preprocessor.normal_estimator && !use_filtered_cloud_as_normal_estimation_surface_ambient_) {
+				bool surface_has_normals = readOrganizedNormalEstimationSurface(preprocessor.pointcloud_reader, preprocessor.normal_estimator, ambient_cloud_msg, preprocessed_ambient_pointcloud->ambient_pointcloud_raw);
+				if (!surface_has_normals) {
+					preprocessed_ambient_pointcloud->ambient_pointcloud_raw.reset(new pcl::PointCloud<PointT>(*preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame));
+				}
+				if (!transformCloudToMapFrame(preprocessed_ambient_pointcloud->ambient_pointcloud_raw, pointcloud_time, odom_to_map, surface_has_normals)) { return; }
+				if (reference_pointcloud_2d_) { resetPointCloudHeight(*preprocessed_ambient_pointcloud->ambient_pointcloud_raw); }
+			}
+
+			typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud(new pcl::PointCloud<PointT>(*preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame));
+			if (applyFilters(preprocessor.filters, ambient_pointcloud)
+					&& transformCloudToMapFrame(ambient_pointcloud, pointcloud_time, odom_to_map)
+					&& applyFilters(preprocessor.filters_map_frame, ambient_pointcloud)) {
+				if (reference_pointcloud_2d_) { resetPointCloudHeight(*ambient_pointcloud); }
+				preprocessed_ambient_pointcloud->ambient_pointcloud = ambient_pointcloud;
+				preprocessed_ambient_pointcloud->filtering_time = performance_timer.getElapsedTimeInMilliSec();
+				preprocessed_ambient_pointcloud->preprocessed = true;
+
+				// ==============================================================  normal estimation
+				if (preprocessor.normal_estimator) {
+					performance_timer.restart();
+					tf2::Transform sensor_pose_tf_guess;
+					if (pose_to_tf_publisher_->getTfCollector().lookForTransform(sensor_pose_tf_guess, odom_frame_id_, ambient_cloud_msg->header.frame_id, pointcloud_time) && math_utils::isTransformValid(sensor_pose_tf_guess)) {
+						sensor_pose_tf_guess = odom_to_map * sensor_pose_tf_guess;
+					} else {
+						sensor_pose_tf_guess.setIdentity();
+					}
+					if (reference_pointcloud_2d_) { sensor_pose_tf_guess.getOrigin().setZ(0.0); }
+
+					typename pcl::PointCloud<PointT>::Ptr surface = preprocessed_ambient_pointcloud->ambient_pointcloud_raw;
+					bool surface_is_ambient_pointcloud = !surface || surface->size() <= minimum_number_of_points_in_ambient_pointcloud_;
+					if (surface_is_ambient_pointcloud) { surface = ambient_pointcloud; }
+					typename pcl::search::KdTree<PointT>::Ptr surface_search_method(new pcl::search::KdTree<PointT>());
+					surface_search_method->setInputCloud(surface);
+					preprocessor.normal_estimator->estimateNormals(ambient_pointcloud, surface, surface_search_method, sensor_pose_tf_guess, ambient_pointcloud);
+					if (surface_is_ambient_pointcloud) { preprocessed_ambient_pointcloud->ambient_pointcloud_search_method = surface_search_method; }
+					preprocessed_ambient_pointcloud->computed_normals = true;
+					preprocessed_ambient_pointcloud->surface_normal_estimation_time = performance_timer.getElapsedTimeInMilliSec();
+				}
+			} else {
+				ROS_DEBUG("Preprocessing thread could not filter the ambient cloud, deferring it to the localization thread");
+			}
+		}
+
+		// the queue limit is applied per sensor, to avoid having a sensor with high update rate discarding the scans of the other sensors
+		boost::mutex::scoped_lock lock(preprocessed_ambient_pointclouds_mutex_);
+		size_t number_of_queued_pointclouds_from_sensor = 0;
+		for (typename std::deque< typename PreprocessedAmbientPointCloud::Ptr >::reverse_iterator it = preprocessed_ambient_pointclouds_.rbegin(); it != preprocessed_ambient_pointclouds_.rend(); ++it) {
+			if ((*it)->sensor_index == sensor_index && ++number_of_queued_pointclouds_from_sensor >= (size_t)pipelined_processing_queue_size_) {
+				ROS_DEBUG_STREAM("Dropping the oldest preprocessed ambient cloud from topic " << preprocessor.topic_name << " (with time stamp " << (*it)->ambient_pointcloud_msg->header.stamp << ") because the localization thread is busy");
+				preprocessed_ambient_pointclouds_.erase(--(it.base()));
+				break;
+			}
+		}
+		preprocessed_ambient_pointclouds_.push_back(preprocessed_ambient_pointcloud);
+		preprocessed_ambient_pointclouds_condition_.notify_all();
+	} catch (std::exception& e) {
+		ROS_ERROR_STREAM("Exception caught in ambient pointcloud preprocessing callback! Info: [" << e.what() <<"]");
+	}
+}
+
+
+template<typename PointT>
+typename Localization<PointT>::PreprocessedAmbientPointCloud::Ptr Localization<PointT>::popPreprocessedAmbientPointCloud(const boost::posix_time::time_duration& timeout) {
+	boost::mutex::scoped_lock lock(preprocessed_ambient_pointclouds_mutex_);
+	if (preprocessed_ambient_pointclouds_.empty()) {
+		preprocessed_ambient_pointclouds_condition_.timed_wait(lock, timeout);
+	}
+
+	typename PreprocessedAmbientPointCloud::Ptr preprocessed_ambient_pointcloud;
+	if (!preprocessed_ambient_pointclouds_.empty()) {
+		preprocessed_ambient_pointcloud = preprocessed_ambient_pointclouds_.front();
+		preprocessed_ambient_pointclouds_.pop_front();
+	}
+	return preprocessed_ambient_pointcloud;
+}
+
+
+template<typename PointT>
+void Localization<PointT>::updatePipelinedProcessingPoseEstimate() {
+	boost::mutex::scoped_lock lock(preprocessed_ambient_pointclouds_mutex_);
+	pipelined_processing_odom_to_map_ = last_accepted_pose_odom_to_map_;
+}
+
+
+template<typename PointT>
+bool Localization<PointT>::correctPreprocessedAmbientPointCloudPose(PreprocessedAmbientPointCloud& preprocessed_ambient_pointcloud, const tf2::Transform& odom_to_map) {
+	tf2::Transform pose_correction = odom_to_map * preprocessed_ambient_pointcloud.odom_to_map_used_in_preprocessing.inverse();
+	double translation_correction = pose_correction.getOrigin().length();
+	double rotation_correction = std::abs(angles::normalize_angle(pose_correction.getRotation().getAngle()));
+	if (translation_correction > pipelined_processing_max_translation_correction_ || rotation_correction > pipelined_processing_max_rotation_correction_) {
+		ROS_DEBUG_STREAM("Repeating the preprocessing of the ambient cloud because the pose estimate changed too much since it was filtered [ translation: " << translation_correction << " | rotation: " << rotation_correction << " ]");
+		return false;
+	}
+
+	if (translation_correction > 0.0 || rotation_correction > 0.0) {
+		Eigen::Transform<double, 3, Eigen::Affine> pose_correction_eigen = laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<double>(pose_correction);
+		pcl::transformPointCloudWithNormals(*preprocessed_ambient_pointcloud.ambient_pointcloud, *preprocessed_ambient_pointcloud.ambient_pointcloud, pose_correction_eigen);
+		if (reference_pointcloud_2d_) { resetPointCloudHeight(*preprocessed_ambient_pointcloud.ambient_pointcloud); }
+		if (preprocessed_ambient_pointcloud.ambient_pointcloud_raw) {
+			pcl::transformPointCloudWithNormals(*preprocessed_ambient_pointcloud.ambient_pointcloud_raw, *preprocessed_ambient_pointcloud.ambient_pointcloud_raw, pose_correction_eigen); // the surface may have normals estimated in the sensor frame
+			if (reference_pointcloud_2d_) { resetPointCloudHeight(*preprocessed_ambient_pointcloud.ambient_pointcloud_raw); }
+		}
+		preprocessed_ambient_pointcloud.ambient_pointcloud_search_method.reset(); // kd tree no longer matches the point coordinates
+		preprocessed_ambient_pointcloud.odom_to_map_used_in_preprocessing = odom_to_map;
+	}
+
+	return true;
+}
+
+
+template<typename PointT>
+typename Localization<PointT>::PreprocessedAmbientPointCloud::Ptr Localization<PointT>::mergeSynchronizedPreprocessedAmbientPointClouds(const typename PreprocessedAmbientPointCloud::Ptr& first_preprocessed_ambient_pointcloud,
+		std::vector< typename PreprocessedAmbientPointCloud::Ptr >& unmerged_preprocessed_ambient_pointclouds_out) {
+	unmerged_preprocessed_ambient_pointclouds_out.clear();
+	if (ambient_pointcloud_preprocessors_.size() < 2 || pipelined_processing_sensors_synchronization_time_window_ <= 0.0) { return first_preprocessed_ambient_pointcloud; }
+	DRL_TRACE_SCOPE("localization/sensors_synchronization");
+
+	// gather the scans of the other sensors whose time stamps are within the synchronization window (waiting at most the window duration for the ones still being preprocessed)
+	std::vector< typename PreprocessedAmbientPointCloud::Ptr > synchronized_preprocessed_ambient_pointclouds(1, first_preprocessed_ambient_pointcloud);
+	std::vector<bool> sensor_already_synchronized(ambient_pointcloud_preprocessors_.size(), false);
+	sensor_already_synchronized[first_preprocessed_ambient_pointcloud->sensor_index] = true;
+	const ros::Time& first_pointcloud_time = first_preprocessed_ambient_pointcloud->ambient_pointcloud_msg->header.stamp;
+	ros::WallTime synchronization_deadline = ros::WallTime::now() + ros::WallDuration(pipelined_processing_sensors_synchronization_time_window_);
+
+	{
+		boost::mutex::scoped_lock lock(preprocessed_ambient_pointclouds_mutex_);
+		while (true) {
+			for (typename std::deque< typename PreprocessedAmbientPointCloud::Ptr >::iterator it = preprocessed_ambient_pointclouds_.begin(); it != preprocessed_ambient_pointclouds_.end();) {
+				if (!sensor_already_synchronized[(*it)->sensor_index] && std::abs(((*it)->ambient_pointcloud_msg->header.stamp - first_pointcloud_time).toSec()) <= pipelined_processing_sensors_synchronization_time_window_) {
+					sensor_already_synchronized[(*it)->sensor_index] = true;
+					synchronized_preprocessed_ambient_pointclouds.push_back(*it);
+					it = preprocessed_ambient_pointclouds_.erase(it);
+				} else {
+					++it;
+				}
+			}
+
+			ros::WallTime now = ros::WallTime::now();
+			if (synchronized_preprocessed_ambient_pointclouds.size() == ambient_pointcloud_preprocessors_.size() || now >= synchronization_deadline) { break; }
+			preprocessed_ambient_pointclouds_condition_.timed_wait(lock, boost::posix_time::microseconds((synchronization_deadline - now).toNSec() / 1000));
+		}
+	}
+
+	if (synchronized_preprocessed_ambient_pointclouds.size() < 2) { return first_preprocessed_ambient_pointcloud; }
+
+	// all the merged clouds must be in the map frame with the same odom -> map estimate (the others are registered individually)
+	typename PreprocessedAmbientPointCloud::Ptr merged_preprocessed_ambient_pointcloud;
+	typename PreprocessedAmbientPointCloud::Ptr newest_preprocessed_ambient_pointcloud;
+	std::vector< typename PreprocessedAmbientPointCloud::Ptr > merged_preprocessed_ambient_pointclouds;
+	bool merged_raw_pointclouds = true;
+	for (size_t i = 0; i < synchronized_preprocessed_ambient_pointclouds.size(); ++i) {
+		typename PreprocessedAmbientPointCloud::Ptr& preprocessed_ambient_pointcloud = synchronized_preprocessed_ambient_pointclouds[i];
+		if (!preprocessed_ambient_pointcloud->preprocessed || !correctPreprocessedAmbientPointCloudPose(*preprocessed_ambient_pointcloud, last_accepted_pose_odom_to_map_)) {
+			unmerged_preprocessed_ambient_pointclouds_out.push_back(preprocessed_ambient_pointcloud);
+			continue;
+		}
+
+		merged_preprocessed_ambient_pointclouds.push_back(preprocessed_ambient_pointcloud);
+		if (!merged_preprocessed_ambient_pointcloud) {
+			newest_preprocessed_ambient_pointcloud = preprocessed_ambient_pointcloud;
+			merged_preprocessed_ambient_pointcloud.reset(new PreprocessedAmbientPointCloud(*preprocessed_ambient_pointcloud));
+			merged_preprocessed_ambient_pointcloud->ambient_pointcloud.reset(new pcl::PointCloud<PointT>(*preprocessed_ambient_pointcloud->ambient_pointcloud));
+			merged_preprocessed_ambient_pointcloud->ambient_pointcloud_search_method.reset();
+			merged_raw_pointclouds = (preprocessed_ambient_pointcloud->ambient_pointcloud_raw.get() != NULL);
+			if (merged_raw_pointclouds) { merged_preprocessed_ambient_pointcloud->ambient_pointcloud_raw.reset(new pcl::PointCloud<PointT>(*preprocessed_ambient_pointcloud->ambient_pointcloud_raw)); }
+			continue;
+		}
+
+		*merged_preprocessed_ambient_pointcloud->ambient_pointcloud += *preprocessed_ambient_pointcloud->ambient_pointcloud;
+		if (merged_raw_pointclouds && preprocessed_ambient_pointcloud->ambient_pointcloud_raw) {
+			*merged_preprocessed_ambient_pointcloud->ambient_pointcloud_raw += *preprocessed_ambient_pointcloud->ambient_pointcloud_raw;
+		} else {
+			merged_raw_pointclouds = false;
+			merged_preprocessed_ambient_pointcloud->ambient_pointcloud_raw.reset();
+		}
+
+		// the most recent scan gives the time stamp used in the registration
+		if (preprocessed_ambient_pointcloud->ambient_pointcloud_msg->header.stamp > merged_preprocessed_ambient_pointcloud->ambient_pointcloud_msg->header.stamp) {
+			newest_preprocessed_ambient_pointcloud = preprocessed_ambient_pointcloud;
+			merged_preprocessed_ambient_pointcloud->ambient_pointcloud_msg = preprocessed_ambient_pointcloud->ambient_pointcloud_msg;
+			merged_preprocessed_ambient_pointcloud->ambient_pointcloud->header = preprocessed_ambient_pointcloud->ambient_pointcloud->header;
+		}
+		merged_preprocessed_ambient_pointcloud->computed_normals = merged_preprocessed_ambient_pointcloud->computed_normals && preprocessed_ambient_pointcloud->computed_normals;
+		merged_preprocessed_ambient_pointcloud->number_points_ambient_pointcloud += preprocessed_ambient_pointcloud->number_points_ambient_pointcloud;
+		merged_preprocessed_ambient_pointcloud->filtering_time = std::max(merged_preprocessed_ambient_pointcloud->filtering_time, preprocessed_ambient_pointcloud->filtering_time);
+		merged_preprocessed_ambient_pointcloud->surface_normal_estimation_time = std::max(merged_preprocessed_ambient_pointcloud->surface_normal_estimation_time, preprocessed_ambient_pointcloud->surface_normal_estimation_time);
+	}
+
+	if (!merged_preprocessed_ambient_pointcloud) {
+		typename PreprocessedAmbientPointCloud::Ptr preprocessed_ambient_pointcloud = unmerged_preprocessed_ambient_pointclouds_out.front();
+		unmerged_preprocessed_ambient_pointclouds_out.erase(unmerged_preprocessed_ambient_pointclouds_out.begin());
+		return preprocessed_ambient_pointcloud;
+	}
+
+	// the unfiltered clouds are also merged (in the sensor frame of the newest scan), because they are used if the registration must be repeated without the preprocessed cloud
+	if (merged_preprocessed_ambient_pointclouds.size() > 1) {
+		if (!mergeSynchronizedSensorFramePointClouds(merged_preprocessed_ambient_pointclouds, newest_preprocessed_ambient_pointcloud, merged_preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame)) {
+			ROS_WARN("Registering the synchronized ambient clouds individually because the TF between their sensor frames isn't available");
+			unmerged_preprocessed_ambient_pointclouds_out.insert(unmerged_preprocessed_ambient_pointclouds_out.begin(), merged_preprocessed_ambient_pointclouds.begin() + 1, merged_preprocessed_ambient_pointclouds.end());
+			return merged_preprocessed_ambient_pointclouds.front();
+		}
+		merged_preprocessed_ambient_pointcloud->merged_synchronized_sensors = true;
+	}
+
+	if (merged_preprocessed_ambient_pointcloud->ambient_pointcloud_raw) {
+		merged_preprocessed_ambient_pointcloud->ambient_pointcloud_raw->header = merged_preprocessed_ambient_pointcloud->ambient_pointcloud->header;
+	}
+	ROS_DEBUG_STREAM("Merged " << (synchronized_preprocessed_ambient_pointclouds.size() - unmerged_preprocessed_ambient_pointclouds_out.size()) << " synchronized ambient clouds with a total of " << merged_preprocessed_ambient_pointcloud->ambient_pointcloud->size() << " points");
+	return merged_preprocessed_ambient_pointcloud;
+}
+
+
+template<typename PointT>
+bool Localization<PointT>::mergeSynchronizedSensorFramePointClouds(const std::vector< typename PreprocessedAmbientPointCloud::Ptr >& preprocessed_ambient_pointclouds, const typename PreprocessedAmbientPointCloud::Ptr& reference_preprocessed_ambient_pointcloud,
+		typename pcl::PointCloud<PointT>::Ptr& merged_pointcloud_out) {
+	if (!reference_preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame) { return false; }
+
+	const pcl::PointCloud<PointT>& reference_pointcloud = *reference_preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame;
+	tf2::Transform reference_sensor_to_odom;
+	if (!lookForSensorToOdomTransform(reference_pointcloud.header.frame_id, reference_preprocessed_ambient_pointcloud->ambient_pointcloud_msg->header.stamp, reference_sensor_to_odom)) { return false; }
+	tf2::Transform odom_to_reference_sensor = reference_sensor_to_odom.inverse();
+
+	// the other clouds are moved to the reference sensor frame through the odom frame, to account for the motion between their time stamps
+	typename pcl::PointCloud<PointT>::Ptr merged_pointcloud(new pcl::PointCloud<PointT>(reference_pointcloud));
+	pcl::PointCloud<PointT> pointcloud_in_reference_sensor_frame;
+	for (size_t i = 0; i < preprocessed_ambient_pointclouds.size(); ++i) {
+		const typename PreprocessedAmbientPointCloud::Ptr& preprocessed_ambient_pointcloud = preprocessed_ambient_pointclouds[i];
+		if (preprocessed_ambient_pointcloud == reference_preprocessed_ambient_pointcloud) { continue; }
+		if (!preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame) { return false; }
+
+		tf2::Transform sensor_to_odom;
+		if (!lookForSensorToOdomTransform(preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame->header.frame_id, preprocessed_ambient_pointcloud->ambient_pointcloud_msg->header.stamp, sensor_to_odom)) { return false; }
+		pcl::transformPointCloud(*preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame, pointcloud_in_reference_sensor_frame,
+				laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<double>(odom_to_reference_sensor * sensor_to_odom));
+		*merged_pointcloud += pointcloud_in_reference_sensor_frame;
+	}
+
+	merged_pointcloud->header = reference_pointcloud.header;
+	merged_pointcloud_out = merged_pointcloud;
+	return true;
+}
+
+
+template<typename PointT>
+bool Localization<PointT>::lookForSensorToOdomTransform(const std::string& sensor_frame_id, const ros::Time& timestamp, tf2::Transform& sensor_to_odom_out) {
+	if (sensor_frame_id == odom_frame_id_) {
+		sensor_to_odom_out.setIdentity();
+		return true;
+	}
+
+	return pose_to_tf_publisher_->getTfCollector().lookForTransform(sensor_to_odom_out, odom_frame_id_, sensor_frame_id, timestamp) && math_utils::isTransformValid(sensor_to_odom_out);
+}
+
+
+template<typename PointT>
+void Localization<PointT>::spinPipelinedProcessing() {
+	for (size_t i = 0; i < ambient_pointcloud_preprocessors_.size(); ++i) {
+		ambient_pointcloud_preprocessors_[i]->spinner.reset(new ros::AsyncSpinner(1, &ambient_pointcloud_preprocessors_[i]->callback_queue));
+		ambient_pointcloud_preprocessors_[i]->spinner->start();
+	}
+
+	ros::WallDuration tf_publish_period(publish_tf_map_odom_ ? 1.0 / pose_to_tf_publisher_->getPublishRate() : 0.0);
+	ros::WallTime last_tf_publish_time = ros::WallTime::now();
+	boost::posix_time::time_duration queue_wait_timeout = boost::posix_time::milliseconds(5);
+	std::vector< typename PreprocessedAmbientPointCloud::Ptr > unmerged_preprocessed_ambient_pointclouds;
+
+	updatePipelinedProcessingPoseEstimate();
+	while (ros::ok()) {
+		ros::getGlobalCallbackQueue()->callAvailable(ros::WallDuration(0));
+		updatePipelinedProcessingPoseEstimate();
+
+		typename PreprocessedAmbientPointCloud::Ptr preprocessed_ambient_pointcloud = popPreprocessedAmbientPointCloud(queue_wait_timeout);
+		if (preprocessed_ambient_pointcloud) {
+			preprocessed_ambient_pointcloud = mergeSynchronizedPreprocessedAmbientPointClouds(preprocessed_ambient_pointcloud, unmerged_preprocessed_ambient_pointclouds);
+			processPreprocessedAmbientPointCloud(preprocessed_ambient_pointcloud);
+			for (size_t i = 0; i < unmerged_preprocessed_ambient_pointclouds.size(); ++i) {
+				processPreprocessedAmbientPointCloud(unmerged_preprocessed_ambient_pointclouds[i]);
+			}
+			updatePipelinedProcessingPoseEstimate();
+		}
+
+		if (publish_tf_map_odom_ && ros::WallTime::now() - last_tf_publish_time >= tf_publish_period) {
+			pose_to_tf_publisher_->sendTF();
+			last_tf_publish_time = ros::WallTime::now();
+		}
+	}
+
+	for (size_t i = 0; i < ambient_pointcloud_preprocessors_.size(); ++i) {
+		ambient_pointcloud_preprocessors_[i]->spinner->stop();
+		ambient_pointcloud_preprocessors_[i]->spinner.reset();
+	}
 }
 
 
@@ -1375,25 +1970,66 @@ void Localization<PointT>::resetPointCloudHeight(pcl::PointCloud<PointT>& pointc
 }
 
 
+template<typename PointT>
+bool Localization<PointT>::readOrganizedNormalEstimationSurface(PointCloud2Reader<PointT>& pointcloud_reader, const typename NormalEstimator<PointT>::Ptr& normal_estimator,
+		const sensor_msgs::PointCloud2ConstPtr& ambient_cloud_msg, typename pcl::PointCloud<PointT>::Ptr& surface_out) {
+	if (!normal_estimator || !normal_estimator->usesOrganizedSurface() || !ambient_cloud_msg || ambient_cloud_msg->height <= 1) { return false; }
+
+	typename pcl::PointCloud<PointT>::Ptr organized_surface(new pcl::PointCloud<PointT>());
+	if (!pointcloud_reader.read(*ambient_cloud_msg, *organized_surface, true)) { return false; }
+	organized_surface->header.frame_id = ambient_cloud_msg->header.frame_id;
+	if (!normal_estimator->estimateOrganizedSurfaceNormals(organized_surface)) { return false; }
+	surface_out = organized_surface;
+	return true;
+}
+
+
 template<typename PointT>
 bool Localization<PointT>::applyFilters(std::vector< typename CloudFilter<PointT>::Ptr >& cloud_filters, typename pcl::PointCloud<PointT>::Ptr& pointcloud) {
+	DRL_TRACE_SCOPE("localization/filters");
 	ROS_DEBUG_STREAM("Filtering cloud in " << pointcloud->header.frame_id << " with " << pointcloud->size() << " points");
 
+	// the intermediate clouds are stored in the output buffers of the filters and reused in the next calls
+	// the input cloud can only be changed in place if no other object has a reference to it
+	bool pointcloud_owned_by_filters = pointcloud.unique();
+	bool pointcloud_in_filter_buffer = false;
 	for (size_t i = 0; i < cloud_filters.size(); ++i) {
-		typename pcl::PointCloud<PointT>::Ptr filtered_ambient_pointcloud(new pcl::PointCloud<PointT>());
+		TraceSpan filter_trace_span(cloud_filters[i]->getTraceSpanId());
+		if (pointcloud_owned_by_filters && cloud_filters[i]->filterInPlace(pointcloud)) { continue; }
+
+		typename pcl::PointCloud<PointT>::Ptr output_cloud_buffer = cloud_filters[i]->getOutputCloudBuffer();
+		typename pcl::PointCloud<PointT>::Ptr filtered_ambient_pointcloud = output_cloud_buffer;
 		filtered_ambient_pointcloud->header = pointcloud->header;
 		cloud_filters[i]->filter(pointcloud, filtered_ambient_pointcloud);
-		pointcloud = filtered_ambient_pointcloud; // switch pointers
+		if (filtered_ambient_pointcloud != pointcloud) {
+			pointcloud = filtered_ambient_pointcloud; // switch pointers
+			pointcloud_owned_by_filters = true;
+			pointcloud_in_filter_buffer = (filtered_ambient_pointcloud == output_cloud_buffer);
+		}
+	}
+
+	// the filter buffers are kept for the next cloud, so the caller receives a copy with only the memory needed for the filtered points
+	if (pointcloud_in_filter_buffer) {
+		pointcloud = typename pcl::PointCloud<PointT>::Ptr(new pcl::PointCloud<PointT>(*pointcloud));
 	}
 
 	return pointcloud->size() > minimum_number_of_points_in_ambient_pointcloud_;
 }
 
 
+template<typename PointT>
+void Localization<PointT>::updateAmbientPointCloudSearchMethod(typename pcl::search::KdTree<PointT>::Ptr& search_method, const typename pcl::PointCloud<PointT>::Ptr& pointcloud) {
+	if (search_method != reference_pointcloud_search_method_) {
+		search_method = ambient_pointcloud_search_methods_cache_.getSearchMethod(pointcloud);
+	}
+}
+
+
 template<typename PointT>
 bool Localization<PointT>::applyNormalEstimation(typename NormalEstimator<PointT>::Ptr& normal_estimator, typename pcl::PointCloud<PointT>::Ptr& pointcloud, typename pcl::PointCloud<PointT>::Ptr& surface,
 		typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method, bool pointcloud_is_map) {
 	if (!normal_estimator) return false;
+	DRL_TRACE_SCOPE("localization/normal_estimation");
 
 	PerformanceTimer performance_timer;
 	performance_timer.start();
@@ -1411,18 +2047,31 @@ bool Localization<PointT>::applyNormalEstimation(typename NormalEstimator<PointT
 
 	if (surface && surface->size() > minimum_number_of_points_in_ambient_pointcloud_) {
 		ROS_DEBUG_STREAM("Using raw pointcloud with " << surface->size() << " points as surface for normal estimation");
-		typename pcl::search::KdTree<PointT>::Ptr surface_search_method(new pcl::search::KdTree<PointT>());
-		surface_search_method->setInputCloud(surface);
+		typename pcl::search::KdTree<PointT>::Ptr surface_search_method;
+		if (pointcloud_is_map) {
+			surface_search_method.reset(new pcl::search::KdTree<PointT>());
+			surface_search_method->setInputCloud(surface);
+		} else {
+			surface_search_method = ambient_pointcloud_search_methods_cache_.getSearchMethod(surface);
+		}
 		size_t number_surface_points = surface_search_method->getInputCloud()->size();
 		normal_estimator->estimateNormals(pointcloud, surface, surface_search_method, sensor_pose_tf_guess, pointcloud);
 
 		if (number_surface_points != surface_search_method->getInputCloud()->size()) {
 			pointcloud_search_method = surface_search_method; // normal estimator changed the number of pointcloud points and updated the search kd tree
+			if (!pointcloud_is_map) {
+				ambient_pointcloud_search_methods_cache_.invalidateSearchMethod(surface);
+				ambient_pointcloud_search_methods_cache_.addSearchMethod(pointcloud_search_method);
+			}
 		}
 	} else {
+		if (!pointcloud_is_map) { updateAmbientPointCloudSearchMethod(pointcloud_search_method, pointcloud); }
 		normal_estimator->estimateNormals(pointcloud, pointcloud, pointcloud_search_method, sensor_pose_tf_guess, pointcloud);
+		if (!pointcloud_is_map) { ambient_pointcloud_search_methods_cache_.addSearchMethod(pointcloud_search_method); } // the normal estimator may have removed points and updated the kd tree
 	}
 
+	if (!pointcloud_is_map) { ambient_keypoints_descriptors_cache_->invalidateDescriptors(pointcloud); } // normals updated in place
+
 	localization_times_msg_.surface_normal_estimation_time += performance_timer.getElapsedTimeInMilliSec();
 
 	return pointcloud->size() > minimum_number_of_points_in_ambient_pointcloud_;
@@ -1431,9 +2080,12 @@ bool Localization<PointT>::applyNormalEstimation(typename NormalEstimator<PointT
 
 template<typename PointT>
 bool Localization<PointT>::applyKeypointDetection(std::vector< typename KeypointDetector<PointT>::Ptr >& keypoint_detectors, typename pcl::PointCloud<PointT>::Ptr& pointcloud, typename pcl::search::KdTree<PointT>::Ptr& surface_search_method, typename pcl::PointCloud<PointT>::Ptr& keypoints) {
+	DRL_TRACE_SCOPE("localization/keypoint_detection");
 	PerformanceTimer performance_timer;
 	performance_timer.start();
 
+	updateAmbientPointCloudSearchMethod(surface_search_method, pointcloud);
+	ambient_keypoints_descriptors_cache_->invalidateDescriptors(keypoints); // keypoints recomputed in place
 	keypoints->clear();
 	for (size_t i = 0; i < keypoint_detectors.size(); ++i) {
 		if (i == 0) {
@@ -1459,16 +2111,18 @@ bool Localization<PointT>::applyCloudRegistration(std::vector< typename CloudMat
 		tf2::Transform& pose_corrections_in_out) {
 
 	if (ambient_pointcloud->size() < minimum_number_of_points_in_ambient_pointcloud_) { return false; }
+	DRL_TRACE_SCOPE("localization/registration");
 
 	bool registration_successful = false;
 	for (size_t i = 0; i < matchers.size(); ++i) {
 		typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_aligned(new pcl::PointCloud<PointT>());
 		tf2::Transform pose_correction;
+		updateAmbientPointCloudSearchMethod(surface_search_method, ambient_pointcloud);
 		if (matchers[i]->registerCloud(ambient_pointcloud, surface_search_method, pointcloud_keypoints, pose_correction, accepted_pose_corrections_, ambient_pointcloud_aligned, false)) {
 			pose_corrections_in_out = pose_correction * pose_corrections_in_out;
 			registration_successful = true;
-			ambient_pointcloud = ambient_pointcloud_aligned; // switch pointers
-			surface_search_method->setInputCloud(ambient_pointcloud);
+			ambient_keypoints_descriptors_cache_->invalidateDescriptors(pointcloud_keypoints); // keypoints aligned in place
+			ambient_pointcloud = ambient_pointcloud_aligned; // switch pointers (the kd tree of the aligned cloud is only built if a later stage needs it)
 		}
 
 		int number_registration_iterations = matchers[i]->getNumberOfRegistrationIterations();
@@ -1497,13 +2151,185 @@ bool Localization<PointT>::applyCloudRegistration(std::vector< typename CloudMat
 
 
 template<typename PointT>
-double Localization<PointT>::applyOutlierDetection(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud) {
+bool Localization<PointT>::applyTrackingRecovery(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
+		typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
+		typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
+		const tf2::Transform& pointcloud_pose_initial_guess, tf2::Transform& pose_corrections_in_out) {
+	if (multi_hypothesis_tracking_recovery_enabled_ && !multi_hypothesis_tracking_recovery_matchers_.empty()) {
+		return applyMultiHypothesisTrackingRecovery(ambient_pointcloud, surface_search_method, pointcloud_keypoints, pointcloud_pose_initial_guess, pose_corrections_in_out);
+	}
+
+	return applyCloudRegistration(tracking_recovery_matchers_, ambient_pointcloud, surface_search_method, pointcloud_keypoints, pose_corrections_in_out);
+}
+
+
+template<typename PointT>
+void Localization<PointT>::generateTrackingRecoveryHypotheses(const tf2::Transform& pointcloud_pose_initial_guess, const tf2::Transform& pose_corrections, boost::uint64_t seed,
+		std::vector< TrackingRecoveryHypothesis >& hypotheses_out) {
+	hypotheses_out.clear();
+	if (multi_hypothesis_tracking_recovery_number_of_hypotheses_ < 1) { return; }
+	hypotheses_out.resize(multi_hypothesis_tracking_recovery_number_of_hypotheses_);
+
+	// first hypothesis -> current pose estimate (the same pose used by the single hypothesis tracking recovery)
+	tf2::Transform pose_estimate = pose_corrections * pointcloud_pose_initial_guess;
+	tf2::Transform last_accepted_pose_correction = tf2::Transform::getIdentity();
+	size_t first_random_hypothesis = 1;
+	double distance_travelled = 0.0;
+	double rotation_travelled = 0.0;
+
+	// second hypothesis -> last accepted pose (useful when the odometry drifted since the last valid pose)
+	if (last_accepted_pose_valid_) {
+		tf2::Transform last_accepted_pose = last_accepted_pose_base_link_to_map_;
+		if (reference_pointcloud_2d_) { last_accepted_pose.getOrigin().setZ(pose_estimate.getOrigin().getZ()); }
+		distance_travelled = (pose_estimate.getOrigin() - last_accepted_pose.getOrigin()).length();
+		rotation_travelled = std::abs(angles::normalize_angle((last_accepted_pose.getRotation().inverse() * pose_estimate.getRotation()).getAngle()));
+		last_accepted_pose_correction = last_accepted_pose * pose_estimate.inverse();
+		if (hypotheses_out.size() > 1) {
+			hypotheses_out[1].initial_pose_correction = last_accepted_pose_correction;
+			first_random_hypothesis = 2;
+		}
+	}
+
+	// remaining hypotheses -> random x, y, yaw offsets alternating around the current pose estimate and the last accepted pose,
+	// with a spread that grows with the odometry displacement since the last valid pose
+	double linear_uncertainty = multi_hypothesis_tracking_recovery_linear_uncertainty_ + multi_hypothesis_tracking_recovery_linear_uncertainty_per_meter_travelled_ * distance_travelled;
+	double angular_uncertainty = multi_hypothesis_tracking_recovery_angular_uncertainty_ + multi_hypothesis_tracking_recovery_angular_uncertainty_per_radian_rotated_ * rotation_travelled;
+	RandomGenerator random_generator(seed);
+	for (size_t i = first_random_hypothesis; i < hypotheses_out.size(); ++i) {
+		const tf2::Transform& center_correction = (i % 2 == 0) ? tf2::Transform::getIdentity() : last_accepted_pose_correction;
+		tf2::Vector3 center_position = (center_correction * pose_estimate).getOrigin();
+		tf2::Vector3 translation_offset((random_generator.nextDouble() * 2.0 - 1.0) * linear_uncertainty, (random_generator.nextDouble() * 2.0 - 1.0) * linear_uncertainty, 0.0);
+		tf2::Quaternion rotation_offset(tf2::Vector3(0.0, 0.0, 1.0), (random_generator.nextDouble() * 2.0 - 1.0) * angular_uncertainty);
+		hypotheses_out[i].initial_pose_correction = tf2::Transform(rotation_offset, center_position + translation_offset) * tf2::Transform(tf2::Quaternion::getIdentity(), -center_position) * center_correction; // rotation around the robot position
+	}
+}
+
+
+template<typename PointT>
+bool Localization<PointT>::compareTrackingRecoveryHypotheses(const TrackingRecoveryHypothesis& first, const TrackingRecoveryHypothesis& second) {
+	if (first.registration_successful != second.registration_successful) { return first.registration_successful; }
+	if (first.inliers_percentage != second.inliers_percentage) { return first.inliers_percentage > second.inliers_percentage; }
+	return first.root_mean_square_error < second.root_mean_square_error;
+}
+
+
+template<typename PointT>
+bool Localization<PointT>::applyMultiHypothesisTrackingRecovery(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
+		typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
+		typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
+		const tf2::Transform& pointcloud_pose_initial_guess, tf2::Transform& pose_corrections_in_out) {
+	if (ambient_pointcloud->size() < minimum_number_of_points_in_ambient_pointcloud_ || multi_hypothesis_tracking_recovery_matchers_.empty()) { return false; }
+	DRL_TRACE_SCOPE("localization/multi_hypothesis_tracking_recovery");
+
+	std::vector< TrackingRecoveryHypothesis > hypotheses;
+	generateTrackingRecoveryHypotheses(pointcloud_pose_initial_guess, pose_corrections_in_out, ambient_pointcloud->header.stamp, hypotheses);
+	if (hypotheses.empty()) { return false; }
+
+	bool use_keypoints = pointcloud_keypoints && pointcloud_keypoints != ambient_pointcloud && !pointcloud_keypoints->empty();
+	float inliers_max_squared_distance = (float)(multi_hypothesis_tracking_recovery_inliers_max_distance_ * multi_hypothesis_tracking_recovery_inliers_max_distance_);
+	int number_of_threads = (int)std::min(multi_hypothesis_tracking_recovery_matchers_.size(), hypotheses.size());
+
+	// the reference kd tree was built in updateMatchersReferenceCloud and the matchers use it with force_no_recompute, so the threads only search it
+	#pragma omp parallel for num_threads(number_of_threads) schedule(dynamic, 1)
+	for (int hypothesis_index = 0; hypothesis_index < (int)hypotheses.size(); ++hypothesis_index) {
+		std::vector< typename CloudMatcher<PointT>::Ptr >& matchers = multi_hypothesis_tracking_recovery_matchers_[omp_get_thread_num()];
+		TrackingRecoveryHypothesis& hypothesis = hypotheses[hypothesis_index];
+		Eigen::Transform<double, 3, Eigen::Affine> initial_pose_correction = laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<double>(hypothesis.initial_pose_correction);
+
+		typename pcl::PointCloud<PointT>::Ptr hypothesis_pointcloud(new pcl::PointCloud<PointT>());
+		pcl::transformPointCloudWithNormals(*ambient_pointcloud, *hypothesis_pointcloud, initial_pose_correction);
+		typename pcl::PointCloud<PointT>::Ptr hypothesis_keypoints = hypothesis_pointcloud;
+		if (use_keypoints) {
+			hypothesis_keypoints.reset(new pcl::PointCloud<PointT>());
+			pcl::transformPointCloudWithNormals(*pointcloud_keypoints, *hypothesis_keypoints, initial_pose_correction);
+		}
+
+		hypothesis.pose_correction = hypothesis.initial_pose_correction;
+		std::vector< tf2::Transform > accepted_pose_corrections;
+		for (size_t i = 0; i < matchers.size(); ++i) {
+			typename pcl::PointCloud<PointT>::Ptr hypothesis_pointcloud_aligned(new pcl::PointCloud<PointT>());
+			typename pcl::search::KdTree<PointT>::Ptr hypothesis_search_method(new pcl::search::KdTree<PointT>());
+			hypothesis_search_method->setInputCloud(hypothesis_pointcloud);
+			tf2::Transform pose_correction;
+			if (matchers[i]->registerCloud(hypothesis_pointcloud, hypothesis_search_method, hypothesis_keypoints, pose_correction, accepted_pose_corrections, hypothesis_pointcloud_aligned, false)) {
+				hypothesis.pose_correction = pose_correction * hypothesis.pose_correction;
+				hypothesis.registration_successful = true;
+				hypothesis_pointcloud = hypothesis_pointcloud_aligned;
+				if (use_keypoints) {
+					pcl::transformPointCloudWithNormals(*hypothesis_keypoints, *hypothesis_keypoints, laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<double>(pose_correction));
+				} else {
+					hypothesis_keypoints = hypothesis_pointcloud;
+				}
+			}
+
+			int number_registration_iterations = matchers[i]->getNumberOfRegistrationIterations();
+			if (number_registration_iterations > 0) hypothesis.number_of_registration_iterations += number_registration_iterations;
+		}
+
+		if (!hypothesis.registration_successful || hypothesis_pointcloud->empty()) { continue; }
+		hypothesis.ambient_pointcloud_aligned = hypothesis_pointcloud;
+
+		// fast scoring of the registered hypothesis (the transformation validators are only applied to the best hypotheses)
+		std::vector<int> index(1);
+		std::vector<float> squared_distance(1);
+		size_t number_inliers = 0;
+		double sum_squared_distances_inliers = 0.0;
+		for (size_t i = 0; i < hypothesis_pointcloud->size(); ++i) {
+			if (reference_pointcloud_search_method_->nearestKSearch((*hypothesis_pointcloud)[i], 1, index, squared_distance) > 0 && squared_distance[0] <= inliers_max_squared_distance) {
+				++number_inliers;
+				sum_squared_distances_inliers += squared_distance[0];
+			}
+		}
+
+		hypothesis.inliers_percentage = (double)number_inliers / (double)hypothesis_pointcloud->size();
+		if (number_inliers > 0) { hypothesis.root_mean_square_error = std::sqrt(sum_squared_distances_inliers / (double)number_inliers); }
+	}
+
+	for (size_t i = 0; i < hypotheses.size(); ++i) {
+		number_of_registration_iterations_for_all_matchers_ += hypotheses[i].number_of_registration_iterations;
+	}
+
+	std::sort(hypotheses.begin(), hypotheses.end(), &Localization<PointT>::compareTrackingRecoveryHypotheses);
+
+	size_t number_of_validated_hypotheses = multi_hypothesis_tracking_recovery_max_number_of_validated_hypotheses_ > 0 ? (size_t)multi_hypothesis_tracking_recovery_max_number_of_validated_hypotheses_ : hypotheses.size();
+	for (size_t i = 0; i < hypotheses.size() && i < number_of_validated_hypotheses && hypotheses[i].registration_successful; ++i) {
+		TrackingRecoveryHypothesis& hypothesis = hypotheses[i];
+		tf2::Transform pose_corrections = hypothesis.pose_correction * pose_corrections_in_out;
+		ROS_DEBUG_STREAM("Validating tracking recovery hypothesis " << i << " [ inliers: " << hypothesis.inliers_percentage << " | rmse: " << hypothesis.root_mean_square_error << " ]");
+
+		if (!transformation_validators_tracking_recovery_.empty()) {
+			tf2::Transform pose_corrected = pose_corrections * pointcloud_pose_initial_guess;
+			outlier_percentage_ = applyOutlierDetection(hypothesis.ambient_pointcloud_aligned, pose_corrected);
+			applyCloudAnalysis(pose_corrected);
+			if (!applyTransformationValidators(transformation_validators_tracking_recovery_, pointcloud_pose_initial_guess, pose_corrected, outlier_percentage_)) { continue; }
+		}
+
+		pose_corrections_in_out = pose_corrections;
+		ambient_pointcloud = hypothesis.ambient_pointcloud_aligned;
+		ROS_DEBUG_STREAM("Accepted tracking recovery hypothesis " << i << " out of " << hypotheses.size());
+		return true;
+	}
+
+	return false;
+}
+
+
+template<typename PointT>
+double Localization<PointT>::applyOutlierDetection(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, const tf2::Transform& estimated_pose) {
+	DRL_TRACE_SCOPE("localization/outlier_detection");
 	detected_outliers_.clear();
 	detected_inliers_.clear();
 	root_mean_square_error_inliers_ = std::numeric_limits<double>::max();
 	number_inliers_ = 0;
+	angular_distribution_computed_during_outlier_detection_ = false;
 	if (ambient_pointcloud->size() <= 0 || ambient_pointcloud->size() < minimum_number_of_points_in_ambient_pointcloud_) { return 1.0; }
 
+	// with a single detector, the angular histograms can be computed in the same pass over the ambient cloud
+	typename AngularDistributionAnalyzer<PointT>::Ptr angular_distribution_analyzer;
+	if (compute_angular_distribution_during_outlier_detection_ && outlier_detectors_.size() == 1 && (compute_outliers_angular_distribution_ || compute_inliers_angular_distribution_)) {
+		angular_distribution_analyzer = boost::dynamic_pointer_cast< AngularDistributionAnalyzer<PointT> >(cloud_analyzer_);
+	}
+
 	size_t number_outliers = 0;
 	for (size_t i = 0; i < outlier_detectors_.size(); ++i) {
 		typename pcl::PointCloud<PointT>::Ptr outliers;
@@ -1519,7 +2345,16 @@ double Localization<PointT>::applyOutlierDetection(typename pcl::PointCloud<Poin
 			inliers->header = ambient_pointcloud->header;
 		}
 
-		number_outliers += outlier_detectors_[i]->detectOutliers(reference_pointcloud_search_method_, *ambient_pointcloud, outliers, inliers, root_mean_square_error_inliers_);
+		if (angular_distribution_analyzer) {
+			inliers_angular_distribution_ = 2.0;
+			outliers_angular_distribution_ = -2.0;
+			number_outliers += outlier_detectors_[i]->detectOutliersWithAngularDistribution(reference_pointcloud_search_method_, *ambient_pointcloud, outliers, inliers, root_mean_square_error_inliers_,
+					*angular_distribution_analyzer, estimated_pose, compute_outliers_angular_distribution_, compute_inliers_angular_distribution_,
+					outliers_angular_distribution_, inliers_angular_distribution_);
+			angular_distribution_computed_during_outlier_detection_ = true;
+		} else {
+			number_outliers += outlier_detectors_[i]->detectOutliers(reference_pointcloud_search_method_, *ambient_pointcloud, outliers, inliers, root_mean_square_error_inliers_);
+		}
 		detected_outliers_.push_back(outliers);
 		detected_inliers_.push_back(inliers);
 	}
@@ -1551,6 +2386,9 @@ double Localization<PointT>::applyOutlierDetection(typename pcl::PointCloud<Poin
 
 template<typename PointT>
 bool Localization<PointT>::applyCloudAnalysis(const tf2::Transform& estimated_pose) {
+	if (angular_distribution_computed_during_outlier_detection_) { return true; }
+	DRL_TRACE_SCOPE("localization/cloud_analysis");
+
 	bool performed_analysis = false;
 	inliers_angular_distribution_ = 2.0;
 	outliers_angular_distribution_ = -2.0;
@@ -1599,6 +2437,7 @@ void Localization<PointT>::publishDetectedInliers() {
 
 template<typename PointT>
 bool Localization<PointT>::applyTransformationValidators(std::vector< TransformationValidator::Ptr >& transformation_validators, const tf2::Transform& pointcloud_pose_initial_guess, tf2::Transform& pointcloud_pose_corrected_in_out, double max_outlier_percentage) {
+	DRL_TRACE_SCOPE("localization/transformation_validation");
 	for (size_t i = 0; i < transformation_validators.size(); ++i) {
 		if (last_accepted_pose_valid_ && (ros::Time::now() - last_accepted_pose_time_ < pose_tracking_timeout_)) {
 			if (!transformation_validators[i]->validateNewLocalizationPose(last_accepted_pose_base_link_to_map_, pointcloud_pose_initial_guess, pointcloud_pose_corrected_in_out, root_mean_square_error_inliers_, max_outlier_percentage, inliers_angular_distribution_, outliers_angular_distribution_)) {
@@ -1636,8 +2475,11 @@ void Localization<PointT>::fillPoseCovariance(geometry_msgs::PoseWithCovarianceS
 
 template<typename PointT>
 bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, const ros::Time& pointcloud_time, const tf2::Transform& pointcloud_pose_initial_guess,
-		tf2::Transform& pointcloud_pose_corrected_out, tf2::Transform& pose_corrections_out, typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_keypoints_out) {
+		tf2::Transform& pointcloud_pose_corrected_out, tf2::Transform& pose_corrections_out, typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_keypoints_out,
+		const typename PreprocessedAmbientPointCloud::Ptr& preprocessed_ambient_pointcloud) {
 	last_number_points_inserted_in_circular_buffer_ = 0;
+	ambient_pointcloud_search_methods_cache_.clear();
+	ambient_keypoints_descriptors_cache_->clear();
 	localization_diagnostics_msg_.number_keypoints_ambient_pointcloud = 0;
 	pointcloud_pose_corrected_out = pointcloud_pose_initial_guess;
 	accepted_pose_corrections_.clear();
@@ -1670,47 +2512,65 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 	}
 
 	typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_raw;
-	if (ambient_cloud_normal_estimator_ && (compute_normals_when_tracking_pose_ || compute_normals_when_estimating_initial_pose_ || compute_normals_when_recovering_pose_tracking_)) {
-		if (use_filtered_cloud_as_normal_estimation_surface_ambient_) {
-			ROS_DEBUG("Using filtered ambient point cloud for normal estimation");
-		} else {
-			ROS_DEBUG("Using raw ambient point cloud for normal estimation");
-			ambient_pointcloud_raw = typename pcl::PointCloud<PointT>::Ptr(new pcl::PointCloud<PointT>(*ambient_pointcloud));
-			if (!transformCloudToMapFrame(ambient_pointcloud_raw, pointcloud_time)) { return false; }
-			if (reference_pointcloud_2d_) { resetPointCloudHeight(*ambient_pointcloud_raw); }
-		}
-	}
-
 	PerformanceTimer performance_timer;
 	performance_timer.start();
-	// ==============================================================  filters
-	localization_diagnostics_msg_.number_points_ambient_pointcloud = ambient_pointcloud->size();
-	if (!applyFilters(lost_tracking ? ambient_pointcloud_feature_registration_filters_ : ambient_pointcloud_filters_, ambient_pointcloud)) { return false; }
-	if (!transformCloudToMapFrame(ambient_pointcloud, pointcloud_time)) { return false; }
-	if (!applyFilters(lost_tracking ? ambient_pointcloud_map_frame_feature_registration_filters_ : ambient_pointcloud_filters_map_frame_, ambient_pointcloud)) { return false; }
-	if (reference_pointcloud_2d_) { resetPointCloudHeight(*ambient_pointcloud); }
-	localization_times_msg_.filtering_time = performance_timer.getElapsedTimeInMilliSec();
-
-	localization_diagnostics_msg_.number_points_ambient_pointcloud_after_filtering = ambient_pointcloud->size();
-	if (ambient_pointcloud_with_circular_buffer_) {
-		ambient_pointcloud_with_circular_buffer_->insert(*ambient_pointcloud);
-		ambient_pointcloud_with_circular_buffer_->getPointCloud()->header = ambient_pointcloud->header;
-		ambient_pointcloud_with_circular_buffer_->getPointCloud()->sensor_origin_ = ambient_pointcloud->sensor_origin_;
-		ambient_pointcloud_with_circular_buffer_->getPointCloud()->sensor_orientation_ = ambient_pointcloud->sensor_orientation_;
-		last_number_points_inserted_in_circular_buffer_ = ambient_pointcloud->size();
-		ambient_pointcloud = ambient_pointcloud_with_circular_buffer_->getPointCloud();
-		ROS_DEBUG_STREAM("Ambient pointcloud with circular buffer has " << ambient_pointcloud->size() << " points");
+	bool use_preprocessed_ambient_pointcloud = !lost_tracking && !ambient_pointcloud_integration && preprocessed_ambient_pointcloud && preprocessed_ambient_pointcloud->preprocessed
+			&& correctPreprocessedAmbientPointCloudPose(*preprocessed_ambient_pointcloud, last_accepted_pose_odom_to_map_);
+	if (use_preprocessed_ambient_pointcloud) {
+		ROS_DEBUG("Using the ambient point cloud filtered by the preprocessing thread");
+		ambient_pointcloud = preprocessed_ambient_pointcloud->ambient_pointcloud;
+		ambient_pointcloud_raw = preprocessed_ambient_pointcloud->ambient_pointcloud_raw;
+		if (preprocessed_ambient_pointcloud->ambient_pointcloud_search_method) { ambient_pointcloud_search_methods_cache_.addSearchMethod(preprocessed_ambient_pointcloud->ambient_pointcloud_search_method); }
+		localization_diagnostics_msg_.number_points_ambient_pointcloud = preprocessed_ambient_pointcloud->number_points_ambient_pointcloud;
+		localization_diagnostics_msg_.number_points_ambient_pointcloud_after_filtering = ambient_pointcloud->size();
+		localization_times_msg_.filtering_time = preprocessed_ambient_pointcloud->filtering_time;
+	} else {
+		if (ambient_cloud_normal_estimator_ && (compute_normals_when_tracking_pose_ || compute_normals_when_estimating_initial_pose_ || compute_normals_when_recovering_pose_tracking_)) {
+			if (use_filtered_cloud_as_normal_estimation_surface_ambient_) {
+				ROS_DEBUG("Using filtered ambient point cloud for normal estimation");
+			} else {
+				ROS_DEBUG("Using raw ambient point cloud for normal estimation");
+				bool ambient_pointcloud_is_sensor_message = preprocessed_ambient_pointcloud && !preprocessed_ambient_pointcloud->merged_synchronized_sensors && ambient_pointcloud == preprocessed_ambient_pointcloud->ambient_pointcloud_sensor_frame;
+				bool surface_has_normals = ambient_pointcloud_is_sensor_message && readOrganizedNormalEstimationSurface(ambient_pointcloud_reader_, ambient_cloud_normal_estimator_, preprocessed_ambient_pointcloud->ambient_pointcloud_msg, ambient_pointcloud_raw);
+				if (!surface_has_normals) {
+					ambient_pointcloud_raw = typename pcl::PointCloud<PointT>::Ptr(new pcl::PointCloud<PointT>(*ambient_pointcloud));
+				}
+				if (!transformCloudToMapFrame(ambient_pointcloud_raw, pointcloud_time, last_accepted_pose_odom_to_map_, surface_has_normals)) { return false; }
+				if (reference_pointcloud_2d_) { resetPointCloudHeight(*ambient_pointcloud_raw); }
+			}
+		}
+
+		// ==============================================================  filters
+		localization_diagnostics_msg_.number_points_ambient_pointcloud = ambient_pointcloud->size();
+		if (!applyFilters(lost_tracking ? ambient_pointcloud_feature_registration_filters_ : ambient_pointcloud_filters_, ambient_pointcloud)) { return false; }
+		if (!transformCloudToMapFrame(ambient_pointcloud, pointcloud_time)) { return false; }
+		if (!applyFilters(lost_tracking ? ambient_pointcloud_map_frame_feature_registration_filters_ : ambient_pointcloud_filters_map_frame_, ambient_pointcloud)) { return false; }
+		if (reference_pointcloud_2d_) { resetPointCloudHeight(*ambient_pointcloud); }
+		localization_times_msg_.filtering_time = performance_timer.getElapsedTimeInMilliSec();
+
+		localization_diagnostics_msg_.number_points_ambient_pointcloud_after_filtering = ambient_pointcloud->size();
+		if (ambient_pointcloud_with_circular_buffer_) {
+			ambient_pointcloud_with_circular_buffer_->insert(*ambient_pointcloud);
+			ambient_pointcloud_with_circular_buffer_->getPointCloud()->header = ambient_pointcloud->header;
+			ambient_pointcloud_with_circular_buffer_->getPointCloud()->sensor_origin_ = ambient_pointcloud->sensor_origin_;
+			ambient_pointcloud_with_circular_buffer_->getPointCloud()->sensor_orientation_ = ambient_pointcloud->sensor_orientation_;
+			last_number_points_inserted_in_circular_buffer_ = ambient_pointcloud->size();
+			ambient_pointcloud = ambient_pointcloud_with_circular_buffer_->getPointCloud();
+			ROS_DEBUG_STREAM("Ambient pointcloud with circular buffer has " << ambient_pointcloud->size() << " points");
+		}
 	}
 
 
 	// ==============================================================  normal estimation
 	if (ambient_pointcloud->size() < minimum_number_of_points_in_ambient_pointcloud_) { return false; }
 
-	typename pcl::search::KdTree<PointT>::Ptr ambient_search_method(new pcl::search::KdTree<PointT>());
-	ambient_search_method->setInputCloud(ambient_pointcloud);
+	typename pcl::search::KdTree<PointT>::Ptr ambient_search_method = ambient_pointcloud_search_methods_cache_.getSearchMethod(ambient_pointcloud);
 	bool computed_normals = false;
 	localization_times_msg_.surface_normal_estimation_time = 0.0;
-	if (compute_normals_when_tracking_pose_ && ambient_cloud_normal_estimator_) {
+	if (use_preprocessed_ambient_pointcloud && preprocessed_ambient_pointcloud->computed_normals) {
+		localization_times_msg_.surface_normal_estimation_time = preprocessed_ambient_pointcloud->surface_normal_estimation_time;
+		computed_normals = true;
+	} else if (compute_normals_when_tracking_pose_ && ambient_cloud_normal_estimator_) {
 		if (!applyNormalEstimation(ambient_cloud_normal_estimator_, ambient_pointcloud, ambient_pointcloud_raw, ambient_search_method)) { return false; }
 		computed_normals = true;
 	}
@@ -1803,7 +2663,7 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 				}
 
 				performance_timer.restart();
-				if (applyCloudRegistration(tracking_recovery_matchers_, ambient_pointcloud, ambient_search_method, ambient_pointcloud_keypoints_out->size() < minimum_number_of_points_in_ambient_pointcloud_ ? ambient_pointcloud : ambient_pointcloud_keypoints_out, pose_corrections_out)) {
+				if (applyTrackingRecovery(ambient_pointcloud, ambient_search_method, ambient_pointcloud_keypoints_out->size() < minimum_number_of_points_in_ambient_pointcloud_ ? ambient_pointcloud : ambient_pointcloud_keypoints_out, pointcloud_pose_initial_guess, pose_corrections_out)) {
 					ROS_INFO("Successfully performed registration recovery");
 					performed_recovery = true;
 					localization_times_msg_.pointcloud_registration_time += performance_timer.getElapsedTimeInMilliSec();
@@ -1823,7 +2683,7 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 
 	// ==============================================================  outlier detection
 	performance_timer.restart();
-	outlier_percentage_ = applyOutlierDetection(ambient_pointcloud_integration ? ambient_pointcloud_integration : ambient_pointcloud);
+	outlier_percentage_ = applyOutlierDetection(ambient_pointcloud_integration ? ambient_pointcloud_integration : ambient_pointcloud, pointcloud_pose_corrected_out);
 	localization_times_msg_.outlier_detection_time = performance_timer.getElapsedTimeInMilliSec();
 
 
@@ -1852,7 +2712,7 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 					computed_keypoints = true;
 				}
 
-				if (applyCloudRegistration(tracking_recovery_matchers_, ambient_pointcloud, ambient_search_method, ambient_pointcloud_keypoints_out->size() < minimum_number_of_points_in_ambient_pointcloud_ ? ambient_pointcloud : ambient_pointcloud_keypoints_out, pose_corrections_out)) {
+				if (applyTrackingRecovery(ambient_pointcloud, ambient_search_method, ambient_pointcloud_keypoints_out->size() < minimum_number_of_points_in_ambient_pointcloud_ ? ambient_pointcloud : ambient_pointcloud_keypoints_out, pointcloud_pose_initial_guess, pose_corrections_out)) {
 					pointcloud_pose_corrected_out = pose_corrections_out * pointcloud_pose_initial_guess;
 					ROS_INFO("Successfully applied registration recovery");
 					localization_times_msg_.pointcloud_registration_time += performance_timer.getElapsedTimeInMilliSec();
@@ -1862,7 +2722,7 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 					}
 
 					performance_timer.restart();
-					outlier_percentage_ = applyOutlierDetection(ambient_pointcloud_integration ? ambient_pointcloud_integration : ambient_pointcloud);
+					outlier_percentage_ = applyOutlierDetection(ambient_pointcloud_integration ? ambient_pointcloud_integration : ambient_pointcloud, pointcloud_pose_corrected_out);
 					localization_times_msg_.outlier_detection_time += performance_timer.getElapsedTimeInMilliSec();
 
 					performance_timer.restart();
@@ -1896,14 +2756,14 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 
 	performance_timer.restart();
 	if (registration_covariance_estimator_) {
+		DRL_TRACE_SCOPE("localization/registration_covariance_estimation");
 		double opengl_matrix[16];
 		pose_corrections_out.getOpenGLMatrix(opengl_matrix);
 		Eigen::Matrix4d registration_corrections(opengl_matrix);
 
+		updateAmbientPointCloudSearchMethod(ambient_search_method, ambient_pointcloud);
 		if (registered_inliers_->size() > minimum_number_of_points_in_ambient_pointcloud_) {
-			typename pcl::search::KdTree<PointT>::Ptr registered_inliers_search_method(new pcl::search::KdTree<PointT>());
-			registered_inliers_search_method->setInputCloud(ambient_pointcloud);
-			registration_covariance_estimator_->computeRegistrationCovariance(registered_inliers_, registered_inliers_search_method, registration_corrections.cast<float>(),
+			registration_covariance_estimator_->computeRegistrationCovariance(registered_inliers_, ambient_search_method, registration_corrections.cast<float>(),
 					laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<float>(pointcloud_pose_corrected_out.inverse()), base_link_frame_id_, last_accepted_pose_covariance_);
 		} else {
 			registration_covariance_estimator_->computeRegistrationCovariance(ambient_pointcloud, ambient_search_method, registration_corrections.cast<float>(),
@@ -1933,6 +2793,7 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 
 template<typename PointT>
 bool Localization<PointT>::updateReferencePointCloudWithAmbientPointCloud(typename pcl::PointCloud<PointT>::Ptr& pointcloud, typename pcl::PointCloud<PointT>::Ptr pointcloud_keypoints) {
+	DRL_TRACE_SCOPE("localization/map_update");
 	ROS_DEBUG_STREAM("Adding " << pointcloud->size() << " points to a reference cloud with " << reference_pointcloud_->size() << " points");
 
 	*reference_pointcloud_ += *pointcloud;
@@ -1942,7 +2803,17 @@ bool Localization<PointT>::updateReferencePointCloudWithAmbientPointCloud(typena
 		localization_diagnostics_msg_.number_points_reference_pointcloud = reference_pointcloud_->size();
 		localization_diagnostics_msg_.number_points_reference_pointcloud_after_filtering = reference_pointcloud_->size();
 		localization_diagnostics_msg_.number_keypoints_reference_pointcloud = reference_pointcloud_keypoints_->size();
-		reference_pointcloud_search_method_->setInputCloud(reference_pointcloud_);
+
+		if (reference_pointcloud_incremental_search_method_) {
+			if (reference_pointcloud_search_method_ == reference_pointcloud_incremental_search_method_ && reference_pointcloud_incremental_search_method_->getInputCloud() == reference_pointcloud_) {
+				reference_pointcloud_incremental_search_method_->updateIndexWithNewPoints(); // only the new points are indexed (the full index is rebalanced lazily)
+			} else {
+				reference_pointcloud_incremental_search_method_->setInputCloud(reference_pointcloud_);
+				reference_pointcloud_search_method_ = reference_pointcloud_incremental_search_method_;
+			}
+		} else {
+			reference_pointcloud_search_method_->setInputCloud(reference_pointcloud_);
+		}
 
 		updateMatchersReferenceCloud();
 		publishReferencePointCloud();
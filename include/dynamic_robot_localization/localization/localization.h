@@ -14,14 +14,17 @@
 // std includes
 #include <string>
 #include <vector>
+#include <deque>
 #include <algorithm>
 #include <utility>
 #include <cmath>
 #include <limits>
+#include <sys/stat.h>
 
 
 // ROS includes
 #include <ros/ros.h>
+#include <ros/callback_queue.h>
 #include <tf2/LinearMath/Transform.h>
 #include <tf2/LinearMath/Matrix3x3.h>
 #include <tf2/LinearMath/Quaternion.h>
@@ -48,7 +51,10 @@
 
 // external libs includes
 #include <boost/smart_ptr/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <Eigen/Core>
+#include <omp.h>
 
 // project includes
 #include <dynamic_robot_localization/common/configurable_object.h>
@@ -67,12 +73,15 @@
 #include <dynamic_robot_localization/cloud_filters/random_sample.h>
 #include <dynamic_robot_localization/cloud_filters/statistical_outlier_removal.h>
 #include <dynamic_robot_localization/cloud_filters/covariance_sampling.h>
+#include <dynamic_robot_localization/cloud_filters/fused_crop_voxel_grid.h>
 
 #include <dynamic_robot_localization/curvature_estimators/curvature_estimator.h>
 #include <dynamic_robot_localization/curvature_estimators/principal_curvatures_estimation.h>
 #include <dynamic_robot_localization/normal_estimators/normal_estimator.h>
 #include <dynamic_robot_localization/normal_estimators/normal_estimator_sac.h>
 #include <dynamic_robot_localization/normal_estimators/normal_estimation_omp.h>
+#include <dynamic_robot_localization/normal_estimators/integral_image_normal_estimation.h>
+#include <dynamic_robot_localization/normal_estimators/normal_and_principal_curvatures_estimation.h>
 #include <dynamic_robot_localization/normal_estimators/moving_least_squares.h>
 
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/keypoint_detectors/keypoint_detector.h>
@@ -95,6 +104,7 @@
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point_generalized.h>
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/normal_distributions_transform_2d.h>
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/normal_distributions_transform_3d.h>
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/branch_and_bound_2d.h>
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/sample_consensus_initial_alignment.h>
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/sample_consensus_initial_alignment_prerejective.h>
 
@@ -114,7 +124,14 @@
 #include <dynamic_robot_localization/registration_covariance_estimators/registration_covariance_point_to_plane_pm_3d.h>
 
 #include <dynamic_robot_localization/common/circular_buffer_pointcloud.h>
+#include <dynamic_robot_localization/common/incremental_kdtree.h>
+#include <dynamic_robot_localization/common/kdtree_cache.h>
+#include <dynamic_robot_localization/common/keypoint_descriptors_cache.h>
 #include <dynamic_robot_localization/common/performance_timer.h>
+#include <dynamic_robot_localization/common/pointcloud2_reader.h>
+#include <dynamic_robot_localization/common/preprocessed_map_cache.h>
+#include <dynamic_robot_localization/common/random_generator.h>
+#include <dynamic_robot_localization/common/tracer.h>
 
 // project msgs
 #include <dynamic_robot_localization/LocalizationDetailed.h>
@@ -134,6 +151,52 @@ class Localization : public ConfigurableObject {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <typedefs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		typedef boost::shared_ptr< Localization<PointT> > Ptr;
 		typedef boost::shared_ptr< const Localization<PointT> > ConstPtr;
+
+		/** \brief Ambient point cloud filtered and with normals in the map frame, computed by the preprocessing thread when pipelined processing is enabled. */
+		struct PreprocessedAmbientPointCloud {
+			typedef boost::shared_ptr< PreprocessedAmbientPointCloud > Ptr;
+			PreprocessedAmbientPointCloud() : sensor_index(0), preprocessed(false), computed_normals(false), merged_synchronized_sensors(false), number_points_ambient_pointcloud(0), filtering_time(0.0), surface_normal_estimation_time(0.0) {}
+
+			sensor_msgs::PointCloud2ConstPtr ambient_pointcloud_msg;
+			typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_sensor_frame;  // unfiltered, used when the preprocessing has to be repeated (in the sensor frame of ambient_pointcloud_msg when merging synchronized sensors)
+			typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud;
+			typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_raw;
+			typename pcl::search::KdTree<PointT>::Ptr ambient_pointcloud_search_method;
+			tf2::Transform odom_to_map_used_in_preprocessing;
+			size_t sensor_index;
+			bool preprocessed;
+			bool computed_normals;
+			bool merged_synchronized_sensors;
+			size_t number_points_ambient_pointcloud;
+			double filtering_time;
+			double surface_normal_estimation_time;
+		};
+
+		/** \brief Preprocessing thread of one ambient point cloud topic, with its own reader, filters and normal estimator. */
+		struct AmbientPointCloudPreprocessor {
+			typedef boost::shared_ptr< AmbientPointCloudPreprocessor > Ptr;
+
+			std::string topic_name;
+			ros::CallbackQueue callback_queue;
+			boost::shared_ptr< ros::AsyncSpinner > spinner;
+			PointCloud2Reader<PointT> pointcloud_reader;
+			std::vector< typename CloudFilter<PointT>::Ptr > filters;
+			std::vector< typename CloudFilter<PointT>::Ptr > filters_map_frame;
+			typename NormalEstimator<PointT>::Ptr normal_estimator;
+		};
+
+		/** \brief Pose hypothesis (correction in the map frame applied before the tracking recovery matchers) evaluated by the multi hypothesis tracking recovery. */
+		struct TrackingRecoveryHypothesis {
+			TrackingRecoveryHypothesis() : initial_pose_correction(tf2::Transform::getIdentity()), pose_correction(tf2::Transform::getIdentity()), registration_successful(false), inliers_percentage(0.0), root_mean_square_error(std::numeric_limits<double>::max()), number_of_registration_iterations(0) {}
+
+			tf2::Transform initial_pose_correction;
+			tf2::Transform pose_correction;  // total correction (matchers corrections * initial_pose_correction)
+			typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_aligned;
+			bool registration_successful;
+			double inliers_percentage;
+			double root_mean_square_error;
+			int number_of_registration_iterations;
+		};
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </typedefs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <enums>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -162,6 +225,10 @@ class Localization : public ConfigurableObject {
 		void setupInitialPose();
 		void setupMessageManagement();
 		void setupReferencePointCloud();
+		void setupPipelinedProcessing();
+		void setupMultiHypothesisTrackingRecovery();
+		void setupTracing();
+		void publishTracingReports(bool force_report = false);
 
 		virtual void setupFiltersConfigurations();
 		void loadFiltersFromParameterServer(std::vector< typename CloudFilter<PointT>::Ptr >& filters_container, std::string configuration_namespace);
@@ -178,6 +245,7 @@ class Localization : public ConfigurableObject {
 		template <typename DescriptorT>
 		void loadKeypointMatcherFromParameterServer(std::vector< typename CloudMatcher<PointT>::Ptr >& featurecloud_matchers, typename KeypointDescriptor<PointT, DescriptorT>::Ptr& keypoint_descriptor,
 				const std::string& keypoint_descriptor_configuration_namespace, const std::string& feature_matcher_configuration_namespace);
+		virtual void setupKeypointDescriptorsCache(std::vector< typename CloudMatcher<PointT>::Ptr >& matchers);
 		virtual void setupTransformationValidatorsConfigurations(std::vector< TransformationValidator::Ptr >& validators, const std::string& configuration_namespace);
 		virtual void setupOutlierDetectorsConfigurations();
 		virtual void setupCloudAnalyzersConfigurations();
@@ -188,6 +256,8 @@ class Localization : public ConfigurableObject {
 		void loadReferencePointCloudFromROSOccupancyGrid(const nav_msgs::OccupancyGridConstPtr& occupancy_grid_msg);
 		void publishReferencePointCloud();
 		bool updateLocalizationPipelineWithNewReferenceCloud();
+		void updateLocalizationPipelineWithPreprocessedReferenceCloud();
+		boost::uint64_t computeReferencePointCloudPreprocessingConfigurationHash();
 		void updateMatchersReferenceCloud();
 
 		void setInitialPose(const geometry_msgs::Pose& pose, const std::string& frame_id, const ros::Time& pose_time);
@@ -198,12 +268,38 @@ class Localization : public ConfigurableObject {
 		void startLocalization();
 
 		bool transformCloudToMapFrame(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, const ros::Time& timestamp);
+		bool transformCloudToMapFrame(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, const ros::Time& timestamp, const tf2::Transform& odom_to_map, bool transform_normals = false);
 		void processAmbientPointCloud(const sensor_msgs::PointCloud2ConstPtr& ambient_cloud_msg);
+		void processPreprocessedAmbientPointCloud(const typename PreprocessedAmbientPointCloud::Ptr& preprocessed_ambient_pointcloud);
+
+		typename AmbientPointCloudPreprocessor::Ptr createAmbientPointCloudPreprocessor(const std::string& topic_name);
+
+		/** \brief Callback of the preprocessing thread of each sensor (pipelined processing), which filters and computes the normals of scan k+1 while scan k is being registered. */
+		void preprocessAmbientPointCloud(const sensor_msgs::PointCloud2ConstPtr& ambient_cloud_msg, size_t sensor_index);
+		bool correctPreprocessedAmbientPointCloudPose(PreprocessedAmbientPointCloud& preprocessed_ambient_pointcloud, const tf2::Transform& odom_to_map);
+		typename PreprocessedAmbientPointCloud::Ptr popPreprocessedAmbientPointCloud(const boost::posix_time::time_duration& timeout);
+		typename PreprocessedAmbientPointCloud::Ptr mergeSynchronizedPreprocessedAmbientPointClouds(const typename PreprocessedAmbientPointCloud::Ptr& first_preprocessed_ambient_pointcloud,
+				std::vector< typename PreprocessedAmbientPointCloud::Ptr >& unmerged_preprocessed_ambient_pointclouds_out);
+		bool mergeSynchronizedSensorFramePointClouds(const std::vector< typename PreprocessedAmbientPointCloud::Ptr >& preprocessed_ambient_pointclouds, const typename PreprocessedAmbientPointCloud::Ptr& reference_preprocessed_ambient_pointcloud,
+				typename pcl::PointCloud<PointT>::Ptr& merged_pointcloud_out);
+		bool lookForSensorToOdomTransform(const std::string& sensor_frame_id, const ros::Time& timestamp, tf2::Transform& sensor_to_odom_out);
+		void updatePipelinedProcessingPoseEstimate();
+		void spinPipelinedProcessing();
 		void resetPointCloudHeight(pcl::PointCloud<PointT>& pointcloud, float height = 0.0f);
 
+		/**
+		 * \brief Reads the organized sensor cloud (keeping the invalid points as NaNs) when the normal estimator uses organized surfaces and estimates its normals in the sensor frame.
+		 * Returns false if the normal estimation surface should be copied from the compacted cloud.
+		 */
+		bool readOrganizedNormalEstimationSurface(PointCloud2Reader<PointT>& pointcloud_reader, const typename NormalEstimator<PointT>::Ptr& normal_estimator,
+				const sensor_msgs::PointCloud2ConstPtr& ambient_cloud_msg, typename pcl::PointCloud<PointT>::Ptr& surface_out);
+
 
 		virtual bool applyFilters(std::vector< typename CloudFilter<PointT>::Ptr >& cloud_filters, typename pcl::PointCloud<PointT>::Ptr& pointcloud);
 
+		/** \brief Switches the search method to the cached kd-tree of the ambient point cloud (the reference point cloud search method is left unchanged). */
+		void updateAmbientPointCloudSearchMethod(typename pcl::search::KdTree<PointT>::Ptr& search_method, const typename pcl::PointCloud<PointT>::Ptr& pointcloud);
+
 		virtual bool applyNormalEstimation(typename NormalEstimator<PointT>::Ptr& normal_estimator, typename pcl::PointCloud<PointT>::Ptr& pointcloud,
 				typename pcl::PointCloud<PointT>::Ptr& surface,
 				typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method, bool pointcloud_is_map = false);
@@ -217,7 +313,19 @@ class Localization : public ConfigurableObject {
 				typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
 				tf2::Transform& pointcloud_pose_in_out);
 
-		virtual double applyOutlierDetection(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud);
+		virtual bool applyTrackingRecovery(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
+				typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
+				typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
+				const tf2::Transform& pointcloud_pose_initial_guess, tf2::Transform& pose_corrections_in_out);
+		virtual void generateTrackingRecoveryHypotheses(const tf2::Transform& pointcloud_pose_initial_guess, const tf2::Transform& pose_corrections, boost::uint64_t seed,
+				std::vector< TrackingRecoveryHypothesis >& hypotheses_out);
+		static bool compareTrackingRecoveryHypotheses(const TrackingRecoveryHypothesis& first, const TrackingRecoveryHypothesis& second);
+		virtual bool applyMultiHypothesisTrackingRecovery(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
+				typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
+				typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
+				const tf2::Transform& pointcloud_pose_initial_guess, tf2::Transform& pose_corrections_in_out);
+
+		virtual double applyOutlierDetection(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, const tf2::Transform& estimated_pose);
 		virtual bool applyCloudAnalysis(const tf2::Transform& estimated_pose);
 		virtual void publishDetectedOutliers();
 		virtual void publishDetectedInliers();
@@ -229,14 +337,22 @@ class Localization : public ConfigurableObject {
 
 		virtual bool updateLocalizationWithAmbientPointCloud(typename pcl::PointCloud<PointT>::Ptr& pointcloud, const ros::Time& pointcloud_time,
 				const tf2::Transform& pointcloud_pose_initial_guess,
-				tf2::Transform& pointcloud_pose_corrected_out, tf2::Transform& pose_corrections_out, typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_keypoints_out);
+				tf2::Transform& pointcloud_pose_corrected_out, tf2::Transform& pose_corrections_out, typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_keypoints_out,
+				const typename PreprocessedAmbientPointCloud::Ptr& preprocessed_ambient_pointcloud = typename PreprocessedAmbientPointCloud::Ptr());
 		virtual bool updateReferencePointCloudWithAmbientPointCloud(typename pcl::PointCloud<PointT>::Ptr& pointcloud, typename pcl::PointCloud<PointT>::Ptr pointcloud_keypoints);
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </Localization-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline const LocalizationTimes& getLocalizationTimesMsg() const { return localization_times_msg_; }
+		inline const LocalizationDiagnostics& getLocalizationDiagnosticsMsg() const { return localization_diagnostics_msg_; }
+		inline const std::string& getReferencePointcloudFilename() const { return reference_pointcloud_filename_; }
+		inline const std::string& getMapFrameId() const { return map_frame_id_; }
+		inline bool getReferencePointcloudReceived() const { return reference_pointcloud_received_; }
+		inline const tf2::Transform& getLastAcceptedPoseBaseLinkToMap() const { return last_accepted_pose_base_link_to_map_; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline void setLocalizationTimesMsg(const LocalizationTimes& localization_times_msg) { localization_times_msg_ = localization_times_msg; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 	// ========================================================================   </public-section>  ===========================================================================
 
@@ -265,6 +381,7 @@ class Localization : public ConfigurableObject {
 		// configuration fields
 		std::string reference_pointcloud_filename_;
 		std::string reference_pointcloud_preprocessed_save_filename_;
+		std::string reference_pointcloud_preprocessed_cache_filename_;
 		std::string reference_pointcloud_keypoints_filename_;
 		std::string reference_pointcloud_keypoints_save_filename_;
 		MapUpdateMode map_update_mode_;
@@ -300,6 +417,7 @@ class Localization : public ConfigurableObject {
 		bool compute_keypoints_when_estimating_initial_pose_;
 		bool compute_inliers_angular_distribution_;
 		bool compute_outliers_angular_distribution_;
+		bool compute_angular_distribution_during_outlier_detection_;
 		double inliers_angular_distribution_;
 		double outliers_angular_distribution_;
 		double last_pose_weighted_mean_filter_;
@@ -320,6 +438,7 @@ class Localization : public ConfigurableObject {
 		bool ignore_height_corrections_;
 		bool last_accepted_pose_valid_;
 		bool last_accepted_pose_performed_tracking_reset_;
+		bool angular_distribution_computed_during_outlier_detection_;
 		bool received_external_initial_pose_estimation_; // from rviz / other localization system / operator
 		bool use_internal_tracking_;
 		Eigen::MatrixXd last_accepted_pose_covariance_;
@@ -353,6 +472,10 @@ class Localization : public ConfigurableObject {
 		typename CircularBufferPointCloud<PointT>::Ptr ambient_pointcloud_with_circular_buffer_;
 		size_t last_number_points_inserted_in_circular_buffer_;
 		typename pcl::search::KdTree<PointT>::Ptr reference_pointcloud_search_method_;
+		typename IncrementalKdTree<PointT>::Ptr reference_pointcloud_incremental_search_method_;
+		PointCloud2Reader<PointT> ambient_pointcloud_reader_;
+		KdTreeCache<PointT> ambient_pointcloud_search_methods_cache_;
+		typename KeypointDescriptorsCache<PointT>::Ptr ambient_keypoints_descriptors_cache_; // shared by the initial pose estimation, tracking and tracking recovery feature matchers
 		std::vector< typename CloudFilter<PointT>::Ptr > reference_cloud_filters_;
 		std::vector< typename CloudFilter<PointT>::Ptr > ambient_pointcloud_integration_filters_;
 		std::vector< typename CloudFilter<PointT>::Ptr > ambient_pointcloud_integration_filters_map_frame_;
@@ -391,6 +514,35 @@ class Localization : public ConfigurableObject {
 		LocalizationDiagnostics localization_diagnostics_msg_;
 		LocalizationTimes localization_times_msg_;
 		bool publish_aligned_pointcloud_only_if_there_is_subscribers_;
+
+		// pipelined processing fields (each preprocessing thread only uses the filters, normal estimator and reader of its AmbientPointCloudPreprocessor)
+		bool use_pipelined_processing_;
+		int pipelined_processing_queue_size_;
+		double pipelined_processing_max_translation_correction_;
+		double pipelined_processing_max_rotation_correction_;
+		double pipelined_processing_sensors_synchronization_time_window_;
+		std::vector< typename AmbientPointCloudPreprocessor::Ptr > ambient_pointcloud_preprocessors_;
+		std::deque< typename PreprocessedAmbientPointCloud::Ptr > preprocessed_ambient_pointclouds_;
+		boost::mutex preprocessed_ambient_pointclouds_mutex_;
+		boost::condition_variable preprocessed_ambient_pointclouds_condition_;
+		tf2::Transform pipelined_processing_odom_to_map_;
+
+		// multi hypothesis tracking recovery fields (each thread registers its hypotheses with its own copy of the tracking recovery matchers)
+		bool multi_hypothesis_tracking_recovery_enabled_;
+		int multi_hypothesis_tracking_recovery_number_of_hypotheses_;
+		double multi_hypothesis_tracking_recovery_linear_uncertainty_;
+		double multi_hypothesis_tracking_recovery_linear_uncertainty_per_meter_travelled_;
+		double multi_hypothesis_tracking_recovery_angular_uncertainty_;
+		double multi_hypothesis_tracking_recovery_angular_uncertainty_per_radian_rotated_;
+		double multi_hypothesis_tracking_recovery_inliers_max_distance_;
+		int multi_hypothesis_tracking_recovery_max_number_of_validated_hypotheses_;
+		std::vector< std::vector< typename CloudMatcher<PointT>::Ptr > > multi_hypothesis_tracking_recovery_matchers_;
+
+		// tracing fields (the spans are stored in the Tracer singleton)
+		std::string tracing_chrome_trace_filename_;
+		double tracing_latency_statistics_report_period_;
+		double tracing_latency_statistics_window_;
+		ros::WallTime tracing_last_report_time_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
@@ -0,0 +1,158 @@
+/**\file integral_image_normal_estimation.hpp
+ * \brief Normal estimation for organized point clouds (depth cameras / ToF) using integral images.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/normal_estimators/integral_image_normal_estimation.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IntegralImageNormalEstimation-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void IntegralImageNormalEstimation<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace) {
+	std::string normal_estimation_method;
+	private_node_handle->param(configuration_namespace + "normal_estimation_method", normal_estimation_method, std::string("COVARIANCE_MATRIX"));
+	if (normal_estimation_method == "AVERAGE_3D_GRADIENT") {
+		normal_estimator_.setNormalEstimationMethod(pcl::IntegralImageNormalEstimation<PointT, PointT>::AVERAGE_3D_GRADIENT);
+	} else if (normal_estimation_method == "AVERAGE_DEPTH_CHANGE") {
+		normal_estimator_.setNormalEstimationMethod(pcl::IntegralImageNormalEstimation<PointT, PointT>::AVERAGE_DEPTH_CHANGE);
+	} else if (normal_estimation_method == "SIMPLE_3D_GRADIENT") {
+		normal_estimator_.setNormalEstimationMethod(pcl::IntegralImageNormalEstimation<PointT, PointT>::SIMPLE_3D_GRADIENT);
+	} else {
+		normal_estimator_.setNormalEstimationMethod(pcl::IntegralImageNormalEstimation<PointT, PointT>::COVARIANCE_MATRIX);
+	}
+
+	double max_depth_change_factor;
+	private_node_handle->param(configuration_namespace + "max_depth_change_factor", max_depth_change_factor, 0.02);
+	normal_estimator_.setMaxDepthChangeFactor((float)max_depth_change_factor);
+
+	double normal_smoothing_size;
+	private_node_handle->param(configuration_namespace + "normal_smoothing_size", normal_smoothing_size, 10.0);
+	normal_estimator_.setNormalSmoothingSize((float)normal_smoothing_size);
+
+	bool use_depth_dependent_smoothing;
+	private_node_handle->param(configuration_namespace + "use_depth_dependent_smoothing", use_depth_dependent_smoothing, false);
+	normal_estimator_.setDepthDependentSmoothing(use_depth_dependent_smoothing);
+
+	std::string border_policy;
+	private_node_handle->param(configuration_namespace + "border_policy", border_policy, std::string("BORDER_POLICY_IGNORE"));
+	if (border_policy == "BORDER_POLICY_MIRROR") {
+		normal_estimator_.setBorderPolicy(pcl::IntegralImageNormalEstimation<PointT, PointT>::BORDER_POLICY_MIRROR);
+	} else {
+		normal_estimator_.setBorderPolicy(pcl::IntegralImageNormalEstimation<PointT, PointT>::BORDER_POLICY_IGNORE);
+	}
+
+	int search_k;
+	private_node_handle->param(configuration_namespace + "search_k", search_k, 0);
+	unorganized_normal_estimator_.setKSearch(search_k);
+
+	if (search_k <= 0) {
+		double search_radius;
+		private_node_handle->param(configuration_namespace + "search_radius", search_radius, 0.12);
+		unorganized_normal_estimator_.setRadiusSearch(search_radius);
+	}
+
+	NormalEstimator<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+}
+
+template<typename PointT>
+void IntegralImageNormalEstimation<PointT>::estimateNormals(typename pcl::PointCloud<PointT>::Ptr& pointcloud,
+		typename pcl::PointCloud<PointT>::Ptr& surface,
+		typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
+		tf2::Transform& viewpoint_guess,
+		typename pcl::PointCloud<PointT>::Ptr& pointcloud_with_normals_out) {
+	size_t pointcloud_original_size = pointcloud->size();
+	if (pointcloud_original_size < 3) { return; }
+
+	std::vector<int> indexes;
+	bool normals_computed_from_organized_cloud = false;
+	if (surface && surface == organized_surface_with_normals_ && surface_search_method && surface_search_method->getInputCloud() == surface) {
+		pcl::removeNaNFromPointCloud(*pointcloud, *pointcloud, indexes);
+		indexes.clear();
+		transferNormalsFromSurface(*pointcloud, *surface, surface_search_method);
+		normals_computed_from_organized_cloud = true;
+		ROS_DEBUG_STREAM("IntegralImageNormalEstimation used the normals of an organized surface with " << surface->width << "x" << surface->height << " points");
+	}
+
+	if (!normals_computed_from_organized_cloud) {
+		pcl::removeNaNFromPointCloud(*pointcloud, *pointcloud, indexes);
+		indexes.clear();
+
+		unorganized_normal_estimator_.setSearchMethod(surface_search_method);
+		if (surface) { unorganized_normal_estimator_.setSearchSurface(surface); }
+		unorganized_normal_estimator_.setInputCloud(pointcloud);
+		unorganized_normal_estimator_.setViewPoint(viewpoint_guess.getOrigin().getX(), viewpoint_guess.getOrigin().getY(), viewpoint_guess.getOrigin().getZ());
+		unorganized_normal_estimator_.compute(*pointcloud); // adds normals to existing points
+	}
+
+	pointcloud_with_normals_out = pointcloud;  // switch pointers
+
+	pcl::removeNaNFromPointCloud(*pointcloud_with_normals_out, *pointcloud_with_normals_out, indexes);
+	indexes.clear();
+	pcl::removeNaNNormalsFromPointCloud(*pointcloud_with_normals_out, *pointcloud_with_normals_out, indexes);
+	indexes.clear();
+
+	ROS_DEBUG_STREAM("IntegralImageNormalEstimation computed " << pointcloud_with_normals_out->size() << " normals from a cloud with " << pointcloud_original_size << " points" << (normals_computed_from_organized_cloud ? "" : " (unorganized cloud)"));
+
+	NormalEstimator<PointT>::estimateNormals(pointcloud, surface, surface_search_method, viewpoint_guess, pointcloud_with_normals_out);
+
+	if (pointcloud_with_normals_out->size() > 3 && pointcloud_with_normals_out->size() != pointcloud_original_size) {
+		surface_search_method->setInputCloud(pointcloud_with_normals_out);
+	}
+}
+
+template<typename PointT>
+bool IntegralImageNormalEstimation<PointT>::estimateOrganizedSurfaceNormals(typename pcl::PointCloud<PointT>::Ptr& organized_surface) {
+	organized_surface_with_normals_.reset();
+	if (!organized_surface || !organized_surface->isOrganized()) { return false; }
+
+	// the cloud is in the frame of the sensor that produced it (z is the depth), so the viewpoint is the origin
+	normal_estimator_.setInputCloud(organized_surface);
+	normal_estimator_.setViewPoint(0.0f, 0.0f, 0.0f);
+	normal_estimator_.compute(*organized_surface); // adds normals to existing points (the invalid ones are set to NaN)
+	if (!organized_surface->isOrganized()) { return false; }
+
+	organized_surface_with_normals_ = organized_surface;
+	return true;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IntegralImageNormalEstimation-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+void IntegralImageNormalEstimation<PointT>::transferNormalsFromSurface(pcl::PointCloud<PointT>& pointcloud, const pcl::PointCloud<PointT>& surface_with_normals, typename pcl::search::KdTree<PointT>::Ptr& surface_search_method) {
+	int number_of_points = (int)pointcloud.size();
+	#pragma omp parallel
+	{
+		std::vector<int> nn_indices(1);
+		std::vector<float> nn_distances(1);
+
+		#pragma omp for schedule(static)
+		for (int i = 0; i < number_of_points; ++i) {
+			PointT& point = pointcloud.points[i];
+			if (surface_search_method->nearestKSearch(point, 1, nn_indices, nn_distances) > 0) {
+				const PointT& closest_surface_point = surface_with_normals.points[nn_indices[0]];
+				point.normal_x = closest_surface_point.normal_x;
+				point.normal_y = closest_surface_point.normal_y;
+				point.normal_z = closest_surface_point.normal_z;
+				point.curvature = closest_surface_point.curvature;
+			} else {
+				point.normal_x = point.normal_y = point.normal_z = point.curvature = std::numeric_limits<float>::quiet_NaN();
+			}
+		}
+	}
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+} /* namespace dynamic_robot_localization */
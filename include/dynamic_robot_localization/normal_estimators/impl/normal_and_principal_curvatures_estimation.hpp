@@ -0,0 +1,193 @@
+/**\file normal_and_principal_curvatures_estimation.hpp
+ * \brief Normal, curvature and principal curvatures estimation with a single neighborhood search per point.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/normal_estimators/normal_and_principal_curvatures_estimation.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <NormalAndPrincipalCurvaturesEstimation-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void NormalAndPrincipalCurvaturesEstimation<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace) {
+	private_node_handle->param(configuration_namespace + "search_k", search_k_, 0);
+	private_node_handle->param(configuration_namespace + "search_radius", search_radius_, 0.12);
+	private_node_handle->param(configuration_namespace + "update_normals_with_principal_component_directions", update_normals_with_principal_component_directions_, false);
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads_, 0);
+
+	std::string curvature_type_str;
+	curvature_type_ = CURVATURE_TYPE_MEAN;
+	private_node_handle->param(configuration_namespace + "curvature_type", curvature_type_str, std::string("CURVATURE_TYPE_MEAN"));
+	if (curvature_type_str == "CURVATURE_TYPE_GAUSSIAN") {
+		curvature_type_ = CURVATURE_TYPE_GAUSSIAN;
+	}
+
+	NormalEstimator<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+}
+
+template<typename PointT>
+void NormalAndPrincipalCurvaturesEstimation<PointT>::estimateNormals(typename pcl::PointCloud<PointT>::Ptr& pointcloud,
+		typename pcl::PointCloud<PointT>::Ptr& surface,
+		typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
+		tf2::Transform& viewpoint_guess,
+		typename pcl::PointCloud<PointT>::Ptr& pointcloud_with_normals_out) {
+	size_t pointcloud_original_size = pointcloud->size();
+	if (pointcloud_original_size < 3) { return; }
+
+	std::vector<int> indexes;
+	pcl::removeNaNFromPointCloud(*pointcloud, *pointcloud, indexes);
+	indexes.clear();
+
+	typename pcl::PointCloud<PointT>::ConstPtr search_surface = surface_search_method->getInputCloud();
+	bool reuse_neighborhoods = (search_surface.get() == pointcloud.get());
+	typename pcl::search::KdTree<PointT>::Ptr pointcloud_search_method = surface_search_method;
+	if (!reuse_neighborhoods) {
+		pointcloud_search_method.reset(new pcl::search::KdTree<PointT>());
+		pointcloud_search_method->setInputCloud(pointcloud);
+	}
+
+	float vp_x = viewpoint_guess.getOrigin().x();
+	float vp_y = viewpoint_guess.getOrigin().y();
+	float vp_z = viewpoint_guess.getOrigin().z();
+	int number_of_points = (int)pointcloud->size();
+	int number_of_threads = (number_of_threads_ > 0) ? number_of_threads_ : omp_get_max_threads();
+	neighborhoods_.resize(pointcloud->size());
+	principal_curvatures_.assign(pointcloud->size(), std::numeric_limits<float>::quiet_NaN());
+	if (update_normals_with_principal_component_directions_) { principal_directions_.resize(pointcloud->size()); }
+
+	// normals and curvature from the covariance of each neighborhood
+	#pragma omp parallel num_threads(number_of_threads)
+	{
+		std::vector<int> neighbors_indices;
+		std::vector<float> neighbors_distances;
+		Eigen::Matrix3f covariance_matrix;
+		Eigen::Vector4f centroid;
+
+		#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < number_of_points; ++i) {
+			PointT& point = pointcloud->points[i];
+			std::vector<int>& neighborhood = reuse_neighborhoods ? neighborhoods_[i] : neighbors_indices;
+			if (searchNeighbors(*surface_search_method, point, neighborhood, neighbors_distances) < 3 || pcl::computeMeanAndCovarianceMatrix(*search_surface, neighborhood, covariance_matrix, centroid) == 0) {
+				point.normal_x = point.normal_y = point.normal_z = point.curvature = std::numeric_limits<float>::quiet_NaN();
+				continue;
+			}
+
+			pcl::solvePlaneParameters(covariance_matrix, point.normal_x, point.normal_y, point.normal_z, point.curvature);
+			pcl::flipNormalTowardsViewpoint(point, vp_x, vp_y, vp_z, point.normal_x, point.normal_y, point.normal_z);
+		}
+	}
+
+	// principal curvatures from the normals of the same neighborhoods (stored in buffers and only applied after all the points were processed, because the neighbors normals are read by other threads)
+	#pragma omp parallel num_threads(number_of_threads)
+	{
+		std::vector<int> neighbors_indices;
+		std::vector<float> neighbors_distances;
+		Eigen::Vector3f principal_direction;
+		float pc1, pc2;
+
+		#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < number_of_points; ++i) {
+			PointT& point = pointcloud->points[i];
+			if (!pcl_isfinite(point.normal_x) || !pcl_isfinite(point.normal_y) || !pcl_isfinite(point.normal_z)) { continue; }
+
+			if (!reuse_neighborhoods) {
+				searchNeighbors(*pointcloud_search_method, point, neighbors_indices, neighbors_distances);
+			}
+			const std::vector<int>& neighborhood = reuse_neighborhoods ? neighborhoods_[i] : neighbors_indices;
+
+			if (computePointPrincipalCurvatures(*pointcloud, point, neighborhood, principal_direction, pc1, pc2)) {
+				if (curvature_type_ == CURVATURE_TYPE_GAUSSIAN) {
+					principal_curvatures_[i] = pc1 * pc2;
+				} else {
+					principal_curvatures_[i] = (pc1 + pc2) * 0.5;
+				}
+
+				if (update_normals_with_principal_component_directions_) {
+					principal_directions_[i] = principal_direction;
+				}
+			}
+		}
+	}
+
+	#pragma omp parallel for num_threads(number_of_threads) schedule(static)
+	for (int i = 0; i < number_of_points; ++i) {
+		if (!pcl_isfinite(principal_curvatures_[i])) { continue; }
+		PointT& point = pointcloud->points[i];
+		point.curvature = principal_curvatures_[i];
+		if (update_normals_with_principal_component_directions_) {
+			point.normal_x = principal_directions_[i](0);
+			point.normal_y = principal_directions_[i](1);
+			point.normal_z = principal_directions_[i](2);
+		}
+	}
+
+	pointcloud_with_normals_out = pointcloud;  // switch pointers
+
+	pcl::removeNaNFromPointCloud(*pointcloud_with_normals_out, *pointcloud_with_normals_out, indexes);
+	indexes.clear();
+	pcl::removeNaNNormalsFromPointCloud(*pointcloud_with_normals_out, *pointcloud_with_normals_out, indexes);
+	indexes.clear();
+
+	ROS_DEBUG_STREAM("NormalAndPrincipalCurvaturesEstimation computed " << pointcloud_with_normals_out->size() << " normals and principal curvatures from a cloud with " << pointcloud_original_size << " points"
+			<< (reuse_neighborhoods ? " (reusing the neighborhoods)" : " (with a second neighborhood search because the search surface is not the cloud)"));
+
+	NormalEstimator<PointT>::estimateNormals(pointcloud, surface, surface_search_method, viewpoint_guess, pointcloud_with_normals_out);
+
+	if (pointcloud_with_normals_out->size() > 3 && pointcloud_with_normals_out->size() != pointcloud_original_size) {
+		surface_search_method->setInputCloud(pointcloud_with_normals_out);
+	}
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NormalAndPrincipalCurvaturesEstimation-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+bool NormalAndPrincipalCurvaturesEstimation<PointT>::computePointPrincipalCurvatures(const pcl::PointCloud<PointT>& pointcloud, const PointT& point, const std::vector<int>& neighbors_indices,
+		Eigen::Vector3f& principal_direction_out, float& pc1_out, float& pc2_out) {
+	Eigen::Vector3f normal = point.getNormalVector3fMap();
+	Eigen::Matrix3f tangent_plane_projection = Eigen::Matrix3f::Identity() - normal * normal.transpose();
+
+	// the projected normals are accumulated twice (centroid and covariance) to avoid storing them
+	Eigen::Vector3f projected_normals_centroid = Eigen::Vector3f::Zero();
+	size_t number_of_valid_neighbors = 0;
+	for (size_t i = 0; i < neighbors_indices.size(); ++i) {
+		const PointT& neighbor = pointcloud.points[neighbors_indices[i]];
+		if (!pcl_isfinite(neighbor.normal_x) || !pcl_isfinite(neighbor.normal_y) || !pcl_isfinite(neighbor.normal_z)) { continue; }
+		projected_normals_centroid += tangent_plane_projection * neighbor.getNormalVector3fMap();
+		++number_of_valid_neighbors;
+	}
+
+	if (number_of_valid_neighbors == 0) { return false; }
+	projected_normals_centroid /= (float)number_of_valid_neighbors;
+
+	Eigen::Matrix3f covariance_matrix = Eigen::Matrix3f::Zero();
+	for (size_t i = 0; i < neighbors_indices.size(); ++i) {
+		const PointT& neighbor = pointcloud.points[neighbors_indices[i]];
+		if (!pcl_isfinite(neighbor.normal_x) || !pcl_isfinite(neighbor.normal_y) || !pcl_isfinite(neighbor.normal_z)) { continue; }
+		Eigen::Vector3f demean = tangent_plane_projection * neighbor.getNormalVector3fMap() - projected_normals_centroid;
+		covariance_matrix.noalias() += demean * demean.transpose();
+	}
+
+	Eigen::Vector3f eigenvalues;
+	pcl::eigen33(covariance_matrix, eigenvalues);
+	pcl::computeCorrespondingEigenVector(covariance_matrix, eigenvalues[2], principal_direction_out);
+
+	float normalization = 1.0f / (float)number_of_valid_neighbors;
+	pc1_out = eigenvalues[2] * normalization;
+	pc2_out = eigenvalues[1] * normalization;
+	return true;
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+} /* namespace dynamic_robot_localization */
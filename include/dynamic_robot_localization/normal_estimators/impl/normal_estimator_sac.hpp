@@ -74,6 +74,8 @@ void NormalEstimatorSAC<PointT>::setupConfigurationFromParameterServer(ros::Node
 	private_node_handle->param(configuration_namespace + "random_samples_max_k", random_samples_max_k_, 5);
 	private_node_handle->param(configuration_namespace + "random_samples_max_radius", random_samples_max_radius_, 0.05);
 	private_node_handle->param(configuration_namespace + "minimum_inliers_percentage", minimum_inliers_percentage_, 0.5);
+	private_node_handle->param(configuration_namespace + "use_fixed_random_seed", use_fixed_random_seed_, false);
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads_, 0);
 
 	NormalEstimator<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
 }
@@ -90,8 +92,6 @@ void NormalEstimatorSAC<PointT>::estimateNormals(typename pcl::PointCloud<PointT
 	if (pointcloud_original_size < 3) { return; }
 
 	pointcloud_with_normals_out = pointcloud;
-	sac_segmentation_.setSamplesMaxDist(random_samples_max_radius_, surface_search_method);
-	sac_segmentation_.setInputCloud(surface_search_method->getInputCloud());
 
 	float vp_x = viewpoint_guess.getOrigin().x();
 	float vp_y = viewpoint_guess.getOrigin().y();
@@ -108,56 +108,71 @@ void NormalEstimatorSAC<PointT>::estimateNormals(typename pcl::PointCloud<PointT
 			point_2_3.z - vp_z);
 	tf2::Vector3 normal_to_viewpoint = normal_1_3.cross(normal_2_3);
 
-	for (size_t i = 0; i < pointcloud_with_normals_out->size(); ++i) {
-		PointT& current_point = (*pointcloud_with_normals_out)[i];
+	int number_of_threads = (number_of_threads_ > 0) ? number_of_threads_ : omp_get_max_threads();
+	number_of_threads = std::max(1, std::min(number_of_threads, (int)(pointcloud_original_size / MINIMUM_NUMBER_OF_POINTS_PER_THREAD)));
+	int number_of_points = (int)pointcloud_with_normals_out->size();
+
+	#pragma omp parallel num_threads(number_of_threads)
+	{
+		pcl::SACSegmentation<PointT> sac_segmentation(!use_fixed_random_seed_);
+		setupSACSegmentation(sac_segmentation, surface_search_method);
 		pcl::IndicesPtr nn_indices(new std::vector<int>());
 		std::vector<float> nn_distances;
-		if (random_samples_max_k_ > 0) {
-			surface_search_method->nearestKSearch(current_point, random_samples_max_k_, *nn_indices, nn_distances);
-		} else {
-			surface_search_method->radiusSearch(current_point, random_samples_max_radius_, *nn_indices, nn_distances);
-		}
+		pcl::ModelCoefficients coefficients;
+		pcl::PointIndices inliers;
+
+		#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < number_of_points; ++i) {
+			PointT& current_point = (*pointcloud_with_normals_out)[i];
+			nn_indices->clear();
+			nn_distances.clear();
+			if (random_samples_max_k_ > 0) {
+				surface_search_method->nearestKSearch(current_point, random_samples_max_k_, *nn_indices, nn_distances);
+			} else {
+				surface_search_method->radiusSearch(current_point, random_samples_max_radius_, *nn_indices, nn_distances);
+			}
 
-		bool orient_normal_towards_viewpoint = true;
-		if (nn_distances.size() > 2 && nn_indices->size() > 2) {
-			sac_segmentation_.setIndices(nn_indices);
-			pcl::ModelCoefficients coefficients;
-			pcl::PointIndices inliers;
-			sac_segmentation_.segment(inliers, coefficients);
-			if (!coefficients.values.empty() && inliers.indices.size() > 2 && ((double)nn_indices->size() / (double)inliers.indices.size()) > minimum_inliers_percentage_) {
-				if (sac_segmentation_.getModelType() == pcl::SACMODEL_LINE) {
-					if (coefficients.values.size() == 6) {
-						tf2::Vector3 line_vector(coefficients.values[3], coefficients.values[4], coefficients.values[5]);
-						tf2::Vector3 line_normal = line_vector.cross(normal_to_viewpoint);
-						line_normal.normalize();
-						current_point.normal_x = line_normal.x();
-						current_point.normal_y = line_normal.y();
-						current_point.normal_z = line_normal.z();
-						pcl::flipNormalTowardsViewpoint(current_point, vp_x, vp_y, vp_z, current_point.normal_x, current_point.normal_y, current_point.normal_z);
-						orient_normal_towards_viewpoint = false;
-					}
-				} else if(sac_segmentation_.getModelType() == pcl::SACMODEL_PLANE) {
-					if (coefficients.values.size() == 4) {
-						current_point.normal_x = coefficients.values[0];
-						current_point.normal_y = coefficients.values[1];
-						current_point.normal_z = coefficients.values[2];
-						pcl::flipNormalTowardsViewpoint(current_point, vp_x, vp_y, vp_z, current_point.normal_x, current_point.normal_y, current_point.normal_z);
-						orient_normal_towards_viewpoint = false;
+			bool orient_normal_towards_viewpoint = true;
+			if (nn_distances.size() > 2 && nn_indices->size() > 2) {
+				sac_segmentation.setIndices(nn_indices);
+				coefficients.values.clear();
+				inliers.indices.clear();
+				sac_segmentation.segment(inliers, coefficients);
+				if (!coefficients.values.empty() && inliers.indices.size() > 2 && ((double)nn_indices->size() / (double)inliers.indices.size()) > minimum_inliers_percentage_) {
+					if (sac_segmentation.getModelType() == pcl::SACMODEL_LINE) {
+						if (coefficients.values.size() == 6) {
+							tf2::Vector3 line_vector(coefficients.values[3], coefficients.values[4], coefficients.values[5]);
+							tf2::Vector3 line_normal = line_vector.cross(normal_to_viewpoint);
+							line_normal.normalize();
+							current_point.normal_x = line_normal.x();
+							current_point.normal_y = line_normal.y();
+							current_point.normal_z = line_normal.z();
+							pcl::flipNormalTowardsViewpoint(current_point, vp_x, vp_y, vp_z, current_point.normal_x, current_point.normal_y, current_point.normal_z);
+							orient_normal_towards_viewpoint = false;
+						}
+					} else if(sac_segmentation.getModelType() == pcl::SACMODEL_PLANE) {
+						if (coefficients.values.size() == 4) {
+							current_point.normal_x = coefficients.values[0];
+							current_point.normal_y = coefficients.values[1];
+							current_point.normal_z = coefficients.values[2];
+							pcl::flipNormalTowardsViewpoint(current_point, vp_x, vp_y, vp_z, current_point.normal_x, current_point.normal_y, current_point.normal_z);
+							orient_normal_towards_viewpoint = false;
+						}
 					}
 				}
 			}
-		}
 
-		if (orient_normal_towards_viewpoint) {
-			tf2::Vector3 normal(
-					vp_x - current_point.x,
-					vp_y - current_point.y,
-					vp_z - current_point.z);
-			normal.normalize();
-			current_point.normal_x = normal[0];
-			current_point.normal_y = normal[1];
-			current_point.normal_z = normal[2];
-			current_point.curvature = 0.0;
+			if (orient_normal_towards_viewpoint) {
+				tf2::Vector3 normal(
+						vp_x - current_point.x,
+						vp_y - current_point.y,
+						vp_z - current_point.z);
+				normal.normalize();
+				current_point.normal_x = normal[0];
+				current_point.normal_y = normal[1];
+				current_point.normal_z = normal[2];
+				current_point.curvature = 0.0;
+			}
 		}
 	}
 
@@ -186,7 +201,7 @@ void NormalEstimatorSAC<PointT>::estimateNormals(typename pcl::PointCloud<PointT
 		surface_search_method->setInputCloud(pointcloud_with_normals_out);
 	}
 
-	ROS_DEBUG_STREAM("NormalEstimatorSAC computed " << pointcloud_with_normals_out->size() << " normals from a cloud with " << pointcloud_original_size << " points");
+	ROS_DEBUG_STREAM("NormalEstimatorSAC computed " << pointcloud_with_normals_out->size() << " normals from a cloud with " << pointcloud_original_size << " points using " << number_of_threads << " threads");
 
 	NormalEstimator<PointT>::estimateNormals(pointcloud, surface, surface_search_method, viewpoint_guess, pointcloud_with_normals_out);
 }
@@ -194,6 +209,20 @@ void NormalEstimatorSAC<PointT>::estimateNormals(typename pcl::PointCloud<PointT
 // =============================================================================  </public-section>  ===========================================================================
 
 // =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+void NormalEstimatorSAC<PointT>::setupSACSegmentation(pcl::SACSegmentation<PointT>& sac_segmentation, typename pcl::search::KdTree<PointT>::Ptr& surface_search_method) {
+	sac_segmentation.setModelType(sac_segmentation_.getModelType());
+	sac_segmentation.setMethodType(sac_segmentation_.getMethodType());
+	sac_segmentation.setDistanceThreshold(sac_segmentation_.getDistanceThreshold());
+	sac_segmentation.setMaxIterations(sac_segmentation_.getMaxIterations());
+	sac_segmentation.setProbability(sac_segmentation_.getProbability());
+	sac_segmentation.setOptimizeCoefficients(sac_segmentation_.getOptimizeCoefficients());
+	double min_model_radius, max_model_radius;
+	sac_segmentation_.getRadiusLimits(min_model_radius, max_model_radius);
+	sac_segmentation.setRadiusLimits(min_model_radius, max_model_radius);
+	sac_segmentation.setSamplesMaxDist(random_samples_max_radius_, surface_search_method);
+	sac_segmentation.setInputCloud(surface_search_method->getInputCloud());
+}
 // =============================================================================   </protected-section>  =======================================================================
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
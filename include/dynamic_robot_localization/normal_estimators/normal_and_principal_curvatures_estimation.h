@@ -0,0 +1,130 @@
+#pragma once
+
+/**\file normal_and_principal_curvatures_estimation.h
+ * \brief Normal, curvature and principal curvatures estimation with a single neighborhood search per point.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <macros>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </macros>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <omp.h>
+
+// ROS includes
+#include <ros/ros.h>
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/filters/filter.h>
+#include <pcl/common/centroid.h>
+#include <pcl/common/eigen.h>
+#include <pcl/features/normal_3d.h>
+
+// external libs includes
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <Eigen/Core>
+
+// project includes
+#include <dynamic_robot_localization/normal_estimators/normal_estimator.h>
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// ##################################################################   NormalAndPrincipalCurvaturesEstimation   ##################################################################
+/**
+ * \brief Replaces NormalEstimationOMP followed by PrincipalCurvaturesEstimation with a single kNN / radius search per point.
+ * The first pass computes the normal and curvature from the covariance of each neighborhood (as pcl::NormalEstimation) and keeps the neighbors indices.
+ * The second pass computes the principal curvatures from the normals of the stored neighbors (as pcl::PrincipalCurvaturesEstimation).
+ * The neighborhoods can only be reused when the search surface is the point cloud itself (otherwise the second pass searches the neighbors in the point cloud).
+ */
+template <typename PointT>
+class NormalAndPrincipalCurvaturesEstimation : public NormalEstimator<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <typedefs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		typedef boost::shared_ptr< NormalAndPrincipalCurvaturesEstimation<PointT> > Ptr;
+		typedef boost::shared_ptr< const NormalAndPrincipalCurvaturesEstimation<PointT> > ConstPtr;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </typedefs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <enums>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		enum CurvatureType {
+			CURVATURE_TYPE_MEAN,
+			CURVATURE_TYPE_GAUSSIAN
+		};
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </enums>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		NormalAndPrincipalCurvaturesEstimation() :
+			search_k_(0),
+			search_radius_(0.12),
+			curvature_type_(CURVATURE_TYPE_MEAN),
+			update_normals_with_principal_component_directions_(false),
+			number_of_threads_(0) {}
+		virtual ~NormalAndPrincipalCurvaturesEstimation() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <NormalAndPrincipalCurvaturesEstimation-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace = "");
+		virtual void estimateNormals(typename pcl::PointCloud<PointT>::Ptr& pointcloud,
+				typename pcl::PointCloud<PointT>::Ptr& surface,
+				typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
+				tf2::Transform& viewpoint_guess,
+				typename pcl::PointCloud<PointT>::Ptr& pointcloud_with_normals_out);
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NormalAndPrincipalCurvaturesEstimation-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		int getSearchK() const { return search_k_; }
+		double getSearchRadius() const { return search_radius_; }
+		CurvatureType getCurvatureType() const { return curvature_type_; }
+		bool getUpdateNormalsWithPrincipalComponentDirections() const { return update_normals_with_principal_component_directions_; }
+		int getNumberOfThreads() const { return number_of_threads_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		void setSearchK(int search_k) { search_k_ = search_k; }
+		void setSearchRadius(double search_radius) { search_radius_ = search_radius; }
+		void setCurvatureType(CurvatureType curvature_type) { curvature_type_ = curvature_type; }
+		void setUpdateNormalsWithPrincipalComponentDirections(bool update_normals_with_principal_component_directions) { update_normals_with_principal_component_directions_ = update_normals_with_principal_component_directions; }
+		void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		inline int searchNeighbors(pcl::search::KdTree<PointT>& search_method, const PointT& point, std::vector<int>& neighbors_indices, std::vector<float>& neighbors_distances) {
+			if (search_k_ > 0) {
+				return search_method.nearestKSearch(point, search_k_, neighbors_indices, neighbors_distances);
+			} else {
+				return search_method.radiusSearch(point, search_radius_, neighbors_indices, neighbors_distances);
+			}
+		}
+
+		/** \brief Same computations as pcl::PrincipalCurvaturesEstimation::computePointPrincipalCurvatures, ignoring the neighbors without a valid normal. */
+		bool computePointPrincipalCurvatures(const pcl::PointCloud<PointT>& pointcloud, const PointT& point, const std::vector<int>& neighbors_indices,
+				Eigen::Vector3f& principal_direction_out, float& pc1_out, float& pc2_out);
+
+		int search_k_;
+		double search_radius_;
+		CurvatureType curvature_type_;
+		bool update_normals_with_principal_component_directions_;
+		int number_of_threads_;
+		std::vector< std::vector<int> > neighborhoods_;
+		std::vector<float> principal_curvatures_;
+		std::vector<Eigen::Vector3f> principal_directions_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/normal_estimators/impl/normal_and_principal_curvatures_estimation.hpp>
+#endif
@@ -69,6 +69,12 @@ class NormalEstimator : public ConfigurableObject {
 				typename pcl::PointCloud<PointT>::Ptr& pointcloud_with_normals_out);
 
 		void displayNormals(typename pcl::PointCloud<PointT>::Ptr& pointcloud_with_normals);
+
+		/** \brief Estimators that can take advantage of the image layout of organized sensor clouds return true, to receive the raw surface with NaNs instead of compacted. */
+		virtual bool usesOrganizedSurface() const { return false; }
+
+		/** \brief Estimates the normals of the organized surface while it is still in the frame of the sensor that produced it. Returns false if the surface must be processed by estimateNormals after being moved to the map frame. */
+		virtual bool estimateOrganizedSurfaceNormals(typename pcl::PointCloud<PointT>::Ptr& organized_surface) { return false; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NormalEstimator-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -15,6 +15,8 @@
 #include <string>
 #include <vector>
 #include <limits>
+#include <algorithm>
+#include <omp.h>
 
 // ROS includes
 #include <ros/ros.h>
@@ -39,7 +41,10 @@
 namespace dynamic_robot_localization {
 // ###########################################################################   NormalEstimatorSAC   ##########################################################################
 /**
- * \brief Description...
+ * \brief Estimates the normal of each point by fitting a line or plane model to its neighborhood using Sample Consensus.
+ * The points are processed in parallel with OpenMP, with a SACSegmentation object and neighborhood buffers per thread.
+ * Given that PCL creates a new sample consensus model (and its random generator) for each segmentation, when use_fixed_random_seed
+ * is true each point is estimated with the same seed, and as such, the normals do not depend on the number of threads or on their scheduling.
  */
 template <typename PointT>
 class NormalEstimatorSAC : public NormalEstimator<PointT> {
@@ -54,6 +59,7 @@ class NormalEstimatorSAC : public NormalEstimator<PointT> {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </enums>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constants>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		static const size_t MINIMUM_NUMBER_OF_POINTS_PER_THREAD = 256;
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constants>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -61,7 +67,9 @@ class NormalEstimatorSAC : public NormalEstimator<PointT> {
 			sac_segmentation_(true),
 			random_samples_max_k_(5),
 			random_samples_max_radius_(0.05),
-			minimum_inliers_percentage_(0.5) {}
+			minimum_inliers_percentage_(0.5),
+			use_fixed_random_seed_(false),
+			number_of_threads_(0) {}
 
 		virtual ~NormalEstimatorSAC() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -79,18 +87,26 @@ class NormalEstimatorSAC : public NormalEstimator<PointT> {
 		double getMinimumInliersPercentage() const { return minimum_inliers_percentage_; }
 		int getRandomSamplesMaxK() const { return random_samples_max_k_; }
 		double getRandomSamplesMaxRadius() const { return random_samples_max_radius_; }
+		bool getUseFixedRandomSeed() const { return use_fixed_random_seed_; }
+		int getNumberOfThreads() const { return number_of_threads_; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		void setUseFixedRandomSeed(bool use_fixed_random_seed) { use_fixed_random_seed_ = use_fixed_random_seed; }
+		void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 	// ========================================================================   </public-section>  ===========================================================================
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
+		void setupSACSegmentation(pcl::SACSegmentation<PointT>& sac_segmentation, typename pcl::search::KdTree<PointT>::Ptr& surface_search_method);
+
 		pcl::SACSegmentation<PointT> sac_segmentation_;
 		int random_samples_max_k_;
 		double random_samples_max_radius_;
 		double minimum_inliers_percentage_;
+		bool use_fixed_random_seed_;
+		int number_of_threads_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
@@ -12,17 +12,26 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <limits>
+#include <cmath>
 
 // ROS includes
+#include <tf2/LinearMath/Transform.h>
+
 // PCL includes
 #include <pcl/point_cloud.h>
 #include <pcl/search/kdtree.h>
 
 // external libs includes
 #include <boost/smart_ptr/shared_ptr.hpp>
+#include <Eigen/Core>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // project includes
 #include <dynamic_robot_localization/outlier_detectors/outlier_detector.h>
@@ -33,7 +42,8 @@
 namespace dynamic_robot_localization {
 // #######################################################################   euclidean_outlier_detector   ######################################################################
 /**
- * \brief Description...
+ * \brief Classifies as outliers the points whose closest reference point is farther than max_inliers_distance.
+ * The points are processed in parallel blocks whose results are merged in the order of the ambient cloud (the output is the same with any number of threads).
  */
 template <typename PointT>
 class EuclideanOutlierDetector : public OutlierDetector<PointT> {
@@ -59,6 +69,13 @@ class EuclideanOutlierDetector : public OutlierDetector<PointT> {
 		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace = "");
 		virtual size_t detectOutliers(typename pcl::search::KdTree<PointT>::Ptr reference_pointcloud_search_method, const pcl::PointCloud<PointT>& ambient_pointcloud,
 				typename pcl::PointCloud<PointT>::Ptr& outliers_out, typename pcl::PointCloud<PointT>::Ptr& inliers_out, double& root_mean_square_error_out);
+
+		/** \brief Computes the angular histograms of the outliers / inliers in the same parallel pass used for detecting the outliers. */
+		virtual size_t detectOutliersWithAngularDistribution(typename pcl::search::KdTree<PointT>::Ptr reference_pointcloud_search_method, const pcl::PointCloud<PointT>& ambient_pointcloud,
+				typename pcl::PointCloud<PointT>::Ptr& outliers_out, typename pcl::PointCloud<PointT>::Ptr& inliers_out, double& root_mean_square_error_out,
+				AngularDistributionAnalyzer<PointT>& angular_distribution_analyzer, const tf2::Transform& estimated_pose,
+				bool compute_outliers_angular_distribution, bool compute_inliers_angular_distribution,
+				double& outliers_angular_distribution_out, double& inliers_angular_distribution_out);
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </EuclideanOutlierDetector-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -70,7 +87,23 @@ class EuclideanOutlierDetector : public OutlierDetector<PointT> {
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
+		/** \brief Points of one block of the ambient cloud (angular bins are only filled when computing the angular distribution) */
+		struct PointsBlock {
+			std::vector<int> indices;
+			std::vector<size_t> angular_bins;
+			std::vector<Eigen::Vector3f> angular_rotation_axes;
+		};
+
+		size_t classifyPoints(typename pcl::search::KdTree<PointT>::Ptr& reference_pointcloud_search_method, const pcl::PointCloud<PointT>& ambient_pointcloud,
+				typename pcl::PointCloud<PointT>::Ptr& outliers_out, typename pcl::PointCloud<PointT>::Ptr& inliers_out, double& root_mean_square_error_out,
+				AngularDistributionAnalyzer<PointT>* angular_distribution_analyzer, bool compute_outliers_angular_distribution, bool compute_inliers_angular_distribution,
+				double& outliers_angular_distribution_out, double& inliers_angular_distribution_out);
+
+		static void mergePointsBlocks(const std::vector<PointsBlock>& points_blocks, const pcl::PointCloud<PointT>& ambient_pointcloud, typename pcl::PointCloud<PointT>::Ptr& pointcloud_out);
+		static double computeAngularDistribution(const std::vector<PointsBlock>& points_blocks, const pcl::PointCloud<PointT>& ambient_pointcloud, AngularDistributionAnalyzer<PointT>& angular_distribution_analyzer);
+
 		double max_inliers_distance_;
+		int number_of_blocks_per_thread_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
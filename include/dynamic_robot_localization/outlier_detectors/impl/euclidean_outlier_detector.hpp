@@ -17,40 +17,119 @@ namespace dynamic_robot_localization {
 // =============================================================================  <public-section>  ============================================================================
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 template<typename PointT>
-EuclideanOutlierDetector<PointT>::EuclideanOutlierDetector() : max_inliers_distance_(0.01) {}
+EuclideanOutlierDetector<PointT>::EuclideanOutlierDetector() : max_inliers_distance_(0.01), number_of_blocks_per_thread_(4) {}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <EuclideanOutlierDetector-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 template<typename PointT>
 void EuclideanOutlierDetector<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace) {
 	private_node_handle->param(configuration_namespace + "max_inliers_distance", max_inliers_distance_, 0.01);
+	private_node_handle->param(configuration_namespace + "number_of_blocks_per_thread", number_of_blocks_per_thread_, 4);
 	OutlierDetector<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
 }
 
 template<typename PointT>
 size_t EuclideanOutlierDetector<PointT>::detectOutliers(typename pcl::search::KdTree<PointT>::Ptr reference_pointcloud_search_method, const pcl::PointCloud<PointT>& ambient_pointcloud,
 		typename pcl::PointCloud<PointT>::Ptr& outliers_out, typename pcl::PointCloud<PointT>::Ptr& inliers_out, double& root_mean_square_error_out) {
-	std::vector<int> k_indices(1);
-	std::vector<float> k_sqr_distances(1);
+	double outliers_angular_distribution, inliers_angular_distribution;
+	return classifyPoints(reference_pointcloud_search_method, ambient_pointcloud, outliers_out, inliers_out, root_mean_square_error_out,
+			NULL, false, false, outliers_angular_distribution, inliers_angular_distribution);
+}
+
+
+template<typename PointT>
+size_t EuclideanOutlierDetector<PointT>::detectOutliersWithAngularDistribution(typename pcl::search::KdTree<PointT>::Ptr reference_pointcloud_search_method, const pcl::PointCloud<PointT>& ambient_pointcloud,
+		typename pcl::PointCloud<PointT>::Ptr& outliers_out, typename pcl::PointCloud<PointT>::Ptr& inliers_out, double& root_mean_square_error_out,
+		AngularDistributionAnalyzer<PointT>& angular_distribution_analyzer, const tf2::Transform& estimated_pose,
+		bool compute_outliers_angular_distribution, bool compute_inliers_angular_distribution,
+		double& outliers_angular_distribution_out, double& inliers_angular_distribution_out) {
+	angular_distribution_analyzer.setupAngularBinning(estimated_pose);
+	return classifyPoints(reference_pointcloud_search_method, ambient_pointcloud, outliers_out, inliers_out, root_mean_square_error_out,
+			&angular_distribution_analyzer, compute_outliers_angular_distribution, compute_inliers_angular_distribution, outliers_angular_distribution_out, inliers_angular_distribution_out);
+}
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </EuclideanOutlierDetector-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+size_t EuclideanOutlierDetector<PointT>::classifyPoints(typename pcl::search::KdTree<PointT>::Ptr& reference_pointcloud_search_method, const pcl::PointCloud<PointT>& ambient_pointcloud,
+		typename pcl::PointCloud<PointT>::Ptr& outliers_out, typename pcl::PointCloud<PointT>::Ptr& inliers_out, double& root_mean_square_error_out,
+		AngularDistributionAnalyzer<PointT>* angular_distribution_analyzer, bool compute_outliers_angular_distribution, bool compute_inliers_angular_distribution,
+		double& outliers_angular_distribution_out, double& inliers_angular_distribution_out) {
 	float max_inliers_distance_squared = max_inliers_distance_ * max_inliers_distance_;
+	size_t number_of_angular_bins = angular_distribution_analyzer ? (size_t)std::max(angular_distribution_analyzer->getNumberOfAngularBins(), 0) : 0;
+	bool compute_outliers_angular_bins = compute_outliers_angular_distribution && number_of_angular_bins > 0;
+	bool compute_inliers_angular_bins = compute_inliers_angular_distribution && number_of_angular_bins > 0;
+	bool save_outliers = outliers_out.get() != NULL || compute_outliers_angular_bins;
+	bool save_inliers = inliers_out.get() != NULL || compute_inliers_angular_bins;
 
-	root_mean_square_error_out = 0.0;
-	size_t number_inliers = 0;
-	bool save_outliers = outliers_out.get() != NULL;
-	bool save_inliers = inliers_out.get() != NULL;
-
-	for (size_t i = 0; i < ambient_pointcloud.size(); ++i) {
-		PointT point = ambient_pointcloud.points[i];
-		reference_pointcloud_search_method->nearestKSearch(point, 1, k_indices, k_sqr_distances);
-		if (k_sqr_distances[0] > max_inliers_distance_squared) {
-			if (save_outliers) { outliers_out->push_back(point); }
-		} else {
-			if (save_inliers) { inliers_out->push_back(point); }
-			root_mean_square_error_out += k_sqr_distances[0];
-			++number_inliers;
+	// fixed blocks of consecutive points (independent of the thread that processes them) allow to merge the results in the ambient cloud order
+	int number_of_threads = 1;
+#ifdef _OPENMP
+	number_of_threads = omp_get_max_threads();
+#endif
+	int number_of_blocks = std::max(1, std::min(number_of_threads * std::max(number_of_blocks_per_thread_, 1), (int)ambient_pointcloud.size()));
+	std::vector<PointsBlock> outliers_blocks(number_of_blocks);
+	std::vector<PointsBlock> inliers_blocks(number_of_blocks);
+	std::vector<double> sum_squared_errors_blocks(number_of_blocks, 0.0);
+	std::vector<size_t> number_inliers_blocks(number_of_blocks, 0);
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (int block = 0; block < number_of_blocks; ++block) {
+		size_t block_start = (ambient_pointcloud.size() * block) / number_of_blocks;
+		size_t block_end = (ambient_pointcloud.size() * (block + 1)) / number_of_blocks;
+		PointsBlock& outliers_block = outliers_blocks[block];
+		PointsBlock& inliers_block = inliers_blocks[block];
+		if (save_inliers) { inliers_block.indices.reserve(block_end - block_start); }
+
+		std::vector<int> k_indices(1);
+		std::vector<float> k_sqr_distances(1);
+		size_t angular_bin;
+		Eigen::Vector3f angular_rotation_axis;
+
+		for (size_t i = block_start; i < block_end; ++i) {
+			const PointT& point = ambient_pointcloud.points[i];
+			reference_pointcloud_search_method->nearestKSearch(point, 1, k_indices, k_sqr_distances);
+			bool is_outlier = k_sqr_distances[0] > max_inliers_distance_squared;
+			PointsBlock& points_block = is_outlier ? outliers_block : inliers_block;
+
+			if (is_outlier) {
+				if (save_outliers) { outliers_block.indices.push_back((int)i); }
+			} else {
+				if (save_inliers) { inliers_block.indices.push_back((int)i); }
+				sum_squared_errors_blocks[block] += k_sqr_distances[0];
+				++number_inliers_blocks[block];
+			}
+
+			if (is_outlier ? compute_outliers_angular_bins : compute_inliers_angular_bins) {
+				if (!angular_distribution_analyzer->computeAngularBin(point, number_of_angular_bins, angular_bin, angular_rotation_axis)) {
+					angular_bin = number_of_angular_bins; // point without direction (ignored in the histogram)
+				}
+				points_block.angular_bins.push_back(angular_bin);
+				points_block.angular_rotation_axes.push_back(angular_rotation_axis);
+			}
 		}
 	}
 
+	size_t number_inliers = 0;
+	root_mean_square_error_out = 0.0;
+	for (int block = 0; block < number_of_blocks; ++block) {
+		root_mean_square_error_out += sum_squared_errors_blocks[block];
+		number_inliers += number_inliers_blocks[block];
+	}
+
+	if (outliers_out) { mergePointsBlocks(outliers_blocks, ambient_pointcloud, outliers_out); }
+	if (inliers_out) { mergePointsBlocks(inliers_blocks, ambient_pointcloud, inliers_out); }
+
+	if (compute_outliers_angular_distribution) {
+		outliers_angular_distribution_out = compute_outliers_angular_bins ? computeAngularDistribution(outliers_blocks, ambient_pointcloud, *angular_distribution_analyzer) : -1.0;
+	}
+
+	if (compute_inliers_angular_distribution) {
+		inliers_angular_distribution_out = compute_inliers_angular_bins ? computeAngularDistribution(inliers_blocks, ambient_pointcloud, *angular_distribution_analyzer) : -1.0;
+	}
+
 	if (number_inliers == 0) {
 		root_mean_square_error_out = std::numeric_limits<double>::max();
 	} else {
@@ -60,10 +139,46 @@ size_t EuclideanOutlierDetector<PointT>::detectOutliers(typename pcl::search::Kd
 	return ambient_pointcloud.size() - number_inliers;
 }
 
-// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </EuclideanOutlierDetector-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-// =============================================================================  </public-section>  ===========================================================================
 
-// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+void EuclideanOutlierDetector<PointT>::mergePointsBlocks(const std::vector<PointsBlock>& points_blocks, const pcl::PointCloud<PointT>& ambient_pointcloud, typename pcl::PointCloud<PointT>::Ptr& pointcloud_out) {
+	size_t number_of_points = pointcloud_out->size();
+	for (size_t block = 0; block < points_blocks.size(); ++block) { number_of_points += points_blocks[block].indices.size(); }
+	pointcloud_out->reserve(number_of_points);
+
+	for (size_t block = 0; block < points_blocks.size(); ++block) {
+		const std::vector<int>& indices = points_blocks[block].indices;
+		for (size_t i = 0; i < indices.size(); ++i) {
+			pointcloud_out->push_back(ambient_pointcloud.points[indices[i]]);
+		}
+	}
+}
+
+
+template<typename PointT>
+double EuclideanOutlierDetector<PointT>::computeAngularDistribution(const std::vector<PointsBlock>& points_blocks, const pcl::PointCloud<PointT>& ambient_pointcloud, AngularDistributionAnalyzer<PointT>& angular_distribution_analyzer) {
+	// the direction of the bins is given by the first point (same as AngularDistributionAnalyzer::computeAnalysisHistogram)
+	size_t first_block = 0;
+	while (first_block < points_blocks.size() && points_blocks[first_block].indices.empty()) { ++first_block; }
+	if (first_block == points_blocks.size()) { return 0.0; }
+
+	std::vector<size_t> analysis_histogram(angular_distribution_analyzer.getNumberOfAngularBins(), 0);
+	Eigen::Vector3f reference_rotation_axis = angular_distribution_analyzer.computeReferenceRotationAxis(ambient_pointcloud.points[points_blocks[first_block].indices[0]]);
+
+	for (size_t block = first_block; block < points_blocks.size(); ++block) {
+		const PointsBlock& points_block = points_blocks[block];
+		for (size_t i = 0; i < points_block.angular_bins.size(); ++i) {
+			if (points_block.angular_bins[i] < analysis_histogram.size()) {
+				size_t bin_position = AngularDistributionAnalyzer<PointT>::applyReferenceRotationAxis(points_block.angular_bins[i], points_block.angular_rotation_axes[i], reference_rotation_axis, analysis_histogram.size());
+				if (bin_position < analysis_histogram.size()) {
+					++analysis_histogram[bin_position];
+				}
+			}
+		}
+	}
+
+	return angular_distribution_analyzer.computeAnalysis(analysis_histogram);
+}
 // =============================================================================   </protected-section>  =======================================================================
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
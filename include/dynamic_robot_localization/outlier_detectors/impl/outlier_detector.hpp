@@ -46,6 +46,28 @@ void OutlierDetector<PointT>::setupConfigurationFromParameterServer(ros::NodeHan
 }
 
 
+template<typename PointT>
+size_t OutlierDetector<PointT>::detectOutliersWithAngularDistribution(typename pcl::search::KdTree<PointT>::Ptr reference_pointcloud_search_method, const pcl::PointCloud<PointT>& ambient_pointcloud,
+		typename pcl::PointCloud<PointT>::Ptr& outliers_out, typename pcl::PointCloud<PointT>::Ptr& inliers_out, double& root_mean_square_error_out,
+		AngularDistributionAnalyzer<PointT>& angular_distribution_analyzer, const tf2::Transform& estimated_pose,
+		bool compute_outliers_angular_distribution, bool compute_inliers_angular_distribution,
+		double& outliers_angular_distribution_out, double& inliers_angular_distribution_out) {
+	size_t number_outliers = detectOutliers(reference_pointcloud_search_method, ambient_pointcloud, outliers_out, inliers_out, root_mean_square_error_out);
+
+	if (compute_outliers_angular_distribution && outliers_out) {
+		std::vector<size_t> analysis_histogram;
+		outliers_angular_distribution_out = angular_distribution_analyzer.analyzeCloud(estimated_pose, *outliers_out, analysis_histogram);
+	}
+
+	if (compute_inliers_angular_distribution && inliers_out) {
+		std::vector<size_t> analysis_histogram;
+		inliers_angular_distribution_out = angular_distribution_analyzer.analyzeCloud(estimated_pose, *inliers_out, analysis_histogram);
+	}
+
+	return number_outliers;
+}
+
+
 template<typename PointT>
 bool OutlierDetector<PointT>::isPublishingOutliers() {
 	if (publish_pointclouds_only_if_there_is_subscribers_) {
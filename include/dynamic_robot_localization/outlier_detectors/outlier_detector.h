@@ -17,6 +17,7 @@
 // ROS includes
 #include <ros/ros.h>
 #include <sensor_msgs/PointCloud2.h>
+#include <tf2/LinearMath/Transform.h>
 
 // PCL includes
 #include <pcl/point_cloud.h>
@@ -28,6 +29,7 @@
 
 // project includes
 #include <dynamic_robot_localization/common/configurable_object.h>
+#include <dynamic_robot_localization/cloud_analyzers/angular_distribution_analyzer.h>
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -60,6 +62,13 @@ class OutlierDetector : public ConfigurableObject {
 		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, std::string configuration_namespace = "");
 		virtual size_t detectOutliers(typename pcl::search::KdTree<PointT>::Ptr reference_pointcloud_search_method, const pcl::PointCloud<PointT>& ambient_pointcloud,
 				typename pcl::PointCloud<PointT>::Ptr& outliers_out, typename pcl::PointCloud<PointT>::Ptr& inliers_out, double& root_mean_square_error_out) = 0;
+
+		/** \brief Detects the outliers and computes the angular distribution of the outliers / inliers (the default implementation analyzes the detected clouds after the detection). */
+		virtual size_t detectOutliersWithAngularDistribution(typename pcl::search::KdTree<PointT>::Ptr reference_pointcloud_search_method, const pcl::PointCloud<PointT>& ambient_pointcloud,
+				typename pcl::PointCloud<PointT>::Ptr& outliers_out, typename pcl::PointCloud<PointT>::Ptr& inliers_out, double& root_mean_square_error_out,
+				AngularDistributionAnalyzer<PointT>& angular_distribution_analyzer, const tf2::Transform& estimated_pose,
+				bool compute_outliers_angular_distribution, bool compute_inliers_angular_distribution,
+				double& outliers_angular_distribution_out, double& inliers_angular_distribution_out);
 		bool isPublishingOutliers();
 		bool isPublishingInliers();
 		void publishOutliers(typename pcl::PointCloud<PointT>::Ptr& outliers);
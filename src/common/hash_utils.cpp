@@ -0,0 +1,56 @@
+/**\file hash_utils.cpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/hash_utils.h>
+#include <dynamic_robot_localization/common/memory_mapped_file.h>
+
+#include <cstring>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+namespace hash_utils {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <hash_utils-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+boost::uint64_t computeHash(const void* data, size_t number_of_bytes, boost::uint64_t hash) {
+	const boost::uint64_t prime = 0x100000001b3ULL;
+	const char* bytes = static_cast<const char*>(data);
+
+	size_t number_of_words = number_of_bytes / sizeof(boost::uint64_t);
+	for (size_t i = 0; i < number_of_words; ++i) { // hashing words instead of bytes is much faster for large files
+		boost::uint64_t word;
+		std::memcpy(&word, bytes + i * sizeof(boost::uint64_t), sizeof(boost::uint64_t));
+		hash = (hash ^ word) * prime;
+	}
+
+	for (size_t i = number_of_words * sizeof(boost::uint64_t); i < number_of_bytes; ++i) {
+		hash = (hash ^ (boost::uint64_t)(unsigned char)bytes[i]) * prime;
+	}
+
+	hash ^= number_of_bytes;
+	return hash * prime;
+}
+
+
+boost::uint64_t computeHash(const std::string& data, boost::uint64_t hash) {
+	return computeHash(data.data(), data.size(), hash);
+}
+
+
+bool computeFileHash(const std::string& filename, boost::uint64_t& hash_out) {
+	MemoryMappedFile file;
+	if (!file.open(filename)) { return false; }
+	hash_out = computeHash(file.getData(), file.getSize());
+	return true;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </hash_utils-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace hash_utils */
+} /* namespace dynamic_robot_localization */
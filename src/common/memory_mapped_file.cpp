@@ -0,0 +1,80 @@
+/**\file memory_mapped_file.cpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/memory_mapped_file.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <MemoryMappedFile-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+bool MemoryMappedFile::open(const std::string& filename, bool writable) {
+	close();
+
+	int file_descriptor = ::open(filename.c_str(), writable ? O_RDWR : O_RDONLY);
+	if (file_descriptor < 0) { return false; }
+
+	struct stat file_status;
+	if (fstat(file_descriptor, &file_status) != 0 || !S_ISREG(file_status.st_mode)) {
+		::close(file_descriptor);
+		return false;
+	}
+
+	if (file_status.st_size <= 0) {
+		::close(file_descriptor);
+		return false;
+	}
+
+	void* data = mmap(NULL, (size_t)file_status.st_size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, file_descriptor, 0);
+	if (data == MAP_FAILED) {
+		::close(file_descriptor);
+		return false;
+	}
+
+	madvise(data, (size_t)file_status.st_size, writable ? MADV_RANDOM : MADV_SEQUENTIAL); // read only files are caches that are copied once, while writable files are lookup tables
+	data_ = static_cast<const char*>(data);
+	size_ = (size_t)file_status.st_size;
+	writable_ = writable;
+
+	::close(file_descriptor); // the mapping remains valid after closing the file descriptor
+	return true;
+}
+
+
+bool MemoryMappedFile::flush(bool synchronous) {
+	if (data_ == NULL || !writable_) { return false; }
+	return msync(const_cast<char*>(data_), size_, synchronous ? MS_SYNC : MS_ASYNC) == 0;
+}
+
+
+void MemoryMappedFile::close() {
+	if (data_ != NULL) {
+		munmap(const_cast<char*>(data_), size_);
+	}
+	data_ = NULL;
+	size_ = 0;
+	writable_ = false;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </MemoryMappedFile-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+// =============================================================================   </protected-section>  =======================================================================
+
+} /* namespace dynamic_robot_localization */
@@ -15,7 +15,7 @@ void PerformanceTimer::start() {
 	#ifdef _WIN32
 		QueryPerformanceCounter(&startCountWin);
 	#else
-		gettimeofday(&startCount, NULL);
+		clock_gettime(CLOCK_MONOTONIC, &startCount);
 	#endif
 }
 
@@ -26,7 +26,7 @@ void PerformanceTimer::stop() {
 	#ifdef _WIN32
 		QueryPerformanceCounter(&endCountWin);
 	#else
-		gettimeofday(&endCount, NULL);
+		clock_gettime(CLOCK_MONOTONIC, &endCount);
 	#endif
 	
 	calculateElapsedTimeMicroSec();
@@ -39,8 +39,8 @@ void PerformanceTimer::reset() {
 		startCountWin.QuadPart = 0;
 		endCountWin.QuadPart = 0;
 	#else
-		startCount.tv_sec = startCount.tv_usec = 0;
-		endCount.tv_sec = endCount.tv_usec = 0;
+		startCount.tv_sec = startCount.tv_nsec = 0;
+		endCount.tv_sec = endCount.tv_nsec = 0;
 	#endif
 	
 	stopped = false;
@@ -69,7 +69,7 @@ double PerformanceTimer::getElapsedTimeInMicroSec() {
 		#ifdef _WIN32
 				QueryPerformanceCounter(&endCountWin);
 		#else
-				gettimeofday(&endCount, NULL);
+				clock_gettime(CLOCK_MONOTONIC, &endCount);
 		#endif
 		calculateElapsedTimeMicroSec();
 	}
@@ -82,7 +82,7 @@ void PerformanceTimer::calculateElapsedTimeMicroSec() {
 	#ifdef _WIN32
 		elapsedTimeMicroSec = (endCountWin.QuadPart - startCountWin.QuadPart) * 1000000.0 / frequencyWin.QuadPart;
 	#else
-		elapsedTimeMicroSec = (double)((endCount.tv_sec - startCount.tv_sec) * 1000000 + (endCount.tv_usec - startCount.tv_usec));
+		elapsedTimeMicroSec = (double)(endCount.tv_sec - startCount.tv_sec) * 1000000.0 + (double)(endCount.tv_nsec - startCount.tv_nsec) / 1000.0;
 	#endif
 }
 
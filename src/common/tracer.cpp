@@ -0,0 +1,255 @@
+/**\file tracer.cpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/tracer.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+Tracer::Tracer() :
+	enabled_(false),
+	ring_buffer_capacity_(4096),
+	current_thread_ring_buffer_(&Tracer::releaseThreadRingBuffer) {
+	span_names_.push_back("unknown");
+	span_ids_["unknown"] = 0;
+}
+
+
+Tracer& Tracer::getInstance() {
+	static Tracer tracer;
+	return tracer;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <Tracer-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+boost::uint32_t Tracer::getSpanId(const std::string& span_name) {
+	boost::mutex::scoped_lock lock(registry_mutex_);
+	std::map<std::string, boost::uint32_t>::iterator it = span_ids_.find(span_name);
+	if (it != span_ids_.end()) { return it->second; }
+
+	boost::uint32_t span_id = (boost::uint32_t)span_names_.size();
+	span_names_.push_back(span_name);
+	span_ids_[span_name] = span_id;
+	return span_id;
+}
+
+
+void Tracer::recordEvent(boost::uint32_t span_id, boost::uint64_t start_time_ns, boost::uint64_t end_time_ns) {
+	ThreadRingBuffer& ring_buffer = getThreadRingBuffer();
+	boost::mutex::scoped_lock lock(ring_buffer.mutex);
+	if (ring_buffer.events.empty()) { return; }
+
+	TraceEvent& event = ring_buffer.events[ring_buffer.next_event_index];
+	event.span_id = span_id;
+	event.start_time_ns = start_time_ns;
+	event.duration_ns = end_time_ns > start_time_ns ? end_time_ns - start_time_ns : 0;
+
+	if (++ring_buffer.next_event_index == ring_buffer.events.size()) { ring_buffer.next_event_index = 0; }
+	if (ring_buffer.number_of_events < ring_buffer.events.size()) { ++ring_buffer.number_of_events; }
+}
+
+
+void Tracer::setCurrentThreadName(const std::string& thread_name) {
+	ThreadRingBuffer& ring_buffer = getThreadRingBuffer();
+	boost::mutex::scoped_lock lock(ring_buffer.mutex);
+	ring_buffer.thread_name = thread_name;
+}
+
+
+void Tracer::clear() {
+	boost::mutex::scoped_lock lock(registry_mutex_);
+	for (size_t i = 0; i < thread_ring_buffers_.size(); ++i) {
+		boost::mutex::scoped_lock ring_buffer_lock(thread_ring_buffers_[i]->mutex);
+		thread_ring_buffers_[i]->next_event_index = 0;
+		thread_ring_buffers_[i]->number_of_events = 0;
+	}
+}
+
+
+bool Tracer::exportChromeTrace(const std::string& filename) {
+	std::vector< std::pair<size_t, TraceEvent> > events;
+	collectEvents(events);
+
+	std::vector<std::string> span_names;
+	std::vector< std::pair<size_t, std::string> > thread_names;
+	{
+		boost::mutex::scoped_lock lock(registry_mutex_);
+		span_names = span_names_;
+		for (size_t i = 0; i < thread_ring_buffers_.size(); ++i) {
+			boost::mutex::scoped_lock ring_buffer_lock(thread_ring_buffers_[i]->mutex);
+			thread_names.push_back(std::pair<size_t, std::string>(thread_ring_buffers_[i]->thread_index, thread_ring_buffers_[i]->thread_name));
+		}
+	}
+
+	// written to a temporary file and renamed, to avoid leaving a truncated trace if the node is killed while exporting
+	std::string temporary_filename = filename + ".tmp";
+	std::ofstream output_stream(temporary_filename.c_str());
+	if (!output_stream.is_open()) { return false; }
+
+	output_stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first_event = true;
+	for (size_t i = 0; i < thread_names.size(); ++i) {
+		if (thread_names[i].second.empty()) { continue; }
+		output_stream << (first_event ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread_names[i].first << ",\"args\":{\"name\":\"" << thread_names[i].second << "\"}}";
+		first_event = false;
+	}
+
+	output_stream << std::fixed << std::setprecision(3);
+	for (size_t i = 0; i < events.size(); ++i) {
+		const TraceEvent& event = events[i].second;
+		const std::string& span_name = event.span_id < span_names.size() ? span_names[event.span_id] : span_names[0];
+		output_stream << (first_event ? "" : ",") << "\n{\"name\":\"";
+		for (size_t c = 0; c < span_name.size(); ++c) {
+			if (span_name[c] == '"' || span_name[c] == '\\') { output_stream << '\\'; }
+			output_stream << span_name[c];
+		}
+		output_stream << "\",\"cat\":\"drl\",\"ph\":\"X\",\"pid\":0,\"tid\":" << events[i].first
+				<< ",\"ts\":" << (event.start_time_ns / 1000.0) << ",\"dur\":" << (event.duration_ns / 1000.0) << "}";
+		first_event = false;
+	}
+	output_stream << "\n]}\n";
+	output_stream.close();
+
+	if (output_stream.fail()) {
+		std::remove(temporary_filename.c_str());
+		return false;
+	}
+	return std::rename(temporary_filename.c_str(), filename.c_str()) == 0;
+}
+
+
+void Tracer::computeLatencyStatistics(std::vector<LatencyStatistics>& latency_statistics_out, double window_seconds) {
+	latency_statistics_out.clear();
+	boost::uint64_t now_ns = getMonotonicTimeNs();
+	boost::uint64_t window_ns = (boost::uint64_t)(window_seconds * 1e9);
+	std::vector< std::pair<size_t, TraceEvent> > events;
+	collectEvents(events, (window_seconds > 0.0 && window_ns < now_ns) ? now_ns - window_ns : 0);
+
+	std::vector<std::string> span_names;
+	{
+		boost::mutex::scoped_lock lock(registry_mutex_);
+		span_names = span_names_;
+	}
+
+	std::vector< std::vector<boost::uint64_t> > durations_per_span(span_names.size());
+	for (size_t i = 0; i < events.size(); ++i) {
+		if (events[i].second.span_id < durations_per_span.size()) {
+			durations_per_span[events[i].second.span_id].push_back(events[i].second.duration_ns);
+		}
+	}
+
+	for (size_t span_id = 0; span_id < durations_per_span.size(); ++span_id) {
+		std::vector<boost::uint64_t>& durations = durations_per_span[span_id];
+		if (durations.empty()) { continue; }
+		std::sort(durations.begin(), durations.end());
+
+		LatencyStatistics latency_statistics;
+		latency_statistics.span_name = span_names[span_id];
+		latency_statistics.number_of_samples = durations.size();
+		latency_statistics.histogram.resize(NUMBER_OF_HISTOGRAM_BINS, 0);
+
+		double sum_ns = 0.0;
+		for (size_t i = 0; i < durations.size(); ++i) {
+			sum_ns += (double)durations[i];
+			boost::uint64_t duration_us = durations[i] / 1000;
+			size_t bin = 0;
+			while (duration_us > 1 && bin < NUMBER_OF_HISTOGRAM_BINS - 1) { duration_us >>= 1; ++bin; }
+			++latency_statistics.histogram[bin];
+		}
+
+		latency_statistics.mean_ms = sum_ns / durations.size() / 1e6;
+		latency_statistics.min_ms = durations.front() / 1e6;
+		latency_statistics.percentile_50_ms = durations[(size_t)(0.50 * (durations.size() - 1))] / 1e6;
+		latency_statistics.percentile_90_ms = durations[(size_t)(0.90 * (durations.size() - 1))] / 1e6;
+		latency_statistics.percentile_99_ms = durations[(size_t)(0.99 * (durations.size() - 1))] / 1e6;
+		latency_statistics.max_ms = durations.back() / 1e6;
+		latency_statistics_out.push_back(latency_statistics);
+	}
+}
+
+
+std::string Tracer::getLatencyStatisticsReport(double window_seconds) {
+	std::vector<LatencyStatistics> latency_statistics;
+	computeLatencyStatistics(latency_statistics, window_seconds);
+
+	std::stringstream report;
+	report << std::fixed << std::setprecision(3);
+	report << "Latency statistics in milliseconds";
+	if (window_seconds > 0.0) { report << " of the last " << window_seconds << " seconds"; }
+	report << " [ span | samples | mean | min | p50 | p90 | p99 | max | histogram (upper bound in us: count) ]";
+	for (size_t i = 0; i < latency_statistics.size(); ++i) {
+		const LatencyStatistics& statistics = latency_statistics[i];
+		report << "\n" << statistics.span_name << " | " << statistics.number_of_samples << " | " << statistics.mean_ms << " | " << statistics.min_ms << " | " << statistics.percentile_50_ms
+				<< " | " << statistics.percentile_90_ms << " | " << statistics.percentile_99_ms << " | " << statistics.max_ms << " |";
+		for (size_t bin = 0; bin < statistics.histogram.size(); ++bin) {
+			if (statistics.histogram[bin] > 0) { report << " <" << (2ULL << bin) << ": " << statistics.histogram[bin]; }
+		}
+	}
+	return report.str();
+}
+
+
+void Tracer::setRingBufferCapacity(size_t ring_buffer_capacity) {
+	boost::mutex::scoped_lock lock(registry_mutex_);
+	ring_buffer_capacity_ = ring_buffer_capacity;
+	for (size_t i = 0; i < thread_ring_buffers_.size(); ++i) {
+		boost::mutex::scoped_lock ring_buffer_lock(thread_ring_buffers_[i]->mutex);
+		thread_ring_buffers_[i]->events.resize(ring_buffer_capacity);
+		thread_ring_buffers_[i]->next_event_index = 0;
+		thread_ring_buffers_[i]->number_of_events = 0;
+	}
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </Tracer-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+Tracer::ThreadRingBuffer& Tracer::getThreadRingBuffer() {
+	ThreadRingBuffer* ring_buffer = current_thread_ring_buffer_.get();
+	if (ring_buffer) { return *ring_buffer; }
+
+	boost::mutex::scoped_lock lock(registry_mutex_);
+	boost::shared_ptr<ThreadRingBuffer> new_ring_buffer(new ThreadRingBuffer());
+	new_ring_buffer->events.resize(ring_buffer_capacity_);
+	new_ring_buffer->next_event_index = 0;
+	new_ring_buffer->number_of_events = 0;
+	new_ring_buffer->thread_index = thread_ring_buffers_.size();
+	thread_ring_buffers_.push_back(new_ring_buffer);
+	current_thread_ring_buffer_.reset(new_ring_buffer.get());
+	return *new_ring_buffer;
+}
+
+
+void Tracer::collectEvents(std::vector< std::pair<size_t, TraceEvent> >& events_out, boost::uint64_t minimum_start_time_ns) {
+	events_out.clear();
+	boost::mutex::scoped_lock lock(registry_mutex_);
+	for (size_t i = 0; i < thread_ring_buffers_.size(); ++i) {
+		ThreadRingBuffer& ring_buffer = *thread_ring_buffers_[i];
+		boost::mutex::scoped_lock ring_buffer_lock(ring_buffer.mutex);
+		size_t first_event_index = (ring_buffer.next_event_index + ring_buffer.events.size() - ring_buffer.number_of_events) % std::max(ring_buffer.events.size(), (size_t)1);
+		for (size_t e = 0; e < ring_buffer.number_of_events; ++e) {
+			const TraceEvent& event = ring_buffer.events[(first_event_index + e) % ring_buffer.events.size()];
+			if (event.start_time_ns >= minimum_start_time_ns) {
+				events_out.push_back(std::pair<size_t, TraceEvent>(ring_buffer.thread_index, event));
+			}
+		}
+	}
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+} /* namespace dynamic_robot_localization */
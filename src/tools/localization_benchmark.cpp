@@ -0,0 +1,705 @@
+/**\file localization_benchmark.cpp
+ * \brief Offline replay of recorded point clouds through the localization pipeline for measuring per stage latencies and throughput.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constants>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constants>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <unistd.h>
+
+// ROS includes
+#include <ros/ros.h>
+#include <tf2/LinearMath/Transform.h>
+#include <tf2/LinearMath/Quaternion.h>
+#include <pcl_conversions/pcl_conversions.h>
+#include <XmlRpc.h>
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/io/pcd_io.h>
+#include <pcl/filters/filter.h>
+#include <pcl/common/transforms.h>
+#include <pcl/console/print.h>
+#include <pcl/console/parse.h>
+
+// external libs includes
+#include <boost/filesystem.hpp>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <yaml-cpp/yaml.h>
+
+// project includes
+#include <dynamic_robot_localization/localization/localization.h>
+#include <dynamic_robot_localization/common/performance_timer.h>
+#include <dynamic_robot_localization/common/random_generator.h>
+#include <dynamic_robot_localization/common/verbosity_levels.h>
+#include <laserscan_to_pointcloud/tf_rosmsg_eigen_conversions.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+typedef std::vector< std::pair<std::string, double dynamic_robot_localization::LocalizationTimes::*> > LocalizationStages;
+
+struct InitialPoseSettings {
+	InitialPoseSettings() : start_without_initial_pose(false), translation_noise_stddev(0.0), rotation_noise_stddev(0.0), planar_noise(false), noise_seed(0) {}
+	bool start_without_initial_pose;
+	double translation_noise_stddev;
+	double rotation_noise_stddev;
+	bool planar_noise;
+	boost::uint64_t noise_seed;
+};
+
+
+void showUsage(char* program_name) {
+	pcl::console::print_info("Usage: %s -config <yaml file> [-config <yaml file>]... -scans <directory with pcds> -poses <poses file> [-reference <reference pcd>] [-sensor_pose x,y,z,qx,qy,qz,qw] [-type PointNormal|PointXYZINormal|PointXYZRGBNormal] [-warmup <number of scans>] [-repetitions <number of replays>] [-initial_pose_noise <translation stddev>,<rotation stddev>] [-planar_noise] [-seed <noise seed>] [-no_initial_pose]\n", program_name);
+	pcl::console::print_info("   -> The localization pipeline is configured from the yaml files (loaded in order, with the later ones overriding the earlier ones), in the same way as the private namespace of the drl_localization_node\n");
+	pcl::console::print_info("   -> The yaml files are served by an in process parameter server, so no ROS master is needed\n");
+	pcl::console::print_info("   -> The poses file must have one line per scan (in the lexicographic order of the pcd file names) with the base_link pose in the map frame in the format: x y z qx qy qz qw\n");
+	pcl::console::print_info("   -> Lines starting with # are ignored\n");
+	pcl::console::print_info("   -> The scans are expected in the sensor frame, whose pose in the base_link frame is given by -sensor_pose (identity by default, meaning that the scans are already in the base_link frame)\n");
+	pcl::console::print_info("   -> The scans timestamps are taken from the pcd headers\n");
+	pcl::console::print_info("   -> The initial guess of the first scan is its ground truth pose and the initial guess of the next scans is the previous estimated pose moved by the ground truth motion between the scans (simulated odometry)\n");
+	pcl::console::print_info("   -> -initial_pose_noise adds gaussian noise (in meters and radians) to each initial guess, in x,y,yaw only with -planar_noise, and -seed makes the noise reproducible\n");
+	pcl::console::print_info("   -> -no_initial_pose starts the localization without initial pose (the first scan must be localized by the initial pose estimators)\n");
+	pcl::console::print_info("   -> The errors of the initial guesses and of the estimated poses in relation to the ground truth poses are reported after the latencies\n");
+}
+
+
+// ####################################################################   <in process parameter server>   ####################################################################
+/**
+ * Minimal implementation of the ROS master XML-RPC API for running the localization pipeline offline.
+ * Parameters are kept in memory and the topics / services registrations are accepted without connecting any nodes.
+ */
+class InProcessMaster {
+	public:
+		class MasterMethod : public XmlRpc::XmlRpcServerMethod {
+			public:
+				MasterMethod(const std::string& name, InProcessMaster* master) : XmlRpc::XmlRpcServerMethod(name, &master->server_), master_(master) {}
+				void execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) { master_->execute(_name, params, result); }
+			protected:
+				InProcessMaster* master_;
+		};
+
+		InProcessMaster() : port_(0), stop_(false) {}
+		~InProcessMaster() { stop(); }
+
+		bool start() {
+			const char* method_names[] = { "getParam", "setParam", "deleteParam", "hasParam", "searchParam", "getParamNames", "subscribeParam", "unsubscribeParam",
+					"registerPublisher", "unregisterPublisher", "registerSubscriber", "unregisterSubscriber", "registerService", "unregisterService",
+					"lookupService", "lookupNode", "getUri", "getPid", "getPublishedTopics", "getTopicTypes", "getSystemState" };
+			for (size_t i = 0; i < sizeof(method_names) / sizeof(method_names[0]); ++i) {
+				methods_.push_back(boost::shared_ptr<MasterMethod>(new MasterMethod(method_names[i], this)));
+			}
+
+			if (!server_.bindAndListen(0)) { return false; }
+			port_ = server_.get_port();
+			server_thread_ = boost::thread(&InProcessMaster::spin, this);
+			return true;
+		}
+
+		void stop() {
+			if (server_thread_.joinable()) {
+				stop_ = true;
+				server_thread_.join();
+				server_.shutdown();
+			}
+		}
+
+		std::string getURI() {
+			std::stringstream uri;
+			uri << "http://localhost:" << port_ << "/";
+			return uri.str();
+		}
+
+		void setParam(const std::string& key, XmlRpc::XmlRpcValue& value) {
+			boost::mutex::scoped_lock lock(parameters_mutex_);
+			std::vector<std::string> key_names = splitKey(key);
+			if (key_names.empty()) {
+				parameters_ = value;
+				return;
+			}
+
+			XmlRpc::XmlRpcValue* parameter = &parameters_;
+			for (size_t i = 0; i < key_names.size(); ++i) {
+				if (parameter->getType() != XmlRpc::XmlRpcValue::TypeStruct) { *parameter = createEmptyStruct(); }
+				parameter = &((*parameter)[key_names[i]]);
+			}
+			*parameter = value;
+		}
+
+	protected:
+		void spin() {
+			while (!stop_) { server_.work(0.01); }
+		}
+
+		static std::vector<std::string> splitKey(const std::string& key) {
+			std::vector<std::string> key_names;
+			std::stringstream key_stream(key);
+			std::string key_name;
+			while (std::getline(key_stream, key_name, '/')) {
+				if (!key_name.empty()) { key_names.push_back(key_name); }
+			}
+			return key_names;
+		}
+
+		static std::string joinKey(const std::vector<std::string>& key_names, size_t number_of_names) {
+			std::string key;
+			for (size_t i = 0; i < number_of_names && i < key_names.size(); ++i) { key += "/" + key_names[i]; }
+			return key.empty() ? std::string("/") : key;
+		}
+
+		static XmlRpc::XmlRpcValue createEmptyStruct() {
+			XmlRpc::XmlRpcValue empty_struct;
+			int offset = 0;
+			empty_struct.fromXml("<value><struct></struct></value>", &offset);
+			return empty_struct;
+		}
+
+		static XmlRpc::XmlRpcValue createEmptyArray() {
+			XmlRpc::XmlRpcValue empty_array;
+			empty_array.setSize(0);
+			return empty_array;
+		}
+
+		static void setResponse(XmlRpc::XmlRpcValue& result, int code, const std::string& status_message, const XmlRpc::XmlRpcValue& value) {
+			result[0] = code;
+			result[1] = status_message;
+			result[2] = value;
+		}
+
+		XmlRpc::XmlRpcValue* findParam(const std::string& key) {
+			std::vector<std::string> key_names = splitKey(key);
+			XmlRpc::XmlRpcValue* parameter = &parameters_;
+			for (size_t i = 0; i < key_names.size(); ++i) {
+				if (parameter->getType() != XmlRpc::XmlRpcValue::TypeStruct || !parameter->hasMember(key_names[i])) { return NULL; }
+				parameter = &((*parameter)[key_names[i]]);
+			}
+			return parameter;
+		}
+
+		bool deleteParam(const std::string& key) {
+			std::vector<std::string> key_names = splitKey(key);
+			if (key_names.empty()) { return false; }
+
+			XmlRpc::XmlRpcValue* parent = findParam(joinKey(key_names, key_names.size() - 1));
+			if (!parent || parent->getType() != XmlRpc::XmlRpcValue::TypeStruct || !parent->hasMember(key_names.back())) { return false; }
+
+			XmlRpc::XmlRpcValue remaining_members = createEmptyStruct();
+			for (XmlRpc::XmlRpcValue::iterator it = parent->begin(); it != parent->end(); ++it) {
+				if (it->first != key_names.back()) { remaining_members[it->first] = it->second; }
+			}
+			*parent = remaining_members;
+			return true;
+		}
+
+		void collectParamNames(XmlRpc::XmlRpcValue& parameter, const std::string& key, XmlRpc::XmlRpcValue& names) {
+			if (parameter.getType() == XmlRpc::XmlRpcValue::TypeStruct) {
+				for (XmlRpc::XmlRpcValue::iterator it = parameter.begin(); it != parameter.end(); ++it) {
+					collectParamNames(it->second, key + "/" + it->first, names);
+				}
+			} else {
+				names[names.size()] = key;
+			}
+		}
+
+		/** Same search semantics as the rosmaster parameter server (looks for the first name of the key starting in the given namespace and going up to the global namespace) */
+		bool searchParam(const std::string& search_namespace, const std::string& key, std::string& found_key) {
+			std::vector<std::string> key_names = splitKey(key);
+			if (key_names.empty()) { return false; }
+
+			if (key[0] == '/') {
+				found_key = key;
+				return findParam(key) != NULL;
+			}
+
+			std::vector<std::string> namespace_names = splitKey(search_namespace);
+			for (size_t number_of_names = namespace_names.size() + 1; number_of_names > 0; --number_of_names) {
+				std::string namespace_key = joinKey(namespace_names, number_of_names - 1);
+				if (namespace_key == "/") { namespace_key.clear(); }
+				if (findParam(namespace_key + "/" + key_names.front())) {
+					found_key = namespace_key + "/" + key;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void execute(const std::string& method_name, XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+			boost::mutex::scoped_lock lock(parameters_mutex_);
+			std::string key = (params.size() > 1 && params[1].getType() == XmlRpc::XmlRpcValue::TypeString) ? (std::string)params[1] : std::string("");
+
+			if (method_name == "getParam" || method_name == "subscribeParam") {
+				XmlRpc::XmlRpcValue* parameter = findParam(key);
+				if (parameter) { setResponse(result, 1, "", *parameter); }
+				else if (method_name == "subscribeParam") { setResponse(result, 1, "", createEmptyStruct()); }
+				else { setResponse(result, -1, "Parameter [" + key + "] is not set", 0); }
+			} else if (method_name == "setParam") {
+				lock.unlock();
+				setParam(key, params[2]);
+				setResponse(result, 1, "", 0);
+			} else if (method_name == "deleteParam") {
+				if (deleteParam(key)) { setResponse(result, 1, "", 0); }
+				else { setResponse(result, -1, "Parameter [" + key + "] is not set", 0); }
+			} else if (method_name == "hasParam") {
+				setResponse(result, 1, key, findParam(key) != NULL);
+			} else if (method_name == "searchParam") {
+				std::string found_key;
+				if (searchParam((std::string)params[0], key, found_key)) { setResponse(result, 1, "Found [" + found_key + "]", found_key); }
+				else { setResponse(result, -1, "Cannot find [" + key + "]", std::string("")); }
+			} else if (method_name == "getParamNames") {
+				XmlRpc::XmlRpcValue names = createEmptyArray();
+				collectParamNames(parameters_, "", names);
+				setResponse(result, 1, "", names);
+			} else if (method_name == "registerPublisher" || method_name == "registerSubscriber" || method_name == "getPublishedTopics" || method_name == "getTopicTypes") {
+				setResponse(result, 1, "", createEmptyArray());
+			} else if (method_name == "getSystemState") {
+				XmlRpc::XmlRpcValue system_state;
+				system_state[0] = createEmptyArray();
+				system_state[1] = createEmptyArray();
+				system_state[2] = createEmptyArray();
+				setResponse(result, 1, "", system_state);
+			} else if (method_name == "lookupService" || method_name == "lookupNode") {
+				setResponse(result, -1, "[" + key + "] is not available in the in process parameter server", std::string(""));
+			} else if (method_name == "getUri") {
+				setResponse(result, 1, "", getURI());
+			} else if (method_name == "getPid") {
+				setResponse(result, 1, "", (int)getpid());
+			} else {
+				setResponse(result, 1, "", 1);
+			}
+		}
+
+		XmlRpc::XmlRpcServer server_;
+		std::vector< boost::shared_ptr<MasterMethod> > methods_;
+		boost::thread server_thread_;
+		boost::mutex parameters_mutex_;
+		XmlRpc::XmlRpcValue parameters_;
+		int port_;
+		volatile bool stop_;
+};
+
+
+XmlRpc::XmlRpcValue convertYAMLToXmlRpc(const YAML::Node& node) {
+	XmlRpc::XmlRpcValue value;
+	if (node.IsMap()) {
+		int offset = 0;
+		value.fromXml("<value><struct></struct></value>", &offset);
+		for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+			XmlRpc::XmlRpcValue member = convertYAMLToXmlRpc(it->second);
+			if (member.valid()) { value[it->first.as<std::string>()] = member; }
+		}
+	} else if (node.IsSequence()) {
+		value.setSize((int)node.size());
+		for (size_t i = 0; i < node.size(); ++i) {
+			value[(int)i] = convertYAMLToXmlRpc(node[i]);
+		}
+	} else if (node.IsScalar()) {
+		int value_int;
+		double value_double;
+		bool value_bool;
+		if (node.Tag() == "!") { value = node.as<std::string>(); } // quoted scalars are always strings
+		else if (YAML::convert<int>::decode(node, value_int)) { value = value_int; }
+		else if (YAML::convert<double>::decode(node, value_double)) { value = value_double; }
+		else if (YAML::convert<bool>::decode(node, value_bool)) { value = value_bool; }
+		else { value = node.as<std::string>(); }
+	}
+	return value;
+}
+
+
+void loadYAMLNodeIntoParameterServer(const YAML::Node& node, const std::string& key, InProcessMaster& master) {
+	if (node.IsMap()) {
+		// the maps are merged at the leaf level (like roslaunch), allowing the later yaml files to override only some of the parameters
+		for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+			std::string member_name = it->first.as<std::string>();
+			loadYAMLNodeIntoParameterServer(it->second, (member_name[0] == '/' || key == "/") ? member_name : key + "/" + member_name, master);
+		}
+	} else {
+		XmlRpc::XmlRpcValue value = convertYAMLToXmlRpc(node);
+		if (value.valid()) { master.setParam(key, value); }
+	}
+}
+
+
+bool loadConfigurationFromYAML(const std::string& yaml_filename, const std::string& parameters_namespace, InProcessMaster& master) {
+	try {
+		YAML::Node configuration = YAML::LoadFile(yaml_filename);
+		if (!configuration.IsMap()) { return configuration.IsNull(); }
+		loadYAMLNodeIntoParameterServer(configuration, parameters_namespace, master);
+	} catch (YAML::Exception& e) {
+		pcl::console::print_error(" !> Failed to parse %s: %s\n", yaml_filename.c_str(), e.what());
+		return false;
+	}
+	return true;
+}
+// ####################################################################   </in process parameter server>   ###################################################################
+
+
+LocalizationStages getLocalizationStages() {
+	LocalizationStages stages;
+	stages.push_back(std::make_pair("filtering", &dynamic_robot_localization::LocalizationTimes::filtering_time));
+	stages.push_back(std::make_pair("surface_normal_estimation", &dynamic_robot_localization::LocalizationTimes::surface_normal_estimation_time));
+	stages.push_back(std::make_pair("keypoint_selection", &dynamic_robot_localization::LocalizationTimes::keypoint_selection_time));
+	stages.push_back(std::make_pair("initial_pose_estimation", &dynamic_robot_localization::LocalizationTimes::initial_pose_estimation_time));
+	stages.push_back(std::make_pair("pointcloud_registration", &dynamic_robot_localization::LocalizationTimes::pointcloud_registration_time));
+	stages.push_back(std::make_pair("correspondence_estimation", &dynamic_robot_localization::LocalizationTimes::correspondence_estimation_time_for_all_matchers));
+	stages.push_back(std::make_pair("transformation_estimation", &dynamic_robot_localization::LocalizationTimes::transformation_estimation_time_for_all_matchers));
+	stages.push_back(std::make_pair("transform_cloud", &dynamic_robot_localization::LocalizationTimes::transform_cloud_time_for_all_matchers));
+	stages.push_back(std::make_pair("cloud_align", &dynamic_robot_localization::LocalizationTimes::cloud_align_time_for_all_matchers));
+	stages.push_back(std::make_pair("outlier_detection", &dynamic_robot_localization::LocalizationTimes::outlier_detection_time));
+	stages.push_back(std::make_pair("angular_distribution_analysis", &dynamic_robot_localization::LocalizationTimes::registered_points_angular_distribution_analysis_time));
+	stages.push_back(std::make_pair("transformation_validators", &dynamic_robot_localization::LocalizationTimes::transformation_validators_time));
+	stages.push_back(std::make_pair("covariance_estimator", &dynamic_robot_localization::LocalizationTimes::covariance_estimator_time));
+	stages.push_back(std::make_pair("map_update", &dynamic_robot_localization::LocalizationTimes::map_update_time));
+	return stages;
+}
+
+
+bool loadScanFilenames(const std::string& scans_directory, std::vector<std::string>& scans_filenames) {
+	boost::filesystem::path scans_path(scans_directory);
+	if (!boost::filesystem::is_directory(scans_path)) { return false; }
+
+	for (boost::filesystem::directory_iterator it(scans_path); it != boost::filesystem::directory_iterator(); ++it) {
+		if (boost::filesystem::is_regular_file(it->status()) && it->path().extension() == ".pcd") {
+			scans_filenames.push_back(it->path().string());
+		}
+	}
+
+	std::sort(scans_filenames.begin(), scans_filenames.end());
+	return !scans_filenames.empty();
+}
+
+
+bool loadPoses(const std::string& poses_filename, std::vector<tf2::Transform>& poses) {
+	std::ifstream poses_file(poses_filename.c_str());
+	if (!poses_file.is_open()) { return false; }
+
+	std::string line;
+	while (std::getline(poses_file, line)) {
+		if (line.empty() || line[0] == '#') { continue; }
+
+		std::stringstream line_stream(line);
+		double x, y, z, qx, qy, qz, qw;
+		if (!(line_stream >> x >> y >> z >> qx >> qy >> qz >> qw)) {
+			pcl::console::print_error(" !> Invalid pose line: %s\n", line.c_str());
+			return false;
+		}
+
+		tf2::Quaternion orientation(qx, qy, qz, qw);
+		orientation.normalize();
+		poses.push_back(tf2::Transform(orientation, tf2::Vector3(x, y, z)));
+	}
+
+	return !poses.empty();
+}
+
+
+double computePercentile(std::vector<double> values, double percentile) {
+	if (values.empty()) { return 0.0; }
+	std::sort(values.begin(), values.end());
+	size_t index = (size_t)std::ceil(percentile * (double)values.size());
+	if (index > 0) { --index; }
+	return values[std::min(index, values.size() - 1)];
+}
+
+
+double sampleNormalDistribution(dynamic_robot_localization::RandomGenerator& random_generator, double stddev) {
+	if (stddev <= 0.0) { return 0.0; }
+	double u1 = 1.0 - random_generator.nextDouble(); // ]0, 1] to avoid log(0)
+	double u2 = random_generator.nextDouble();
+	return stddev * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+}
+
+
+tf2::Transform sampleInitialPosePerturbation(dynamic_robot_localization::RandomGenerator& random_generator, const InitialPoseSettings& initial_pose_settings) {
+	double x = sampleNormalDistribution(random_generator, initial_pose_settings.translation_noise_stddev);
+	double y = sampleNormalDistribution(random_generator, initial_pose_settings.translation_noise_stddev);
+	double z = initial_pose_settings.planar_noise ? 0.0 : sampleNormalDistribution(random_generator, initial_pose_settings.translation_noise_stddev);
+	double roll = initial_pose_settings.planar_noise ? 0.0 : sampleNormalDistribution(random_generator, initial_pose_settings.rotation_noise_stddev);
+	double pitch = initial_pose_settings.planar_noise ? 0.0 : sampleNormalDistribution(random_generator, initial_pose_settings.rotation_noise_stddev);
+	double yaw = sampleNormalDistribution(random_generator, initial_pose_settings.rotation_noise_stddev);
+	tf2::Quaternion orientation;
+	orientation.setRPY(roll, pitch, yaw);
+	return tf2::Transform(orientation, tf2::Vector3(x, y, z));
+}
+
+
+void computePoseError(const tf2::Transform& ground_truth_pose, const tf2::Transform& pose, double& translation_error_mm_out, double& rotation_error_deg_out) {
+	tf2::Transform pose_error = ground_truth_pose.inverse() * pose;
+	translation_error_mm_out = pose_error.getOrigin().length() * 1000.0;
+	double rotation_error = pose_error.getRotation().normalized().getAngle(); // [0, 2 * pi]
+	if (rotation_error > M_PI) { rotation_error = 2.0 * M_PI - rotation_error; }
+	rotation_error_deg_out = rotation_error * 180.0 / M_PI;
+}
+
+
+void printStageStatistics(const std::string& stage_name, const std::vector<double>& times_ms) {
+	double sum = 0.0;
+	for (size_t i = 0; i < times_ms.size(); ++i) { sum += times_ms[i]; }
+	double mean = times_ms.empty() ? 0.0 : sum / (double)times_ms.size();
+	pcl::console::print_info("   %-30s | mean: %10.3f | p50: %10.3f | p90: %10.3f | p99: %10.3f | max: %10.3f\n", stage_name.c_str(), mean,
+			computePercentile(times_ms, 0.50), computePercentile(times_ms, 0.90), computePercentile(times_ms, 0.99), computePercentile(times_ms, 1.0));
+}
+
+
+template<typename PointT>
+int runBenchmark(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::vector<std::string>& scans_filenames, const std::vector<tf2::Transform>& poses,
+		const tf2::Transform& sensor_pose_in_base_link, const std::string& reference_pointcloud_filename, int number_of_warmup_scans, int number_of_repetitions, const InitialPoseSettings& initial_pose_settings) {
+	dynamic_robot_localization::Localization<PointT> localization;
+	localization.setupConfigurationFromParameterServer(node_handle, private_node_handle);
+
+	std::string reference_filename = reference_pointcloud_filename.empty() ? localization.getReferencePointcloudFilename() : reference_pointcloud_filename;
+	pcl::console::print_highlight("==> Loading reference point cloud %s...\n", reference_filename.c_str());
+	dynamic_robot_localization::PerformanceTimer performance_timer;
+	performance_timer.start();
+	if (reference_filename.empty() || !localization.loadReferencePointCloudFromFile(reference_filename)) {
+		pcl::console::print_error(" !> Failed to load reference point cloud\n\n");
+		return (-1);
+	}
+	pcl::console::print_highlight(" +> Reference point cloud preprocessed in %s\n\n", performance_timer.getElapsedTimeFormated().c_str());
+
+	pcl::console::print_highlight("==> Loading %lu scans...\n", scans_filenames.size());
+	std::vector< typename pcl::PointCloud<PointT>::Ptr > scans;
+	for (size_t i = 0; i < scans_filenames.size(); ++i) {
+		typename pcl::PointCloud<PointT>::Ptr scan(new pcl::PointCloud<PointT>());
+		if (pcl::io::loadPCDFile(scans_filenames[i], *scan) != 0) {
+			pcl::console::print_error(" !> Failed to load scan %s\n\n", scans_filenames[i].c_str());
+			return (-1);
+		}
+		std::vector<int> indexes;
+		pcl::removeNaNFromPointCloud(*scan, *scan, indexes);
+		scans.push_back(scan);
+	}
+
+	LocalizationStages stages = getLocalizationStages();
+	std::vector< std::vector<double> > stages_times_ms(stages.size());
+	std::vector<double> global_times_ms;
+	std::vector<double> initial_guess_translation_errors_mm, initial_guess_rotation_errors_deg;
+	std::vector<double> estimated_pose_translation_errors_mm, estimated_pose_rotation_errors_deg;
+	size_t number_of_successful_registrations = 0;
+	size_t number_of_processed_scans = 0;
+	double total_processing_time_sec = 0.0;
+
+	dynamic_robot_localization::RandomGenerator random_generator(initial_pose_settings.noise_seed);
+	tf2::Transform previous_ground_truth_pose = tf2::Transform::getIdentity();
+	tf2::Transform previous_estimated_pose = tf2::Transform::getIdentity();
+	bool previous_pose_available = false;
+
+	pcl::console::print_highlight("==> Replaying %lu scans %d time(s) (%d warmup scan(s)) %s initial pose and with initial guess noise [translation stddev: %f m | rotation stddev: %f rad%s]...\n",
+			scans.size(), number_of_repetitions, number_of_warmup_scans, initial_pose_settings.start_without_initial_pose ? "without" : "with",
+			initial_pose_settings.translation_noise_stddev, initial_pose_settings.rotation_noise_stddev, initial_pose_settings.planar_noise ? " | planar" : "");
+	int scan_number = 0;
+	for (int repetition = 0; repetition < number_of_repetitions; ++repetition) {
+		for (size_t i = 0; i < scans.size(); ++i, ++scan_number) {
+			// the ground truth motion since the previous scan simulates the odometry, which is applied to the previous estimated pose and perturbed with the configured noise
+			tf2::Transform pose_initial_guess;
+			if (previous_pose_available) {
+				pose_initial_guess = previous_estimated_pose * (previous_ground_truth_pose.inverse() * poses[i]) * sampleInitialPosePerturbation(random_generator, initial_pose_settings);
+			} else if (initial_pose_settings.start_without_initial_pose) {
+				pose_initial_guess = tf2::Transform::getIdentity();
+			} else {
+				pose_initial_guess = poses[i] * sampleInitialPosePerturbation(random_generator, initial_pose_settings);
+			}
+
+			// scans are given to the pipeline already in the map frame (using the initial guess of the base_link pose), which avoids TF lookups
+			typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud(new pcl::PointCloud<PointT>());
+			pcl::transformPointCloudWithNormals(*scans[i], *ambient_pointcloud, laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<double>(pose_initial_guess * sensor_pose_in_base_link));
+			ambient_pointcloud->header.frame_id = localization.getMapFrameId();
+			typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_keypoints(new pcl::PointCloud<PointT>());
+			ambient_pointcloud_keypoints->header = ambient_pointcloud->header;
+
+			tf2::Transform pose_corrected;
+			tf2::Transform pose_corrections;
+			localization.setLocalizationTimesMsg(dynamic_robot_localization::LocalizationTimes());
+
+			performance_timer.restart();
+			bool success = localization.updateLocalizationWithAmbientPointCloud(ambient_pointcloud, pcl_conversions::fromPCL(scans[i]->header).stamp, pose_initial_guess, pose_corrected, pose_corrections, ambient_pointcloud_keypoints);
+			double global_time_ms = performance_timer.getElapsedTimeInMilliSec();
+
+			previous_ground_truth_pose = poses[i];
+			previous_estimated_pose = success ? pose_corrected : pose_initial_guess;
+			previous_pose_available = previous_pose_available || success || !initial_pose_settings.start_without_initial_pose;
+
+			if (scan_number < number_of_warmup_scans) { continue; }
+
+			++number_of_processed_scans;
+			double translation_error_mm, rotation_error_deg;
+			computePoseError(poses[i], pose_initial_guess, translation_error_mm, rotation_error_deg);
+			initial_guess_translation_errors_mm.push_back(translation_error_mm);
+			initial_guess_rotation_errors_deg.push_back(rotation_error_deg);
+			if (success) {
+				++number_of_successful_registrations;
+				computePoseError(poses[i], pose_corrected, translation_error_mm, rotation_error_deg);
+				estimated_pose_translation_errors_mm.push_back(translation_error_mm);
+				estimated_pose_rotation_errors_deg.push_back(rotation_error_deg);
+			}
+			total_processing_time_sec += global_time_ms / 1000.0;
+			global_times_ms.push_back(global_time_ms);
+
+			const dynamic_robot_localization::LocalizationTimes& localization_times = localization.getLocalizationTimesMsg();
+			for (size_t stage = 0; stage < stages.size(); ++stage) {
+				stages_times_ms[stage].push_back(localization_times.*(stages[stage].second));
+			}
+		}
+	}
+
+	if (number_of_processed_scans == 0) {
+		pcl::console::print_error(" !> No scans were processed after the warmup\n\n");
+		return (-1);
+	}
+
+	pcl::console::print_highlight("==> Processed %lu scans (%lu successful registrations) in %f seconds [%f scans / second]\n\n",
+			number_of_processed_scans, number_of_successful_registrations, total_processing_time_sec, (double)number_of_processed_scans / total_processing_time_sec);
+	pcl::console::print_highlight("==> Latencies in milliseconds:\n");
+	printStageStatistics("global", global_times_ms);
+	for (size_t stage = 0; stage < stages.size(); ++stage) {
+		printStageStatistics(stages[stage].first, stages_times_ms[stage]);
+	}
+	pcl::console::print_info("\n");
+
+	pcl::console::print_highlight("==> Pose errors in relation to the ground truth (initial guesses of all processed scans and estimated poses of the successful registrations):\n");
+	printStageStatistics("initial_guess_translation_mm", initial_guess_translation_errors_mm);
+	printStageStatistics("initial_guess_rotation_deg", initial_guess_rotation_errors_deg);
+	printStageStatistics("estimated_pose_translation_mm", estimated_pose_translation_errors_mm);
+	printStageStatistics("estimated_pose_rotation_deg", estimated_pose_rotation_errors_deg);
+	pcl::console::print_info("\n");
+
+	return 0;
+}
+
+
+// ###################################################################################   <main>   ##############################################################################
+int main(int argc, char** argv) {
+	pcl::console::print_info("###################################################################################\n");
+	pcl::console::print_info("############################## Localization benchmark #############################\n");
+	pcl::console::print_info("###################################################################################\n\n");
+
+	std::string scans_directory, poses_filename;
+	std::vector<std::string> configuration_filenames;
+	for (int i = 1; i < argc - 1; ++i) {
+		if (std::string(argv[i]) == "-config") { configuration_filenames.push_back(argv[++i]); }
+	}
+
+	if (pcl::console::parse_argument(argc, argv, "-scans", scans_directory) < 0 || pcl::console::parse_argument(argc, argv, "-poses", poses_filename) < 0 || configuration_filenames.empty()) {
+		showUsage(argv[0]);
+		return (0);
+	}
+
+	std::string reference_pointcloud_filename;
+	pcl::console::parse_argument(argc, argv, "-reference", reference_pointcloud_filename);
+
+	tf2::Transform sensor_pose_in_base_link = tf2::Transform::getIdentity();
+	std::vector<double> sensor_pose;
+	if (pcl::console::parse_x_arguments(argc, argv, "-sensor_pose", sensor_pose) > 0) {
+		if (sensor_pose.size() != 7) {
+			pcl::console::print_error(" !> The sensor pose must be given in the format: x,y,z,qx,qy,qz,qw\n\n");
+			return (-1);
+		}
+		tf2::Quaternion sensor_orientation(sensor_pose[3], sensor_pose[4], sensor_pose[5], sensor_pose[6]);
+		sensor_orientation.normalize();
+		sensor_pose_in_base_link = tf2::Transform(sensor_orientation, tf2::Vector3(sensor_pose[0], sensor_pose[1], sensor_pose[2]));
+	}
+
+	std::string type("PointNormal");
+	pcl::console::parse_argument(argc, argv, "-type", type);
+
+	int number_of_warmup_scans = 0;
+	pcl::console::parse_argument(argc, argv, "-warmup", number_of_warmup_scans);
+
+	int number_of_repetitions = 1;
+	pcl::console::parse_argument(argc, argv, "-repetitions", number_of_repetitions);
+	number_of_repetitions = std::max(number_of_repetitions, 1);
+
+	InitialPoseSettings initial_pose_settings;
+	std::vector<double> initial_pose_noise;
+	if (pcl::console::parse_x_arguments(argc, argv, "-initial_pose_noise", initial_pose_noise) > 0) {
+		if (initial_pose_noise.size() != 2) {
+			pcl::console::print_error(" !> The initial pose noise must be given in the format: translation_stddev,rotation_stddev\n\n");
+			return (-1);
+		}
+		initial_pose_settings.translation_noise_stddev = initial_pose_noise[0];
+		initial_pose_settings.rotation_noise_stddev = initial_pose_noise[1];
+	}
+	initial_pose_settings.planar_noise = pcl::console::find_switch(argc, argv, "-planar_noise");
+	initial_pose_settings.start_without_initial_pose = pcl::console::find_switch(argc, argv, "-no_initial_pose");
+	int noise_seed = 0;
+	pcl::console::parse_argument(argc, argv, "-seed", noise_seed);
+	initial_pose_settings.noise_seed = (boost::uint64_t)noise_seed;
+
+	std::vector<std::string> scans_filenames;
+	if (!loadScanFilenames(scans_directory, scans_filenames)) {
+		pcl::console::print_error(" !> No pcd files found in %s\n\n", scans_directory.c_str());
+		return (-1);
+	}
+
+	std::vector<tf2::Transform> poses;
+	if (!loadPoses(poses_filename, poses)) {
+		pcl::console::print_error(" !> Failed to load poses from %s\n\n", poses_filename.c_str());
+		return (-1);
+	}
+
+	if (poses.size() != scans_filenames.size()) {
+		pcl::console::print_error(" !> Number of poses (%lu) is different from the number of scans (%lu)\n\n", poses.size(), scans_filenames.size());
+		return (-1);
+	}
+
+	// the nodes handles used by the localization pipeline are served by an in process parameter server loaded from the yaml files, removing the need for a ROS master
+	std::string node_name("drl_localization_benchmark");
+	InProcessMaster master;
+	if (!master.start()) {
+		pcl::console::print_error(" !> Failed to start the in process parameter server\n\n");
+		return (-1);
+	}
+
+	for (size_t i = 0; i < configuration_filenames.size(); ++i) {
+		if (!loadConfigurationFromYAML(configuration_filenames[i], "/" + node_name, master)) {
+			pcl::console::print_error(" !> Failed to load configuration from %s\n\n", configuration_filenames[i].c_str());
+			return (-1);
+		}
+	}
+
+	ros::M_string remappings;
+	remappings["__master"] = master.getURI();
+	ros::init(remappings, node_name, ros::init_options::NoSigintHandler | ros::init_options::NoRosout);
+	ros::NodeHandlePtr node_handle(new ros::NodeHandle());
+	ros::NodeHandlePtr private_node_handle(new ros::NodeHandle("~"));
+	if (initial_pose_settings.start_without_initial_pose) { private_node_handle->setParam("initial_pose/robot_initial_pose_available", false); }
+
+	std::string pcl_verbosity_level;
+	private_node_handle->param("pcl_verbosity_level", pcl_verbosity_level, std::string("ERROR"));
+	dynamic_robot_localization::verbosity_levels::setVerbosityLevelPCL(pcl_verbosity_level);
+
+	std::string ros_verbosity_level;
+	private_node_handle->param("ros_verbosity_level", ros_verbosity_level, std::string("WARN"));
+	dynamic_robot_localization::verbosity_levels::setVerbosityLevelROS(ros_verbosity_level);
+
+	int result;
+	if (type == "PointXYZRGBNormal") {
+		result = runBenchmark<pcl::PointXYZRGBNormal>(node_handle, private_node_handle, scans_filenames, poses, sensor_pose_in_base_link, reference_pointcloud_filename, number_of_warmup_scans, number_of_repetitions, initial_pose_settings);
+	} else if (type == "PointXYZINormal") {
+		result = runBenchmark<pcl::PointXYZINormal>(node_handle, private_node_handle, scans_filenames, poses, sensor_pose_in_base_link, reference_pointcloud_filename, number_of_warmup_scans, number_of_repetitions, initial_pose_settings);
+	} else {
+		result = runBenchmark<pcl::PointNormal>(node_handle, private_node_handle, scans_filenames, poses, sensor_pose_in_base_link, reference_pointcloud_filename, number_of_warmup_scans, number_of_repetitions, initial_pose_settings);
+	}
+
+	node_handle.reset();
+	private_node_handle.reset();
+	ros::shutdown();
+	master.stop();
+	return result;
+}
+// ###################################################################################   </main>   #############################################################################